@@ -1,13 +1,21 @@
 #include "1300.h"
+#include "present.h"
+#include "frame_timer.h"
+#include "round_table.h"
+#include "random.h"
+#include "screen.h"
+#include "terminal_graphics.h"
+#include <cstdio>
+#include <memory>
 #include <cmath>
 #include <cstring>
 #include <unistd.h>
 
 // Paddle movement implementation 
 Paddle::Paddle(int startX, int startY, int paddleWidth) : 
-    x(static_cast<float>(startX)), y(static_cast<float>(startY)), 
+    x(startX), y(startY), 
     lastDrawnX(startX), lastDrawnY(startY),
-    directionX(0.0f), speed(0.6f), width(paddleWidth), moving(false) {}
+    directionX(0), speed(0.6f), width(paddleWidth), moving(false) {}
 
 void Paddle::update() {
     if (moving) {
@@ -15,14 +23,14 @@ void Paddle::update() {
     }
 }
 
-void Paddle::setDirection(float dx) {
+void Paddle::setDirection(Fixed dx) {
     directionX = dx;
-    if (dx != 0.0f) {
+    if (dx != 0) {
         moving = true;  // Start moving when a direction is set
     }
 }
 
-void Paddle::setSpeed(float newSpeed) {
+void Paddle::setSpeed(Fixed newSpeed) {
     speed = newSpeed;
 }
 
@@ -38,11 +46,18 @@ bool Paddle::isMoving() const {
     return moving;
 }
 
-void Paddle::setPosition(float newX, float newY) {
+void Paddle::setPosition(Fixed newX, Fixed newY) {
     x = newX;
     y = newY;
 }
 
+void Paddle::translate(int dx, int dy) {
+    x += dx;
+    y += dy;
+    lastDrawnX += dx;
+    lastDrawnY += dy;
+}
+
 // Clear the previous position
 void Paddle::clearPrevious() {
     for (int i = 0; i < width; i++) {
@@ -51,8 +66,8 @@ void Paddle::clearPrevious() {
 }
 
 void Paddle::draw() {
-    int currentX = static_cast<int>(round(x));
-    int currentY = static_cast<int>(round(y));
+    int currentX = x.cell();
+    int currentY = y.cell();
     
     // Only redraw if the position has changed
     if (currentX != lastDrawnX || currentY != lastDrawnY) {
@@ -72,14 +87,14 @@ void Paddle::draw() {
     attroff(COLOR_PAIR(1));
 }
 
-float Paddle::getX() const { return x; }
-float Paddle::getY() const { return y; }
+Fixed Paddle::getX() const { return x; }
+Fixed Paddle::getY() const { return y; }
 int Paddle::getWidth() const { return width; }
-float Paddle::getDirectionX() const { return directionX; }
-float Paddle::getSpeed() const { return speed; }
+Fixed Paddle::getDirectionX() const { return directionX; }
+Fixed Paddle::getSpeed() const { return speed; }
 
 Ball::Ball(int startX, int startY) : 
-    x(static_cast<float>(startX)), y(static_cast<float>(startY)), 
+    x(startX), y(startY), 
     lastDrawnX(startX), lastDrawnY(startY),
     directionX(0.7f), directionY(-0.7f), // Initial direction (up and to the right)
     speed(0.35f), active(true) {}  
@@ -93,27 +108,22 @@ void Ball::update() {
 }
 
 // Set a new direction vector
-void Ball::setDirection(float dx, float dy) {
-    directionX = dx;
-    directionY = dy;
-    
+void Ball::setDirection(Fixed dx, Fixed dy) {
     // Normalize the direction vector
-    float length = sqrt(dx * dx + dy * dy);
-    if (length > 0) { // Avoid division by zero
-        directionX /= length;
-        directionY /= length;
-    }
+    FixedVec2 direction = FixedVec2(dx, dy).normalized();
+    directionX = direction.x;
+    directionY = direction.y;
 }
 
 void Ball::reverseX() {
-    directionX = -directionX * 0.95f;;
+    directionX = -directionX * Fixed(0.95f);;
 }
 
 void Ball::reverseY() {
-    directionY = -directionY * 0.95f;;
+    directionY = -directionY * Fixed(0.95f);;
 }
 
-void Ball::setSpeed(float newSpeed) {
+void Ball::setSpeed(Fixed newSpeed) {
     speed = newSpeed;
 }
 
@@ -125,19 +135,26 @@ bool Ball::isActive() const {
     return active;
 }
 
-void Ball::setPosition(float newX, float newY) {
+void Ball::setPosition(Fixed newX, Fixed newY) {
     x = newX;
     y = newY;
 }
 
+void Ball::translate(int dx, int dy) {
+    x += dx;
+    y += dy;
+    lastDrawnX += dx;
+    lastDrawnY += dy;
+}
+
 // Clear the previous position
 void Ball::clearPrevious() {
     mvaddch(lastDrawnY, lastDrawnX, ' ');
 }
 
 void Ball::draw() {
-    int currentX = static_cast<int>(round(x));
-    int currentY = static_cast<int>(round(y));
+    int currentX = x.cell();
+    int currentY = y.cell();
     
     // Only redraw if position has changed
     if (currentX != lastDrawnX || currentY != lastDrawnY) {
@@ -155,105 +172,23 @@ void Ball::draw() {
     attroff(COLOR_PAIR(2));
 }
 
-float Ball::getX() const { return x; }
-float Ball::getY() const { return y; }
-float Ball::getDirectionX() const { return directionX; }
-float Ball::getDirectionY() const { return directionY; }
-float Ball::getSpeed() const { return speed; }
-
-Block::Block(int startX, int startY, int w, int h, int color) : 
-    x(startX), y(startY), width(w), height(h), active(true), colorPair(color) {}
-
-void Block::draw() {
-    if (!active) return;
-    
-    attron(COLOR_PAIR(colorPair));
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            mvaddch(y + row, x + col, ACS_CKBOARD);
-        }
-    }
-    attroff(COLOR_PAIR(colorPair));
-}
-
-// Clear the block from the screen
-void Block::clear() {
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            mvaddch(y + row, x + col, ' ');
-        }
-    }
-}
-
-bool Block::collidesWith(const Ball& ball) {
-    if (!active) return false;
-    
-    float ballX = ball.getX();
-    float ballY = ball.getY();
-    
-    return (ballX >= x && ballX < x + width &&
-            ballY >= y && ballY < y + height);
-}
-
-void Block::setActive(bool isActive) {
-    if (active && !isActive) {
-        // If being deactivated, clear from screen
-        clear();
-    }
-    active = isActive;
-}
-
-bool Block::isActive() const {
-    return active;
-}
-
-int Block::getX() const { return x; }
-int Block::getY() const { return y; }
-int Block::getWidth() const { return width; }
-int Block::getHeight() const { return height; }
-
-BattleBox::BattleBox(int startX, int startY, int w, int h) :
-    x(startX), y(startY), width(w), height(h), needsRedraw(true), needsRefresh(false) {}
-
-void BattleBox::draw() {
-    if (!needsRedraw) return;
-    
-    // Enable reverse highlighting
-    attron(A_REVERSE);
-
-    // Draw the top and bottom borders of the battle box
-    for (int i = -1; i <= width+1; i++) {
-        mvaddch(y, x + i, ' ');              // Top border (space with reverse highlight)
-        mvaddch(y + height, x + i, ' ');     // Bottom border
-    }
-
-    // Draw the left and right borders of the battle box
-    for (int i = 0; i <= height; i++) {
-        mvaddch(y + i, x, ' ');              // Left border
-        mvaddch(y + i, x + width, ' ');      // Right border
-        mvaddch(y + i, x-1, ' ');            // Left border
-        mvaddch(y + i, x+1 + width, ' ');    // Right border
-    }
-
-    // Disable reverse highlighting
-    attroff(A_REVERSE);
-    
-    needsRedraw = false;
-}
+Fixed Ball::getX() const { return x; }
+Fixed Ball::getY() const { return y; }
+Fixed Ball::getDirectionX() const { return directionX; }
+Fixed Ball::getDirectionY() const { return directionY; }
+Fixed Ball::getSpeed() const { return speed; }
 
-void BattleBox::setNeedsRedraw() {
-    needsRedraw = true;
-}
-
-int BattleBox::getX() const { return x; }
-int BattleBox::getY() const { return y; }
-int BattleBox::getWidth() const { return width; }
-int BattleBox::getHeight() const { return height; }
+// Blocks sit still, four cells wide; each is given its row's colour when
+// it is placed
+const EntityKind BLOCK_KIND = {
+    POSITION | GLYPH | EXTENT, ACS_CKBOARD, 0, { 0, 0, 1 }, 0, 0, { 4, 1 }
+};
 
 GameManager::GameManager(int screenWidth, int screenHeight) : 
     battleBox(screenWidth/2 - 20,screenHeight/2 - 15, 40, 30),
     paddle(screenWidth/2 - 3,screenHeight/2 + 14),
     ball(screenWidth/2,screenHeight/2 + 13),
+    blocks(BLOCK_KIND),
     blockCount(0),
     gameOver(false),
     gameWon(false),
@@ -270,8 +205,8 @@ void GameManager::initializeBlocks(bool fullDensity) {
     blockCount = 0;
     
     // Calculate the number of blocks that fit in the battle box
-    int blockWidth = 4;
-    int blockHeight = 1;
+    int blockWidth = BLOCK_KIND.extent.width;
+    int blockHeight = BLOCK_KIND.extent.height;
     int padding = 1; // Space between blocks
     
     int boxWidth = battleBox.getWidth();
@@ -280,6 +215,7 @@ void GameManager::initializeBlocks(bool fullDensity) {
     
     int blocksPerRow = (boxWidth / (blockWidth + padding))-1;
     int maxRows = 5; 
+    blocks.reserve(maxRows * blocksPerRow);
     
     // Create the blocks
     for (int row = 0; row < maxRows; row++) {
@@ -295,12 +231,18 @@ void GameManager::initializeBlocks(bool fullDensity) {
             // Use different colors for different rows
             int blockColor = 3 + (row % 5);
             
-            blocks.push_back(Block(blockX, blockY, blockWidth, blockHeight, blockColor));
+            int block = blocks.spawn(blockX, blockY);
+            blocks.glyph[block].look = ACS_CKBOARD | COLOR_PAIR(blockColor);
             blockCount++;
         }
     }
 }
 
+// Uniform in [low, high] at full fixed-point resolution
+static Fixed randomFixed(RandomGenerator& random, Fixed low, Fixed high) {
+    return Fixed::fromRaw(random.nextInt(low.raw(), high.raw()));
+}
+
 void GameManager::setLives(int newLives) {
     lives = newLives;
 }
@@ -344,16 +286,7 @@ void GameManager::reset(bool fullDensity, int startLives) {
     ball.setPosition(maxX/2, maxY/2 + 13);
     
     // Set ball direction
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
-    std::uniform_real_distribution<float> distX(-0.7f, 0.7f);
-    float dirX = distX(gen);
-    
-    std::uniform_real_distribution<float> distY(-1.0f, -0.7f);
-    float dirY = distY(gen);
-    
-    ball.setDirection(dirX, dirY);
+    ball.setDirection(randomFixed(random, Fixed(-0.7f), Fixed(0.7f)), randomFixed(random, -1, Fixed(-0.7f)));
     
     // Reinitialize blocks with specified density
     initializeBlocks(fullDensity);
@@ -373,21 +306,42 @@ void GameManager::resetBall() {
     ball.setPosition(maxX/2, maxY/2 + 13);
     
     // Set ball direction (mostly upward)
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
-    std::uniform_real_distribution<float> distX(-0.7f, 0.7f);
-    float dirX = distX(gen);
-    
-    std::uniform_real_distribution<float> distY(-1.0f, -0.7f);
-    float dirY = distY(gen);
-    
-    ball.setDirection(dirX, dirY);
+    ball.setDirection(randomFixed(random, Fixed(-0.7f), Fixed(0.7f)), randomFixed(random, -1, Fixed(-0.7f)));
     
     // Force battleBox redraw when ball is reset
     battleBox.setNeedsRedraw();
 }
 
+// Follow a terminal resize: re-centre the battle box, shift the paddle, ball
+// and blocks by the same amount and clear the screen so the next draw()
+// repaints everything once
+void GameManager::relayout(int screenWidth, int screenHeight) {
+    int dx = screenWidth/2 - 20 - battleBox.getX();
+    int dy = screenHeight/2 - 15 - battleBox.getY();
+
+    battleBox.moveTo(battleBox.getX() + dx, battleBox.getY() + dy);
+    paddle.translate(dx, dy);
+    ball.translate(dx, dy);
+    blocks.translate(dx, dy);
+    clear();
+    status.invalidate();
+}
+
+void GameManager::save(SnapshotBuffer& out) const {
+    out.put(battleBox, paddle, ball);
+    blocks.save(out);
+    out.put(blockCount, gameOver, gameWon, lives, ballLost, random);
+}
+
+// Back to a saved state, then laid out for the current terminal size
+void GameManager::restore(SnapshotBuffer& in, int screenWidth, int screenHeight) {
+    in.get(battleBox, paddle, ball);
+    blocks.restore(in);
+    in.get(blockCount, gameOver, gameWon, lives, ballLost, random);
+    relayout(screenWidth, screenHeight);
+    battleBox.setNeedsRedraw();
+}
+
 void GameManager::update() {
     if (gameOver || gameWon || ballLost) return;
     
@@ -395,21 +349,21 @@ void GameManager::update() {
     paddle.update();
     
     // Constrain paddle position to stay within battle box
-    float paddleX = paddle.getX();
-    float paddleY = paddle.getY();
+    Fixed paddleX = paddle.getX();
+    Fixed paddleY = paddle.getY();
     
     if (paddleX < battleBox.getX() + 1) {
-        paddle.setPosition(static_cast<float>(battleBox.getX() + 1), paddleY);
+        paddle.setPosition(battleBox.getX() + 1, paddleY);
     } else if (paddleX + paddle.getWidth() > battleBox.getX() + battleBox.getWidth()) {
-        paddle.setPosition(static_cast<float>(battleBox.getX() + battleBox.getWidth() - paddle.getWidth()), paddleY);
+        paddle.setPosition(battleBox.getX() + battleBox.getWidth() - paddle.getWidth(), paddleY);
     }
     
     // Update ball position
     ball.update();
     
     // Ball collision with walls
-    float ballX = ball.getX();
-    float ballY = ball.getY();
+    Fixed ballX = ball.getX();
+    Fixed ballY = ball.getY();
     
     // Left and right walls
     if (ballX <= battleBox.getX() + 1 || ballX >= battleBox.getX() + battleBox.getWidth() - 1) {
@@ -417,9 +371,9 @@ void GameManager::update() {
         
         // Fix the position to prevent the ball from getting stuck in the wall
         if (ballX <= battleBox.getX() + 1) {
-            ball.setPosition(battleBox.getX() + 1.1f, ball.getY());
+            ball.setPosition(Fixed(battleBox.getX()) + Fixed(1.1f), ball.getY());
         } else if (ballX >= battleBox.getX() + battleBox.getWidth() - 1) {
-            ball.setPosition(battleBox.getX() + battleBox.getWidth() - 1.1f, ball.getY());
+            ball.setPosition(Fixed(battleBox.getX() + battleBox.getWidth()) - Fixed(1.1f), ball.getY());
         }
         
         // Force battle box redraw to fix the dent
@@ -431,7 +385,7 @@ void GameManager::update() {
         ball.reverseY();
         
         // Fix the position to prevent the ball from getting stuck in the wall
-        ball.setPosition(ball.getX(), battleBox.getY() + 1.1f);
+        ball.setPosition(ball.getX(), Fixed(battleBox.getY()) + Fixed(1.1f));
         
         // Force battle box redraw to fix the dent
         battleBox.setNeedsRedraw();
@@ -451,48 +405,45 @@ void GameManager::update() {
         ball.reverseY();
         
         // Change ball's horizontal direction based on where it hit the paddle
-        float hitPosition = (ballX - paddleX) / paddle.getWidth(); // 0.0 to 1.0
-        float newDirX = 2.0f * (hitPosition - 0.5f); // -1.0 to 1.0
-        newDirX = std::max(-0.8f, std::min(0.8f, newDirX));
+        Fixed hitPosition = (ballX - paddleX) / paddle.getWidth(); // 0.0 to 1.0
+        Fixed newDirX = 2 * (hitPosition - Fixed(0.5f)); // -1.0 to 1.0
+        newDirX = max(Fixed(-0.8f), min(Fixed(0.8f), newDirX));
         
         // Add a small influence from the paddle's movement for more realistic physics
         if (paddle.isMoving()) {
-            newDirX += 0.2f * paddle.getDirectionX();
-            newDirX = std::max(-0.8f, std::min(0.8f, newDirX));
+            newDirX += Fixed(0.2f) * paddle.getDirectionX();
+            newDirX = max(Fixed(-0.8f), min(Fixed(0.8f), newDirX));
         }
         
         // Set new direction, keeping the y-direction properly negative (upward)
-        float newDirY = -0.7f; // Consistent upward direction
+        Fixed newDirY(-0.7f); // Consistent upward direction
         
         ball.setDirection(newDirX, newDirY);
     }
     
-    // Ball collision with blocks
-    for (auto& block : blocks) {
-        if (block.isActive() && block.collidesWith(ball)) {
-            // Block hit - deactivate it
-            block.setActive(false);
-            blockCount--;
-            
-            // Bounce the ball
-            float ballDirX = ball.getDirectionX();
-            float ballDirY = ball.getDirectionY();
-            
-            // reverse direction based on ball's movement direction
-            if (abs(ballDirX) > abs(ballDirY)) {
-                ball.reverseX(); 
-            } else {
-                ball.reverseY(); 
-            }
-            
-            // Check if all blocks are destroyed (win condition)
-            if (blockCount <= 0) {
-                gameWon = true;
-                return;  // exit immediately when game is won
-            }
-            
-            // Only handle one collision per update
-            break;
+    // Ball collision with blocks: the one covering the cell the ball is in
+    int block = blocks.findAt(ball.getX().floor(), ball.getY().floor());
+    if (block >= 0) {
+        // Block hit - remove it from the pool and the screen
+        blocks.kill(block);
+        blocks.compact();
+        blockCount--;
+        
+        // Bounce the ball
+        Fixed ballDirX = ball.getDirectionX();
+        Fixed ballDirY = ball.getDirectionY();
+        
+        // reverse direction based on ball's movement direction
+        if (abs(ballDirX) > abs(ballDirY)) {
+            ball.reverseX(); 
+        } else {
+            ball.reverseY(); 
+        }
+        
+        // Check if all blocks are destroyed (win condition)
+        if (blockCount <= 0) {
+            gameWon = true;
+            return;  // exit immediately when game is won
         }
     }
     
@@ -503,36 +454,69 @@ void GameManager::update() {
     }
 }
 
+// Same world as draw(), with the paddle and ball at their sub-cell positions
+void GameManager::rasterise(PixelCanvas& canvas) const {
+    int cellWidth = canvas.getCellWidth();
+    int cellHeight = canvas.getCellHeight();
+    int left = battleBox.getInnerMinX();
+    int top = battleBox.getInnerMinY();
+
+    canvas.clear(colourPixel(COLOR_BLACK));
+    for (int i = 0; i < blocks.size(); i++) {
+        if (!blocks.isAlive(i)) continue;
+        const Position& block = blocks.position[i];
+        const Extent& size = blocks.extent[i];
+        // A pixel of gap around each brick, as the checkerboard glyphs
+        // leave, when cells are big enough to spare it
+        int gap = cellWidth > 2 ? 1 : 0;
+        canvas.fillRect((block.cellX - left) * cellWidth + gap, (block.cellY - top) * cellHeight + gap,
+                        size.width * cellWidth - 2 * gap, size.height * cellHeight - 2 * gap,
+                        pairPixel(blocks.glyph[i].look & A_COLOR));
+    }
+
+    // The paddle's x is its left cell
+    int paddleX = canvas.pixelX(paddle.getX() - left) - cellWidth / 2;
+    int paddleY = canvas.pixelY(paddle.getY() - top);
+    canvas.fillRect(paddleX, paddleY - cellHeight / 4, paddle.getWidth() * cellWidth, cellHeight / 2,
+                    pairPixel(COLOR_PAIR(1)));
+
+    int ballX = canvas.pixelX(ball.getX() - left);
+    int ballY = canvas.pixelY(ball.getY() - top);
+    canvas.fillDisc(ballX, ballY, cellWidth / 2, pairPixel(COLOR_PAIR(2)));
+}
+
+const BattleBox& GameManager::getBattleBox() const {
+    return battleBox;
+}
+
 void GameManager::draw() {
     battleBox.draw();
     
     // Draw blocks
-    for (auto& block : blocks) {
-        block.draw();
-    }
+    drawSystem(blocks);
     
     // Draw the paddle and ball
     paddle.draw();
     ball.draw();
     
-    // Get terminal dimensions
-    int maxY, maxX;
-    getmaxyx(stdscr, maxY, maxX);
+    // Get terminal width
+    int maxX = getmaxx(stdscr);
     
-    // Display lives count 
-    mvprintw(maxY - 40, maxX / 2 -17, "Blocks remaining: %02d     Lives: %02d", blockCount, lives); 
-
     // Calculate position for status text 
     int statusY = battleBox.getY() - 2; 
     
-    // Clear the status area first to prevent text overlap
-    for (int i = 0; i < 1; i++) {
-        mvprintw(statusY + i, maxX / 2 - 20, "                                                  ");
-    }
-    
-    // Display lives count and blocks remaining with proper spacing
-    mvprintw(statusY, maxX / 2 - 17, "Blocks remaining: %d     Lives: %d", blockCount, lives);
-    
+    // Display lives count and blocks remaining with proper spacing; the
+    // widget blanks what a longer count left behind
+    status.show(maxX / 2 - 17, statusY, 0, "Blocks remaining: %d     Lives: %d", blockCount, lives);
+
+    drawMessage();
+}
+
+// Game over, win and ball lost messages, in the middle of the box
+void GameManager::drawMessage() {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+
     if (gameOver) {
         attron(COLOR_PAIR(1)); // Red for game over
         mvprintw(maxY / 2, maxX / 2 - 4.5, "GAME OVER");
@@ -571,10 +555,10 @@ void GameManager::handleInput(int key) {
     }
     
     if (key == KEY_LEFT) {
-        paddle.setDirection(-1.0f);
+        paddle.setDirection(-1);
         paddle.start();
     } else if (key == KEY_RIGHT) {
-        paddle.setDirection(1.0f);
+        paddle.setDirection(1);
         paddle.start();
     } else if (key == '\n') {
         paddle.stop();
@@ -602,6 +586,17 @@ void GameManager::paddleStop() {
 }
 
 // Function to run a single round of the game
+// Block density and lives of each round, edited in 1300_rounds.txt
+static RoundTable roundTable;
+
+bool loadRoundTable() {
+    if (roundTable.load("1300_rounds.bin", "1300_rounds.txt", {
+            { "full_blocks", 0, 1 },
+            { "lives", 1, 99 } })) return true;
+    std::fprintf(stderr, "%s\n", roundTable.error().c_str());
+    return false;
+}
+
 int runRound(int round) {
     // Get terminal dimensions
     int maxY, maxX;
@@ -610,45 +605,53 @@ int runRound(int round) {
     // Create game manager for this round
     GameManager game(maxX, maxY);
     
-    // Configure game based on round
-    switch (round) {
-        case 1:
-            // Round 1: Half blocks, 3 tries
-            game.reset(false, 5);  // false = half density, 3 lives
-            game.draw();
-            mvprintw(maxY / 2, maxX / 2 - 14, "Round 1: Half blocks, 5 tries");
-            break;
-        case 2:
-            // Round 2: Normal blocks, 3 tries
-            game.reset(true, 5);   // true = full density, 3 lives
-            game.draw();
-            mvprintw(maxY / 2, maxX / 2 - 14, "Round 2: Full blocks, 5 tries");
-            break;
-        case 3:
-            // Round 3: Normal blocks, 1 try
-            game.reset(true, 3);   // true = full density, 1 life
+    // Configure game based on round, from 1300_rounds.txt
+    if (round < 1 || round > roundTable.rowCount()) {
+        // Invalid round
+        return -1;
+    }
+    bool fullBlocks = roundTable.getInt(round, "full_blocks") != 0;
+    int lives = roundTable.getInt(round, "lives");
+    game.reset(fullBlocks, lives);
+    
+    // Non-blocking input for the round, but blocking to wait for a key
+    // press first, laying the round out again if the terminal is resized in
+    // the meantime
+    InputMode playing(InputMode::NON_BLOCKING);
+    {
+        InputMode waiting(InputMode::BLOCKING);
+        int key;
+        do {
+            getmaxyx(stdscr, maxY, maxX);
+            game.relayout(maxX, maxY);
             game.draw();
-            mvprintw(maxY / 2, maxX / 2 - 14, "Round 3: Full blocks, 3 try");
-            break;
-        default:
-            // Invalid round
-            return -1;
+            mvprintw(maxY / 2, maxX / 2 - 14, "Round %d: %s blocks, %d tries",
+                     round, fullBlocks ? "Full" : "Half", lives);
+            
+            // Add instructions for the user
+            mvprintw((maxY / 2) + 1, maxX / 2 - 17, "Press any key to start the round...");
+            presentFrame();
+            key = getch();
+        } while (key == KEY_RESIZE);
     }
-    
-    // Add instructions for the user
-    mvprintw((maxY / 2) + 1, maxX / 2 - 17, "Press any key to start the round...");
-    refresh();
-    
-    // Temporarily enable blocking input to wait for a key press
-    nodelay(stdscr, FALSE);
-    getch();
-    nodelay(stdscr, TRUE);  // Return to non-blocking input for the game
     // Clear center area of the screen 
     for (int i = 0; i < 2; i++) {
         mvprintw(maxY / 2 + i, maxX / 2 - 19, "                                       ");
     }
     // Game loop for this round
     bool running = true;
+    FrameTimer frameTimer;
+    SnapshotRing history;
+
+    // With YEAR1_GRAPHICS the inside of the box is also drawn in pixels:
+    // as half blocks in place of the glyphs, or as an image laid over them
+    // while the round is being played
+    GraphicsPresenter graphics(graphicsMode());
+    std::unique_ptr<PixelCanvas> canvas;
+    if (graphicsMode() != GRAPHICS_OFF) {
+        const BattleBox& box = game.getBattleBox();
+        canvas.reset(newBoxCanvas(graphicsMode(), box.getWidth() - 1, box.getHeight() - 1));
+    }
     
     while (running) {
         // Processing all available input
@@ -663,6 +666,14 @@ int runRound(int round) {
                 } else {
                     game.paddleStart();
                 }
+            } else if (ch == KEY_RESIZE) {
+                getmaxyx(stdscr, maxY, maxX);
+                game.relayout(maxX, maxY);
+            } else if (rewindEnabled() && isRewindKey(ch)) {
+                if (SnapshotBuffer* snapshot = history.rewind()) {
+                    getmaxyx(stdscr, maxY, maxX);
+                    game.restore(*snapshot, maxX, maxY);
+                }
             } else if (ch == '\n' && (game.isGameOver() || game.isGameWon())) {
                 // Handle ENTER key for game over or win
                 if (game.isGameWon()) {
@@ -677,13 +688,28 @@ int runRound(int round) {
         
         // Update game
         game.update();
+        if (rewindEnabled()) {
+            if (SnapshotBuffer* snapshot = history.capture()) game.save(*snapshot);
+        }
         
         // Draw game
         game.draw();
+        const BattleBox& box = game.getBattleBox();
+        if (canvas) game.rasterise(*canvas);
+        if (canvas && graphicsMode() == GRAPHICS_HALF_BLOCK) {
+            drawHalfBlocks(*canvas, box.getInnerMinX(), box.getInnerMinY());
+            game.drawMessage();  // Over the half blocks
+        }
 
         // Refresh screen and control frame rate
-        refresh();
-        usleep(16667);  // ~60  FPS
+        presentFrame();
+        if (canvas && !game.isGameOver() && !game.isGameWon() && !game.isBallLost()) {
+            graphics.present(*canvas, box.getInnerMinX(), box.getInnerMinY());
+        } else {
+            // Messages are printed inside the box, under where the image goes
+            graphics.hide();
+        }
+        frameTimer.wait();  // 60 FPS
     }
 
     return -1;  // Default to failure if we exit the loop unexpectedly
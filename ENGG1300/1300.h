@@ -4,97 +4,67 @@
 #include <ncursesw/ncurses.h>
 #include <vector>
 #include <random>
+#include "hud.h"
+#include "fixed_point.h"
+#include "snapshot_ring.h"
+#include "random.h"
+#include "entity_store.h"
+#include "pixel_canvas.h"
 
 class Paddle {
 private:
-    float x, y;           // Position coordinates
+    Fixed x, y;           // Position coordinates
     int lastDrawnX, lastDrawnY; // Last position where paddle was drawn
-    float directionX;     // Direction vector
-    float speed;          // Movement speed
+    Fixed directionX;     // Direction vector
+    Fixed speed;          // Movement speed
     int width;            // Paddle width
     bool moving;          // Whether the paddle is moving
 
 public:
     Paddle(int startX, int startY, int paddleWidth = 7);
     void update();
-    void setDirection(float dx);
-    void setSpeed(float newSpeed);
+    void setDirection(Fixed dx);
+    void setSpeed(Fixed newSpeed);
     void stop();
     void start();
     bool isMoving() const;
-    void setPosition(float newX, float newY);
+    void setPosition(Fixed newX, Fixed newY);
+    void translate(int dx, int dy);  // Shift by whole cells when the layout moves
     void clearPrevious();
     void draw();
-    float getX() const;
-    float getY() const;
+    Fixed getX() const;
+    Fixed getY() const;
     int getWidth() const;
-    float getDirectionX() const;
-    float getSpeed() const;
+    Fixed getDirectionX() const;
+    Fixed getSpeed() const;
 };
 
 class Ball {
 private:
-    float x, y;           // Position coordinates
+    Fixed x, y;           // Position coordinates
     int lastDrawnX, lastDrawnY; // Last position where the ball was drawn
-    float directionX, directionY; // Direction vector
-    float speed;          // Movement speed
+    Fixed directionX, directionY; // Direction vector
+    Fixed speed;          // Movement speed
     bool active;          // Whether the ball is moving
 
 public:
     Ball(int startX, int startY);
     void update();
-    void setDirection(float dx, float dy);
+    void setDirection(Fixed dx, Fixed dy);
     void reverseX();
     void reverseY();
-    void setSpeed(float newSpeed);
+    void setSpeed(Fixed newSpeed);
     void setActive(bool isActive);
     bool isActive() const;
-    void setPosition(float newX, float newY);
+    void setPosition(Fixed newX, Fixed newY);
+    void translate(int dx, int dy);
     void clearPrevious();
     void draw();
-    float getX() const;
-    float getY() const;
-    float getDirectionX() const;
-    float getDirectionY() const;
-    float getSpeed() const;
-};
-
-class Block {
-private:
-    int x, y;             // Position coordinates
-    int width, height;    // Demensions of the block
-    bool active;          // Whether the block is still there or destroyed
-    int colorPair;        // Color pair to use for the block
-
-public:
-    Block(int startX, int startY, int w = 4, int h = 1, int color = 3);
-    void draw();
-    void clear();
-    bool collidesWith(const Ball& ball);
-    void setActive(bool isActive);
-    bool isActive() const;
-    int getX() const;
-    int getY() const;
-    int getWidth() const;
-    int getHeight() const;
-};
-
-class BattleBox {
-private:
-    int x, y;         // Top-left corner position
-    int width, height; // Box dimensions
-    bool needsRedraw;  // Flag to determine if the box needs redrawing
-    bool needsRefresh; // Flag to determine if the box needs refreshing
-
-public:
-    BattleBox(int startX, int startY, int w, int h);
-    BattleBox() : x(0), y(0), width(0), height(0), needsRedraw(false), needsRefresh(false) {}
-    void draw();
-    void setNeedsRedraw();
-    int getX() const;
-    int getY() const;
-    int getWidth() const;
-    int getHeight() const;
+    Fixed getX() const;
+    Fixed getY() const;
+    Fixed getDirectionX() const;
+    Fixed getDirectionY() const;
+    Fixed getSpeed() const;
 };
 
 // Game Manager class to handle game state
@@ -103,12 +73,14 @@ private:
     BattleBox battleBox;
     Paddle paddle;
     Ball ball;
-    std::vector<Block> blocks;
+    EntityPool blocks;    // One entity per block, coloured by its row
     int blockCount;
     bool gameOver;
     bool gameWon;
     int lives;  // Add lives counter
     bool ballLost; // Flag for when a ball is lost but game isn't over
+    RandomGenerator random; // Ball directions, saved with the round
+    HudText status; // Blocks and lives above the box, redrawn when they change
     
 public:
     GameManager(int screenWidth, int screenHeight);
@@ -120,8 +92,16 @@ public:
     bool isBallLost() const;
     void resetBall();
     void reset(bool fullDensity = true, int startLives = 3);
+    void relayout(int screenWidth, int screenHeight);
+    // Rewind support: the whole round, random generator included
+    void save(SnapshotBuffer& out) const;
+    void restore(SnapshotBuffer& in, int screenWidth, int screenHeight);
     void update();
     void draw();
+    void drawMessage();
+    // The inside of the battle box in pixels for YEAR1_GRAPHICS terminals
+    void rasterise(PixelCanvas& canvas) const;
+    const BattleBox& getBattleBox() const;
     void handleInput(int key);
     bool isGameOver() const;
     bool isGameWon() const;
@@ -130,6 +110,10 @@ public:
     void paddleStop();
 };
 
+// Loads 1300_rounds.bin (rebuilding it from the text if needed); prints the
+// problem and returns false on failure
+bool loadRoundTable();
+
 // Function to run a single round of the game
 int runRound(int round);
 
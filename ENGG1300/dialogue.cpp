@@ -0,0 +1,90 @@
+#include "dialogue.h"
+#include "present.h"
+#include <string>
+
+void showGameIntroduction() {
+    clear();
+    
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 100, true);
+    animator.loadDialogues("1300_dialogue.txt");
+    
+    // Introduction sequence - first 8 dialogues are intro
+    for (int i = 0; i < 8; i++) {
+        clear();
+        animator.showDialogue(i);
+    }
+    clear();
+    maxY++;
+    maxY--;
+}
+
+void showRoundInfo(int round) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    animator.loadDialogues("1300_dialogue.txt");
+    
+    // Dialogues 8, 9, 10 are for rounds 1, 2, 3
+    animator.showDialogue(7 + round);
+    maxY++;
+    maxY--;
+}
+
+void showRoundComplete(int round, int score) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    animator.loadDialogues("1300_dialogue.txt");
+    
+    // Get round completion dialogue and replace score placeholder
+    std::string text = animator.getDialogue(10 + round);
+    size_t pos = text.find("SCORE");
+    if (pos != std::string::npos) {
+        text.replace(pos, 5, std::to_string(score));
+    }
+    
+    animator.animateText(text);
+    maxY++;
+    maxY--;
+}
+
+void gameOver(bool won, int finalRound, int score) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    animator.loadDialogues("1300_dialogue.txt");
+    
+    if (won) {
+        // Get victory dialogue and replace score
+        std::string text = animator.getDialogue(14);
+        size_t pos = text.find("SCORE");
+        if (pos != std::string::npos) {
+            text.replace(pos, 5, std::to_string(score));
+        }
+        animator.animateText(text);
+    } else {
+        // Get game over dialogue and replace round/score
+        std::string text = animator.getDialogue(15);
+        size_t pos = text.find("ROUND");
+        if (pos != std::string::npos) {
+            text.replace(pos, 5, std::to_string(finalRound));
+        }
+        pos = text.find("SCORE");
+        if (pos != std::string::npos) {
+            text.replace(pos, 5, std::to_string(score));
+        }
+        animator.animateText(text);
+        maxY++;
+        maxY--;
+    }
+}
\ No newline at end of file
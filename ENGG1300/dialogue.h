@@ -0,0 +1,15 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+// ENGG1300 intro, round and ending dialogue. The dialogue box itself is the
+// engine's TextAnimator.
+
+#include "text_animator.h"
+
+// Additional utility functions
+void showGameIntroduction();
+void showRoundInfo(int round);
+void showRoundComplete(int round, int score);
+void gameOver(bool won, int finalRound, int score);
+
+#endif // DIALOGUE_H
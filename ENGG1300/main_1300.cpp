@@ -1,27 +1,28 @@
 #include "1300.h"
-#include "text_animator.h"
+#include "dialogue.h"
+#include "screen.h"
+#include "random.h"
+#include "stage_result.h"
 #include <ncursesw/ncurses.h>
 
 int main() {
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    nodelay(stdscr, TRUE);  // Non-blocking input
-    
-    // Set up colors if terminal supports them
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);    // Paddle color
-        init_pair(2, COLOR_CYAN, COLOR_BLACK);   // Ball color
-        init_pair(3, COLOR_GREEN, COLOR_BLACK);  // Block color 1
-        init_pair(4, COLOR_YELLOW, COLOR_BLACK); // Block color 2
-        init_pair(5, COLOR_MAGENTA, COLOR_BLACK);// Block color 3
-        init_pair(6, COLOR_BLUE, COLOR_BLACK);   // Block color 4
-        init_pair(7, COLOR_WHITE, COLOR_BLACK);  // Block color 5
+    if (!loadRoundTable()) {
+        return 1;
     }
+    seedRandom();
+
+    // Initialize ncurses once with non-blocking input, and colors for the
+    // whole game if the terminal supports them
+    initScreen(true);
+    PaletteScope palette({
+        {1, COLOR_RED, COLOR_BLACK},    // Paddle color
+        {2, COLOR_CYAN, COLOR_BLACK},   // Ball color
+        {3, COLOR_GREEN, COLOR_BLACK},  // Block color 1
+        {4, COLOR_YELLOW, COLOR_BLACK}, // Block color 2
+        {5, COLOR_MAGENTA, COLOR_BLACK},// Block color 3
+        {6, COLOR_BLUE, COLOR_BLACK},   // Block color 4
+        {7, COLOR_WHITE, COLOR_BLACK},  // Block color 5
+    });
 
     // Show game introduction
     showGameIntroduction();
@@ -36,30 +37,35 @@ int main() {
         totalScore += 100;
         showRoundComplete(1, totalScore);
         
-        clear();
+        erase();
         showRoundInfo(2);
         int result2 = runRound(2);
         if (result2 > 0) {
             totalScore += 200;
             showRoundComplete(2, totalScore);
             
-            clear();
+            erase();
             showRoundInfo(3);
             int result3 = runRound(3);
             if (result3 > 0) {
                 totalScore += 300;
-                // Player completed all rounds
+                // Player completed all rounds. Lives are not HP, so no HP
+                // is reported
+                reportStageOutcome(true, 3, -1, totalScore);
                 gameOver(true, 3, totalScore);
             } else {
                 // Failed on round 3
+                reportStageOutcome(false, 3, -1, totalScore);
                 gameOver(false, 3, totalScore);
             }
         } else {
             // Failed on round 2
+            reportStageOutcome(false, 2, -1, totalScore);
             gameOver(false, 2, totalScore);
         }
     } else {
         // Failed on round 1
+        reportStageOutcome(false, 1, -1, totalScore);
         gameOver(false, 1, totalScore);
     }
 
@@ -1,16 +1,23 @@
 #include "1310.h"
-#include "text_animator.h"
+#include "dialogue.h"
+#include "present.h"
+#include "frame_timer.h"
+#include "round_table.h"
+#include "screen.h"
+#include "stage_result.h"
+#include "snapshot_ring.h"
 #include <cmath>
 #include <ctime>
 #include <unistd.h>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdio>
 
 Heart::Heart(int startX, int startY) : 
-    x(static_cast<float>(startX)), y(static_cast<float>(startY)), 
+    x(startX), y(startY), 
     lastDrawnX(startX), lastDrawnY(startY),
-    directionX(0.0f), directionY(0.0f),
-    baseSpeed(0.3f), aspectRatio(2.0f), // Assume character cells are about half as wide as they are tall
+    directionX(0), directionY(0),
+    baseSpeed(0.3f), aspectRatio(2), // Assume character cells are about half as wide as they are tall
     moving(false), symbol(ACS_DIAMOND) {}
 
 void Heart::update() {
@@ -23,22 +30,22 @@ void Heart::update() {
     }
 }
 
-void Heart::setDirection(float dx, float dy) {
+void Heart::setDirection(Fixed dx, Fixed dy) {
     // Set a new direction vector
-    if (dx != 0.0f || dy != 0.0f) {
+    if (dx != 0 || dy != 0) {
         // Normalize the direction vector
-        float length = sqrt(dx * dx + dy * dy);
-        directionX = dx / length;
-        directionY = dy / length;
+        FixedVec2 direction = FixedVec2(dx, dy).normalized();
+        directionX = direction.x;
+        directionY = direction.y;
         moving = true;  // Start moving when a direction is set
     }
 }
 
-void Heart::setAspectRatio(float ratio) {
+void Heart::setAspectRatio(Fixed ratio) {
     aspectRatio = ratio;
 }
 
-void Heart::setSpeed(float speed) {
+void Heart::setSpeed(Fixed speed) {
     baseSpeed = speed;
 }
 
@@ -54,7 +61,7 @@ bool Heart::isMoving() const {
     return moving;
 }
 
-void Heart::setPosition(float newX, float newY) {
+void Heart::setPosition(Fixed newX, Fixed newY) {
     x = newX;
     y = newY;
 }
@@ -65,8 +72,8 @@ void Heart::clearPrevious() {
 }
 
 void Heart::draw() {
-    int currentX = static_cast<int>(round(x));
-    int currentY = static_cast<int>(round(y));
+    int currentX = x.cell();
+    int currentY = y.cell();
     
     // Only redraw if position has changed
     if (currentX != lastDrawnX || currentY != lastDrawnY) {
@@ -89,16 +96,21 @@ void Heart::draw() {
     }
 }
 
-float Heart::getX() const { return x; }
-float Heart::getY() const { return y; }
-float Heart::getDirectionX() const { return directionX; }
-float Heart::getDirectionY() const { return directionY; }
-float Heart::getAspectRatio() const { return aspectRatio; }
-float Heart::getSpeed() const { return baseSpeed; }
+Fixed Heart::getX() const { return x; }
+Fixed Heart::getY() const { return y; }
+Fixed Heart::getDirectionX() const { return directionX; }
+Fixed Heart::getDirectionY() const { return directionY; }
+Fixed Heart::getAspectRatio() const { return aspectRatio; }
+Fixed Heart::getSpeed() const { return baseSpeed; }
 
 GameBoard::GameBoard(int startX, int startY, int w, int h, int tw, int th) :
     x(startX), y(startY), width(w), height(h), tileWidth(tw), tileHeight(th) {}
 
+void GameBoard::moveTo(int newX, int newY) {
+    x = newX;
+    y = newY;
+}
+
 void GameBoard::draw(bool showSafeTiles, bool redBorder) {
     // Draw the game board grid
     for (int row = 0; row < height; row++) {
@@ -204,7 +216,7 @@ void GameBoard::draw(bool showSafeTiles, bool redBorder) {
     }
 }
 
-void GameBoard::generateSafeTiles(int numTiles) {
+void GameBoard::generateSafeTiles(int numTiles, RandomGenerator& random) {
     safeTiles.clear();
     
     // Create a list of all possible tile positions
@@ -215,8 +227,10 @@ void GameBoard::generateSafeTiles(int numTiles) {
         }
     }
     
-    // Shuffle the list
-    std::random_shuffle(allTiles.begin(), allTiles.end());
+    // Shuffle the list (Fisher-Yates)
+    for (int i = static_cast<int>(allTiles.size()) - 1; i > 0; i--) {
+        std::swap(allTiles[i], allTiles[random.nextInt(0, i)]);
+    }
     
     // Select the first numTiles as safe tiles
     for (size_t i = 0; i < static_cast<size_t>(numTiles) && i < allTiles.size(); i++) {
@@ -229,16 +243,16 @@ bool GameBoard::isSafeTile(int tileX, int tileY) const {
                     std::make_pair(tileX, tileY)) != safeTiles.end();
 }
 
-std::pair<float, float> GameBoard::boardToScreen(int tileX, int tileY) const {
+std::pair<Fixed, Fixed> GameBoard::boardToScreen(int tileX, int tileY) const {
     return std::make_pair(
-        x + tileX * tileWidth + tileWidth / 2.0f,
-        y + tileY * tileHeight + tileHeight / 2.0f
+        x + tileX * tileWidth + Fixed(tileWidth) / 2,
+        y + tileY * tileHeight + Fixed(tileHeight) / 2
     );
 }
 
-std::pair<int, int> GameBoard::screenToBoard(float screenX, float screenY) const {
-    int boardX = static_cast<int>(floor((screenX - x) / tileWidth));
-    int boardY = static_cast<int>(floor((screenY - y) / tileHeight));
+std::pair<int, int> GameBoard::screenToBoard(Fixed screenX, Fixed screenY) const {
+    int boardX = ((screenX - x) / tileWidth).floor();
+    int boardY = ((screenY - y) / tileHeight).floor();
     
     // Clamp to valid board coordinates
     boardX = std::max(0, std::min(width - 1, boardX));
@@ -247,23 +261,23 @@ std::pair<int, int> GameBoard::screenToBoard(float screenX, float screenY) const
     return std::make_pair(boardX, boardY);
 }
 
-bool GameBoard::isOnBoard(float screenX, float screenY) const {
+bool GameBoard::isOnBoard(Fixed screenX, Fixed screenY) const {
     // Check if coordinates are within the board area
     return screenX >= x && screenX < x + width * tileWidth &&
             screenY >= y && screenY < y + height * tileHeight;
 }
 
-bool GameBoard::isOnTile(float screenX, float screenY) const {
+bool GameBoard::isOnTile(Fixed screenX, Fixed screenY) const {
     // Check if coordinates are on a tile (not on grid lines)
-    int boardX = static_cast<int>(floor((screenX - x) / tileWidth));
-    int boardY = static_cast<int>(floor((screenY - y) / tileHeight));
+    int boardX = ((screenX - x) / tileWidth).floor();
+    int boardY = ((screenY - y) / tileHeight).floor();
     
     if (boardX < 0 || boardX >= width || boardY < 0 || boardY >= height) {
         return false;
     }
     
-    float relativeX = (screenX - x) - boardX * tileWidth;
-    float relativeY = (screenY - y) - boardY * tileHeight;
+    Fixed relativeX = (screenX - x) - boardX * tileWidth;
+    Fixed relativeY = (screenY - y) - boardY * tileHeight;
     
     return relativeX > 0 && relativeX < tileWidth &&
             relativeY > 0 && relativeY < tileHeight;
@@ -297,7 +311,7 @@ void countdown(int seconds, GameBoard& board, Heart& heart, int round, int total
     drawHealthBar(NULL, 5, maxY - 2, 10, hp); // Assuming 10 is the maximum HP
     mvprintw(maxY - 2, maxX - 25, "Round: %d/%d", round, totalRounds);
     
-    refresh();
+    presentFrame();
     napms(1000); // Use napms instead of sleep for better compatibility
     
     // Then display the countdown numbers
@@ -315,7 +329,7 @@ void countdown(int seconds, GameBoard& board, Heart& heart, int round, int total
         drawHealthBar(NULL, 5, maxY - 2, 10, hp); // Assuming 10 is the maximum HP
         mvprintw(maxY - 2, maxX - 25, "Round: %d/%d", round, totalRounds);
         
-        refresh();
+        presentFrame();
         napms(1000); // Use napms instead of sleep
     }
     
@@ -332,48 +346,22 @@ void countdown(int seconds, GameBoard& board, Heart& heart, int round, int total
     
     drawHealthBar(NULL, 5, maxY - 2, 10, hp); // Assuming 10 is the maximum HP
     mvprintw(maxY - 2, maxX - 25, "Round: %d/%d", round, totalRounds);
-    refresh();
+    presentFrame();
     napms(1000); // Use napms instead of sleep
     
     erase();
 }
 
-void drawHealthBar(WINDOW* win, int x, int y, int maxHP, int currentHP) {
-    // If win is NULL, draw to the standard screen
-    if (win == NULL) {
-        mvprintw(y, x, "HP: %d/%d [", currentHP, maxHP);
-        
-        int barWidth = 20; // Width of the health bar
-        int filledWidth = static_cast<int>((static_cast<float>(currentHP) / maxHP) * barWidth);
-        
-        for (int i = 0; i < barWidth; i++) {
-            if (i < filledWidth) {
-                attron(COLOR_PAIR(1)); // Red for filled health
-                addch('=');
-                attroff(COLOR_PAIR(1));
-            } else {
-                addch('-');
-            }
-        }
-        addch(']');
-    } else {
-        // Draw to the provided window
-        mvwprintw(win, y, x, "HP: %d/%d [", currentHP, maxHP);
-        
-        int barWidth = 20; // Width of the health bar
-        int filledWidth = static_cast<int>((static_cast<float>(currentHP) / maxHP) * barWidth);
-        
-        for (int i = 0; i < barWidth; i++) {
-            if (i < filledWidth) {
-                wattron(win, COLOR_PAIR(1)); // Red for filled health
-                waddch(win, '=');
-                wattroff(win, COLOR_PAIR(1));
-            } else {
-                waddch(win, '-');
-            }
-        }
-        waddch(win, ']');
-    }
+// Safe tiles and flash time of each round, edited in 1310_rounds.txt
+static RoundTable roundTable;
+
+bool loadRoundTable() {
+    // Up to every tile of the 10x8 board may be safe
+    if (roundTable.load("1310_rounds.bin", "1310_rounds.txt", {
+            { "safe_tiles", 1, 80 },
+            { "flash_time", 0.05f, 10 } })) return true;
+    std::fprintf(stderr, "%s\n", roundTable.error().c_str());
+    return false;
 }
 
 void runSafeTilesGame() {
@@ -386,19 +374,10 @@ void runSafeTilesGame() {
     const int BOARD_HEIGHT = 8;
     const int TILE_WIDTH = 5;
     const int TILE_HEIGHT = 3;
-    const int TOTAL_ROUNDS = 5;
+    const int TOTAL_ROUNDS = roundTable.rowCount();
     const int ROUND_TIME = 5; // 5 seconds for movement after flash
     int playerHP = 10;
     
-    // Round configurations: {num_safe_tiles, flash_time_in_seconds}
-    const std::vector<std::pair<int, float>> roundConfigs = {
-        {5, 0.5f},  // Round 1: 5 tiles, 0.5 seconds
-        {5, 0.3f},  // Round 2: 5 tiles, 0.3 seconds
-        {3, 0.3f},  // Round 3: 3 tiles, 0.3 seconds
-        {1, 0.3f},  // Round 4: 1 tile, 0.3 seconds
-        {1, 0.1f}   // Round 5: 1 tile, 0.1 seconds
-    };
-    
     // Calculate board position to center it
     int boardX = (maxX - BOARD_WIDTH * TILE_WIDTH) / 2;
     int boardY = (maxY - BOARD_HEIGHT * TILE_HEIGHT) / 2;
@@ -407,20 +386,23 @@ void runSafeTilesGame() {
     GameBoard gameBoard(boardX, boardY, BOARD_WIDTH, BOARD_HEIGHT, TILE_WIDTH, TILE_HEIGHT);
     Heart heart(maxX / 2, maxY / 2);
     
+    // Safe tiles of every round, and saved with the movement phase
+    RandomGenerator random;
+    
     // Main game loop for rounds
     int currentRound = 1;
     bool gameWon = false;
     
     while (currentRound <= TOTAL_ROUNDS && playerHP > 0) {
         // Get configuration for current round
-        int numSafeTiles = roundConfigs[currentRound - 1].first;
-        float flashTime = roundConfigs[currentRound - 1].second;
+        int numSafeTiles = roundTable.getInt(currentRound, "safe_tiles");
+        float flashTime = roundTable.getFloat(currentRound, "flash_time");
         
         // Show round information
         showRoundInfo(currentRound, numSafeTiles, flashTime, playerHP);
         
         // Generate safe tiles for this round
-        gameBoard.generateSafeTiles(numSafeTiles);
+        gameBoard.generateSafeTiles(numSafeTiles, random);
         
         // Set initial heart position to the center of a random tile
         auto centerTile = gameBoard.boardToScreen(BOARD_WIDTH / 2, BOARD_HEIGHT / 2);
@@ -431,7 +413,7 @@ void runSafeTilesGame() {
         box(stdscr, 0, 0); // Add border around the screen
         gameBoard.draw(false, false); // White border initially
         heart.draw();
-        refresh();
+        presentFrame();
         
         // Countdown before showing safe tiles (board and player remain visible)
         countdown(3, gameBoard, heart, currentRound, TOTAL_ROUNDS, playerHP);
@@ -441,7 +423,7 @@ void runSafeTilesGame() {
         box(stdscr, 0, 0); // Add border around the screen
         gameBoard.draw(true, true); // Show safe tiles with red border
         heart.draw();
-        refresh();
+        presentFrame();
         usleep(static_cast<useconds_t>(flashTime * 1000000));
         
         // Hide safe tiles and begin gameplay
@@ -453,10 +435,11 @@ void runSafeTilesGame() {
         // Display HP and round info
         drawHealthBar(NULL, 5, maxY - 2, 10, playerHP);
         mvprintw(maxY - 2, maxX - 25, "Round: %d/%d", currentRound, TOTAL_ROUNDS);
-        refresh();
+        presentFrame();
         
-        // Enable non-blocking input
-        nodelay(stdscr, TRUE);
+        // Non-blocking input for the movement phase, until the end of this
+        // round; the dialogues after it set their own
+        InputMode movement(InputMode::NON_BLOCKING);
         
         // Start the movement phase
         time_t startTime = time(nullptr);
@@ -464,6 +447,26 @@ void runSafeTilesGame() {
         
         // Create a buffer for the screen to prevent flickering
         WINDOW* buffer = newpad(maxY, maxX);
+        FrameTimer frameTimer;
+
+        // The pad is kept between frames: the board is drawn over itself,
+        // only the heart's last cell is blanked, and the HUD line is
+        // written when its numbers change
+        int heartDrawnX = -1, heartDrawnY = -1;
+        HudHealthBar healthBar;
+        HudText timeLabel, roundLabel;
+
+        // Rewind support: the heart, the clock and the random generator.
+        // The clock counts on from where it was, not from how long ago.
+        SnapshotRing history;
+        auto save = [&](SnapshotBuffer& out) {
+            out.put(heart, time(nullptr) - startTime, random);
+        };
+        auto restore = [&](SnapshotBuffer& in) {
+            time_t elapsed;
+            in.get(heart, elapsed, random);
+            startTime = time(nullptr) - elapsed;
+        };
         
         while (!timeUp) {
             // Check if time is up (5 seconds per round)
@@ -478,19 +481,37 @@ void runSafeTilesGame() {
             // Process input
             int ch = getch();
             if (ch != ERR) {
-                if (ch == 'q' || ch == 'Q') {
+                if (ch == KEY_RESIZE) {
+                    // Re-centre the board, carry the heart along with it and
+                    // repaint everything on this frame
+                    getmaxyx(stdscr, maxY, maxX);
+                    int dx = (maxX - BOARD_WIDTH * TILE_WIDTH) / 2 - gameBoard.getX();
+                    int dy = (maxY - BOARD_HEIGHT * TILE_HEIGHT) / 2 - gameBoard.getY();
+                    gameBoard.moveTo(gameBoard.getX() + dx, gameBoard.getY() + dy);
+                    heart.setPosition(heart.getX() + dx, heart.getY() + dy);
+
+                    delwin(buffer);
+                    buffer = newpad(maxY, maxX);
+                    clearok(curscr, TRUE);
+                    heartDrawnX = heartDrawnY = -1;
+                    healthBar.invalidate();
+                    timeLabel.invalidate();
+                    roundLabel.invalidate();
+                } else if (ch == 'q' || ch == 'Q') {
                     // Quit the game
                     delwin(buffer);
                     endwin();
                     return;
+                } else if (rewindEnabled() && isRewindKey(ch)) {
+                    if (SnapshotBuffer* snapshot = history.rewind()) restore(*snapshot);
                 } else if (ch == KEY_UP) {
-                    heart.setDirection(0.0f, -1.0f);  // Up
+                    heart.setDirection(0, -1);  // Up
                 } else if (ch == KEY_DOWN) {
-                    heart.setDirection(0.0f, 1.0f);   // Down
+                    heart.setDirection(0, 1);   // Down
                 } else if (ch == KEY_LEFT) {
-                    heart.setDirection(-1.0f, 0.0f);  // Left
+                    heart.setDirection(-1, 0);  // Left
                 } else if (ch == KEY_RIGHT) {
-                    heart.setDirection(1.0f, 0.0f);   // Right
+                    heart.setDirection(1, 0);   // Right
                 } else if (ch == ' ') {
                     // Space toggles movement
                     if (heart.isMoving()) {
@@ -505,20 +526,24 @@ void runSafeTilesGame() {
             heart.update();
             
             // Boundary checking to keep heart inside the board
-            float heartX = heart.getX();
-            float heartY = heart.getY();
+            Fixed heartX = heart.getX();
+            Fixed heartY = heart.getY();
             
             if (!gameBoard.isOnBoard(heartX, heartY)) {
                 // Push player back onto the board if they go outside
-                float newX = std::max(static_cast<float>(gameBoard.getX() + 1), 
-                                    std::min(heartX, static_cast<float>(gameBoard.getX() + gameBoard.getWidth() * gameBoard.getTileWidth() - 1)));
-                float newY = std::max(static_cast<float>(gameBoard.getY() + 1), 
-                                    std::min(heartY, static_cast<float>(gameBoard.getY() + gameBoard.getHeight() * gameBoard.getTileHeight() - 1)));
+                Fixed newX = max(Fixed(gameBoard.getX() + 1), 
+                                 min(heartX, Fixed(gameBoard.getX() + gameBoard.getWidth() * gameBoard.getTileWidth() - 1)));
+                Fixed newY = max(Fixed(gameBoard.getY() + 1), 
+                                 min(heartY, Fixed(gameBoard.getY() + gameBoard.getHeight() * gameBoard.getTileHeight() - 1)));
                 heart.setPosition(newX, newY);
             }
+
+            if (rewindEnabled()) {
+                if (SnapshotBuffer* snapshot = history.capture()) save(*snapshot);
+            }
             
             // Draw to buffer instead of screen directly to prevent flickering
-            werase(buffer);
+            if (heartDrawnX >= 0) mvwaddch(buffer, heartDrawnY, heartDrawnX, ' ');
             box(buffer, 0, 0); // Add border around the screen
             
             // Draw the game board to buffer with red borders during gameplay
@@ -585,34 +610,33 @@ void runSafeTilesGame() {
             wattroff(buffer, COLOR_PAIR(1));
             
             // Draw the heart to buffer
+            heartDrawnX = heart.getX().cell();
+            heartDrawnY = heart.getY().cell();
             wattron(buffer, COLOR_PAIR(1));
-            mvwaddch(buffer, static_cast<int>(round(heart.getY())), 
-                    static_cast<int>(round(heart.getX())), ACS_DIAMOND);
+            mvwaddch(buffer, heartDrawnY, heartDrawnX, ACS_DIAMOND);
             wattroff(buffer, COLOR_PAIR(1));
             
             // Display HP and time remaining on buffer
-            drawHealthBar(buffer, 5, maxY - 2, 10, playerHP);
-            mvwprintw(buffer, maxY - 2, maxX / 2 - 10, "Time: %d seconds", timeLeft);
-            mvwprintw(buffer, maxY - 2, maxX - 25, "Round: %d/%d", currentRound, TOTAL_ROUNDS);
+            healthBar.show(buffer, 5, maxY - 2, 10, playerHP);
+            timeLabel.show(buffer, maxX / 2 - 10, maxY - 2, 0, "Time: %d seconds", timeLeft);
+            roundLabel.show(buffer, maxX - 25, maxY - 2, 0, "Round: %d/%d", currentRound, TOTAL_ROUNDS);
             
             // Copy the buffer to the screen
             pnoutrefresh(buffer, 0, 0, 0, 0, maxY-1, maxX-1);
             
             // Update the screen in one go
             doupdate();
+            framePresented();
             
-            usleep(16667);  // ~60 FPS
+            frameTimer.wait();  // 60 FPS
         }
         
         // Clean up buffer
         delwin(buffer);
         
-        // Disable non-blocking input
-        nodelay(stdscr, FALSE);
-        
         // Time's up - evaluate player position
-        float heartX = heart.getX();
-        float heartY = heart.getY();
+        Fixed heartX = heart.getX();
+        Fixed heartY = heart.getY();
         
         bool onSafeTile = false;
         
@@ -642,5 +666,6 @@ void runSafeTilesGame() {
     
     // Game over
     gameWon = (playerHP > 0);
+    reportStageOutcome(gameWon, gameWon ? TOTAL_ROUNDS : currentRound, playerHP, 0);
     gameOver(gameWon, currentRound - 1);
 }
\ No newline at end of file
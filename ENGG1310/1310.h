@@ -4,36 +4,39 @@
 #include <ncursesw/ncurses.h>
 #include <vector>
 #include <utility>
+#include "hud.h"
+#include "fixed_point.h"
+#include "random.h"
 
 class Heart {
 private:
-    float x, y;           // Position with floating-point precision for smooth movement
+    Fixed x, y;           // Position with sub-cell precision for smooth movement
     int lastDrawnX, lastDrawnY; // Last position where the heart was drawn
-    float directionX, directionY; // Direction vector (normalized)
-    float baseSpeed;      // Base movement speed
-    float aspectRatio;    // Character aspect ratio (width/height)
+    Fixed directionX, directionY; // Direction vector (normalized)
+    Fixed baseSpeed;      // Base movement speed
+    Fixed aspectRatio;    // Character aspect ratio (width/height)
     bool moving;          // Whether the heart is moving
     int symbol;           // Symbol to represent the heart
 
 public:
     Heart(int startX, int startY);
     void update();
-    void setDirection(float dx, float dy);
-    void setAspectRatio(float ratio);
-    void setSpeed(float speed);
+    void setDirection(Fixed dx, Fixed dy);
+    void setAspectRatio(Fixed ratio);
+    void setSpeed(Fixed speed);
     void stop();
     void start();
     bool isMoving() const;
-    void setPosition(float newX, float newY);
+    void setPosition(Fixed newX, Fixed newY);
     void clearPrevious();
     void draw();
 
-    float getX() const;
-    float getY() const;
-    float getDirectionX() const;
-    float getDirectionY() const;
-    float getAspectRatio() const;
-    float getSpeed() const;
+    Fixed getX() const;
+    Fixed getY() const;
+    Fixed getDirectionX() const;
+    Fixed getDirectionY() const;
+    Fixed getAspectRatio() const;
+    Fixed getSpeed() const;
 };
 
 class GameBoard {
@@ -46,12 +49,13 @@ private:
 public:
     GameBoard(int startX, int startY, int w, int h, int tw, int th);
     void draw(bool showSafeTiles = false, bool redBorder = false);
-    void generateSafeTiles(int numTiles);
+    void generateSafeTiles(int numTiles, RandomGenerator& random);
     bool isSafeTile(int tileX, int tileY) const;
-    std::pair<float, float> boardToScreen(int tileX, int tileY) const;
-    std::pair<int, int> screenToBoard(float screenX, float screenY) const;
-    bool isOnBoard(float screenX, float screenY) const;
-    bool isOnTile(float screenX, float screenY) const;
+    std::pair<Fixed, Fixed> boardToScreen(int tileX, int tileY) const;
+    std::pair<int, int> screenToBoard(Fixed screenX, Fixed screenY) const;
+    bool isOnBoard(Fixed screenX, Fixed screenY) const;
+    bool isOnTile(Fixed screenX, Fixed screenY) const;
+    void moveTo(int newX, int newY);  // Move the top-left corner, e.g. after a resize
 
     int getX() const;
     int getY() const;
@@ -62,7 +66,9 @@ public:
 };
 
 void countdown(int seconds, GameBoard& board, Heart& heart, int round, int totalRounds, int hp);
+// Loads 1310_rounds.bin (rebuilding it from the text if needed); prints the
+// problem and returns false on failure
+bool loadRoundTable();
 void runSafeTilesGame();
-void drawHealthBar(WINDOW* win, int x, int y, int maxHP, int currentHP);
 
 #endif // SAFE_TILES_H
\ No newline at end of file
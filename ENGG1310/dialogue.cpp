@@ -0,0 +1,99 @@
+#include "dialogue.h"
+#include "present.h"
+#include <sstream>
+#include <string>
+
+void showGameIntroduction() {
+    // Clear screen
+    clear();
+    
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 100, true);
+    
+    // Introduction sequence
+    animator.animateText("Welcome to ENGG1310 - Electricity and electronics! I'm your Professor for today's practical assessment.");
+    
+    clear();
+    animator.animateText("Today, you'll be testing your memory and reflexes in our Safe Tiles challenge. This exercise simulates working with electrical circuits under pressure.");
+    
+    clear();
+    animator.animateText("The rules are simple: you'll be shown a grid with some safe tiles that will flash briefly. Your task is to memorize these safe tiles and step ONLY on them.");
+    
+    clear();
+    animator.animateText("WARNING: Stepping on unsafe tiles will trigger our electrical defense system, resulting in a painful shock! Or as I like to call it - a shocking experience!");
+    
+    clear();
+    animator.animateText("You'll start with 10 HP. Each time you step on an unsafe tile, you'll be hit by an electric laser and lose 5 HP. If your HP reaches zero, you fail the course.");
+    
+    clear();
+    animator.animateText("As you progress through rounds, the challenge increases: fewer safe tiles, shorter flash time, and the dreaded red border countdown before each check!");
+    
+    clear();
+    animator.animateText("Use the arrow keys to navigate. Remember - in electrical engineering, one wrong step can be shocking! Don't get zapped by those electric lasers!");
+    
+    clear();
+    animator.animateText("Are you ready to test your electrical safety knowledge? Let's begin the assessment! Remember, this is for your own good - real electrical work requires focus and precision!");
+    
+    clear();
+    maxY++;
+    maxY--;
+}
+
+void showRoundInfo(int round, int numSafeTiles, float flashTime, int hp) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    
+    std::ostringstream oss;
+    oss << "Round " << round << " is about to begin! In this round, you'll need to find " 
+        << numSafeTiles << " safe tiles. You'll have " << flashTime 
+        << " seconds to memorize them. Current HP: " << hp 
+        << ". Remember, don't get hit by the electric lasers!";
+    
+    animator.animateText(oss.str());
+    maxY++;
+    maxY--;
+}
+
+void gameOver(bool won, int finalRound) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    
+    if (won) {
+        animator.animateText("CONGRATULATIONS! You've successfully completed all " + std::to_string(finalRound) + 
+                             " rounds of the electrical safety test. Your memory and reflexes are excellent - you'll make a fine electrical engineer!");
+    } else {
+        animator.animateText("COURSE FAILED! The electric lasers have depleted your health. You only reached round " + 
+                            std::to_string(finalRound) + ". Better luck next semester - electrical safety is no joke!");
+    }
+    maxY++;
+    maxY--;
+}
+
+void showResult(bool safe, int playerHP) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Professor", 80, true);
+    
+    if (safe) {
+        animator.animateText("SAFE TILE! Excellent work. You've successfully navigated the electrical hazard. Current HP: " + std::to_string(playerHP));
+    } else {
+        animator.animateText("YOU GOT HIT BY A LASER! That's an unsafe tile! The electrical defense system has shocked you. You lose 5 HP! Current HP: " + std::to_string(playerHP));
+    }
+    maxY++;
+    maxY--;
+}
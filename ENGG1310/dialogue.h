@@ -0,0 +1,21 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+// ENGG1310 intro, round and ending dialogue. The dialogue box itself is the
+// engine's TextAnimator.
+
+#include "text_animator.h"
+
+// Function to show game introduction
+void showGameIntroduction();
+
+// Show round information
+void showRoundInfo(int round, int numSafeTiles, float flashTime, int hp);
+
+// Show game over screen
+void gameOver(bool won, int finalRound);
+
+// Show result after each round
+void showResult(bool safe, int playerHP);
+
+#endif // DIALOGUE_H
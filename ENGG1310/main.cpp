@@ -1,29 +1,29 @@
 #include <ncursesw/ncurses.h>
 #include <cstdlib>
 #include <ctime>
-#include "text_animator.h"
+#include "dialogue.h"
 #include "1310.h"
+#include "random.h"
+#include "screen.h"
 
 int main() {
+    if (!loadRoundTable()) {
+        return 1;
+    }
+
     // Initialize random seed
-    srand(time(nullptr));
+    seedRandom();
     
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    
-    // Set up colors if terminal supports them
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);     // Red heart/danger
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);   // Safe tiles
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK);  // Messages/names
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);    // UI elements
-        init_pair(5, COLOR_WHITE, COLOR_BLACK);   // Normal borders
-    }
+    // Initialize ncurses once, and colors for the whole game if the
+    // terminal supports them
+    initScreen();
+    PaletteScope palette({
+        {1, COLOR_RED, COLOR_BLACK},     // Red heart/danger
+        {2, COLOR_GREEN, COLOR_BLACK},   // Safe tiles
+        {3, COLOR_YELLOW, COLOR_BLACK},  // Messages/names
+        {4, COLOR_BLUE, COLOR_BLACK},    // UI elements
+        {5, COLOR_WHITE, COLOR_BLACK},   // Normal borders
+    });
 
     // Show game introduction
     showGameIntroduction();
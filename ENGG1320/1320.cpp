@@ -1,100 +1,31 @@
 #include "1320.h"
+#include "present.h"
+#include "frame_timer.h"
+#include "input.h"
+#include "screen.h"
+#include "round_table.h"
+#include "random.h"
 #include <ncurses.h>
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <vector>
-#include <random>
-#include <chrono>
 #include <algorithm>
 #include <string>
 #include <iostream>
 
 using namespace std;
 
-// Coin implementation
-Coin::Coin(float startX, float startY, float spd, int val, CoinType type) :
-    x(startX), y(startY), lastDrawnX(static_cast<int>(startX)), lastDrawnY(static_cast<int>(startY)),
-    speed(spd), active(false), value(val), type(type), 
-    symbol(type == REGULAR ? '*' : (type == SPECIAL ? '$' : 'X')), moveCounter(0) {}
-
-void Coin::update(const Arena* arena) {
-    if (!active) return;
-    
-    // Trap coins move randomly but stay within arena bounds
-    if (type == TRAP && moveCounter++ % 10 == 0) {
-        float newX = x + (rand() % 3 - 1) * 0.5f;
-        float newY = y + (rand() % 3 - 1) * 0.5f;
-        
-        // Only move if within bounds
-        if (arena->contains(newX, newY)) {
-            x = newX;
-            y = newY;
-        }
-    }
-}
-
-void Coin::setValue(int v) { value = v; }
-
-void Coin::draw() const {
-    if (!active) return;
-    
-    int currentX = static_cast<int>(round(x));
-    int currentY = static_cast<int>(round(y));
-    
-    if (currentX != lastDrawnX || currentY != lastDrawnY) {
-        mvaddch(lastDrawnY, lastDrawnX, ' ');
-        lastDrawnX = currentX;
-        lastDrawnY = currentY;
-    }
-    
-    int colorPair = (type == REGULAR ? 3 : (type == SPECIAL ? 4 : 5));
-    attron(COLOR_PAIR(colorPair));
-    mvaddch(currentY, currentX, symbol);
-    attroff(COLOR_PAIR(colorPair));
-}
-
-void Coin::activate(float newX, float newY, CoinType newType) {
-    x = newX;
-    y = newY;
-    type = newType;
-    symbol = (type == REGULAR ? '*' : (type == SPECIAL ? '$' : 'X'));
-    active = true;
-    lastDrawnX = static_cast<int>(round(x));
-    lastDrawnY = static_cast<int>(round(y));
-    spawnTime = chrono::steady_clock::now();
-    moveCounter = 0;
-}
-
-void Coin::deactivate() {
-    if (active) {
-        mvaddch(lastDrawnY, lastDrawnX, ' ');
-        active = false;
-    }
-}
-
-bool Coin::isExpired() const {
-    if (!active) return false;
-    auto now = chrono::steady_clock::now();
-    // Different expiration times based on coin type
-    int expirationTime = (type == TRAP) ? 15 : (type == SPECIAL ? 8 : 10);
-    return chrono::duration_cast<chrono::seconds>(now - spawnTime).count() >= expirationTime;
-}    
-
-bool Coin::isActive() const { return active; }
-int Coin::getValue() const { return value; }
-CoinType Coin::getType() const { return type; }
-float Coin::getX() const { return x; }
-float Coin::getY() const { return y; }
-
-bool Coin::checkCollision(float playerX, float playerY) const {
-    if (!active) return false;
-    float dx = x - playerX;
-    float dy = y - playerY;
-    // Strict collision detection
-    return (dx * dx + dy * dy) < 0.8f;
-}
+// Coins, one EntityKind per CoinType. Lifetimes are in frames at 60 FPS
+// (10, 8 and 15 seconds); collecting one scores its points, and a trap
+// takes its damage in coins. Traps also step about every 10 frames.
+const EntityKind COIN_KINDS[COIN_TYPES] = {
+    { POSITION | GLYPH | COLLIDER | LIFETIME, '*' | COLOR_PAIR(3), 0, { 0, 1, 1 }, 600, 0, { 0, 0 } },
+    { POSITION | GLYPH | COLLIDER | LIFETIME, '$' | COLOR_PAIR(4), 0, { 0, 1, 1 }, 480, 0, { 0, 0 } },
+    { POSITION | GLYPH | COLLIDER | LIFETIME | COOLDOWN, 'X' | COLOR_PAIR(5), 0, { 3, 0, 1 }, 900, 10, { 0, 0 } }
+};
 
 // Arena implementation
 Arena::Arena(int screenWidth, int screenHeight, int arenaWidth, int arenaHeight) {
@@ -135,7 +66,13 @@ void Arena::setNeedsRedraw() {
     needsRedraw = true;
 }
 
-bool Arena::contains(float px, float py) const {
+void Arena::moveTo(int newX, int newY) {
+    x = newX;
+    y = newY;
+    needsRedraw = true;
+}
+
+bool Arena::contains(Fixed px, Fixed py) const {
     return (px > x + 1 && px < x + width - 1 &&
             py > y + 1 && py < y + height - 1);
 }
@@ -150,9 +87,9 @@ int Arena::getInnerWidth() const { return width - 2; }
 int Arena::getInnerHeight() const { return height - 2; }
 
 // Player implementation
-Player::Player(float startX, float startY, float spd, Arena& arenaRef) :
-    x(startX), y(startY), lastDrawnX(static_cast<int>(startX)), lastDrawnY(static_cast<int>(startY)),
-    dx(0.0f), dy(0.0f), speed(spd), aspectRatio(2.0f), 
+Player::Player(Fixed startX, Fixed startY, Fixed spd, Arena& arenaRef) :
+    x(startX), y(startY), lastDrawnX(startX.floor()), lastDrawnY(startY.floor()),
+    dx(0), dy(0), speed(spd), aspectRatio(2), 
     symbol(ACS_DIAMOND), invincible(false), invincibleTimer(0), arena(&arenaRef) {}
 
 void Player::update() {
@@ -160,10 +97,10 @@ void Player::update() {
         invincible = false;
     }
     
-    // Calculate new position with floating-point precision
+    // Calculate new position with sub-cell precision
     // Use aspect ratio for horizontal movement
-    float newX = x + dx * speed * aspectRatio;
-    float newY = y + dy * speed;
+    Fixed newX = x + dx * speed * aspectRatio;
+    Fixed newY = y + dy * speed;
     
     // Check boundaries for each axis independently
     if (newX > arena->getX() + 1 && newX < arena->getX() + arena->getWidth() - 1) {
@@ -176,8 +113,8 @@ void Player::update() {
 }
 
 void Player::draw() const {
-    int currentX = static_cast<int>(round(x));
-    int currentY = static_cast<int>(round(y));
+    int currentX = x.cell();
+    int currentY = y.cell();
     
     if (currentX != lastDrawnX || currentY != lastDrawnY) {
         mvaddch(lastDrawnY, lastDrawnX, ' ');
@@ -193,10 +130,10 @@ void Player::draw() const {
     lastDrawnY = currentY;
 }
 
-void Player::setDirection(float newDx, float newDy) {
+void Player::setDirection(Fixed newDx, Fixed newDy) {
     // Normalize diagonal movement speed
     if (newDx != 0 && newDy != 0) {
-        const float factor = 0.7071f; // 1/sqrt(2)
+        const Fixed factor(0.7071f); // 1/sqrt(2)
         dx = newDx * factor;
         dy = newDy * factor;
     } else {
@@ -205,16 +142,16 @@ void Player::setDirection(float newDx, float newDy) {
     }
 }
 
-void Player::stop() { dx = 0.0f; dy = 0.0f; }
+void Player::stop() { dx = 0; dy = 0; }
 
-float Player::getX() const { return x; }
-float Player::getY() const { return y; }
+Fixed Player::getX() const { return x; }
+Fixed Player::getY() const { return y; }
 
-void Player::setPosition(float newX, float newY) {
+void Player::setPosition(Fixed newX, Fixed newY) {
     x = newX;
     y = newY;
-    lastDrawnX = static_cast<int>(round(x));
-    lastDrawnY = static_cast<int>(round(y));
+    lastDrawnX = x.cell();
+    lastDrawnY = y.cell();
 }
 
 void Player::makeInvincible(int duration) {
@@ -224,14 +161,30 @@ void Player::makeInvincible(int duration) {
 
 bool Player::isInvincible() const { return invincible; }
 
+// Difficulty of each level, edited in 1320_rounds.txt
+static RoundTable roundTable;
+
+bool loadRoundTable() {
+    if (roundTable.load("1320_rounds.bin", "1320_rounds.txt", {
+            { "coins_required", 1, 1000 },
+            { "time_limit", 1, 3600 },
+            { "spawn_interval", 1, 3600 },
+            { "trap_chance", 0, 100 },
+            { "special_chance", 0, 100 } })) return true;
+    std::fprintf(stderr, "%s\n", roundTable.error().c_str());
+    return false;
+}
+
 // Game implementation
 Game::Game(int w, int h)
     : arenaWidth(w), arenaHeight(h),
         coinsCollected(0), totalCoinsCollected(0), level(1),
+        coinsRequired(0), timeLimit(0), spawnInterval(0), trapChance(0), specialChance(0),
         gameOver(false), victory(false), levelComplete(false),
-        countdownActive(false), countdownValue(COUNTDOWN_DURATION),
-        rng(chrono::system_clock::now().time_since_epoch().count()),
-        arena(nullptr), player(nullptr) {
+        countdownActive(false), countdownValue(COUNTDOWN_DURATION), frameCount(0),
+        arena(nullptr), player(nullptr),
+        coins(COIN_KINDS, COIN_KINDS + COIN_TYPES),
+        hudTitle(HudText::CENTRE), hudCoins(HudText::CENTRE), hudTime(HudText::CENTRE), hudHint(HudText::CENTRE) {
     
     initializeNcurses();   // Must be first to get COLS/LINES
     
@@ -250,23 +203,9 @@ Game::~Game() {
 }
 
 void Game::initializeNcurses() {
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    nodelay(stdscr, TRUE);
-
-    if (has_colors()) {
-        start_color();
-        use_default_colors(); 
-        init_pair(1, COLOR_RED, COLOR_BLACK);     // Player
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);   // Arena
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK);  // Regular coins
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);    // Special coins
-        init_pair(5, COLOR_MAGENTA, COLOR_BLACK); // Trap coins
-        init_pair(6, COLOR_CYAN, COLOR_BLACK);    // Messages
-    } else {
+    // The screen and palette are set up once in main() and kept for every
+    // round; a round only checks it has what it needs
+    if (!initScreen(true)) {
         endwin();
         std::cerr << "Your terminal does not support color" << std::endl;
         exit(1);
@@ -291,12 +230,14 @@ void Game::initializeGame(int round) {
     arena = new Arena(COLS, LINES, arenaWidth, arenaHeight);
 
     // Create player centered in arena
-    float playerX = arena->getX() + arena->getWidth() / 2.0f;
-    float playerY = arena->getY() + arena->getHeight() / 2.0f;
+    Fixed playerX = arena->getX() + Fixed(arena->getWidth()) / 2;
+    Fixed playerY = arena->getY() + Fixed(arena->getHeight()) / 2;
     player = new Player(playerX, playerY, PLAYER_SPEED, *arena);
     
-    // Initialize coins
-    coins.resize(MAX_ACTIVE_COINS);
+    // Room for every coin up front, so spawning never allocates
+    for (auto& pool : coins) {
+        pool.reserve(MAX_ACTIVE_COINS);
+    }
     
     // Reset game state
     coinsCollected = 0;
@@ -321,8 +262,9 @@ int Game::runRound(int round) {
     startCountdown();
     startTime = time(nullptr);
     
-    int frameCount = 0;
+    frameCount = 0;
     bool running = true;
+    FrameTimer frameTimer;
     
     while (running) {
         // Process input
@@ -335,10 +277,13 @@ int Game::runRound(int round) {
         }
         else if (!levelComplete && !gameOver) {
             updateGameState(frameCount);
+            if (rewindEnabled()) {
+                if (SnapshotBuffer* snapshot = history.capture()) save(*snapshot);
+            }
         }
         
         renderGame();
-        usleep(16667); // ~60 FPS
+        frameTimer.wait(); // 60 FPS
         frameCount++;
         
         // Check for end conditions
@@ -352,12 +297,12 @@ int Game::runRound(int round) {
             showRoundComplete();
             
             // Wait for key press to continue
-            nodelay(stdscr, FALSE);
+            InputMode input(InputMode::BLOCKING);
             int ch;
             do {
                 ch = getch();
-            } while (ch != '\n' && ch != ' ' && ch != KEY_ENTER && ch != 10 && ch != 13);
-            nodelay(stdscr, TRUE);
+                if (ch == KEY_RESIZE) showRoundComplete();
+            } while (!isEnterKey(ch) && ch != ' ');
             
             running = false;
             return 1;  // Success
@@ -373,9 +318,7 @@ void Game::startCountdown() {
     countdownStartTime = time(nullptr);
     
     // Clear any existing coins
-    for (auto& coin : coins) {
-        coin.deactivate();
-    }
+    removeCoins();
     
     // Center player
     player->setPosition(
@@ -399,7 +342,7 @@ void Game::updateCountdown() {
         int centerY = LINES / 2;
         move(centerY, 0);
         clrtoeol();
-        refresh();
+        presentFrame();
         
         // Spawn initial coins
         for (int i = 0; i < min(5, coinsRequired); i++) {
@@ -413,6 +356,10 @@ void Game::handleInput() {
     int ch = getch();
     if (ch == 'q' || ch == 'Q') {
         gameOver = true;
+    } else if (ch == KEY_RESIZE) {
+        relayout();
+    } else if (rewindEnabled() && isRewindKey(ch) && !countdownActive) {
+        if (SnapshotBuffer* snapshot = history.rewind()) restore(*snapshot);
     } else if (levelComplete && (ch == '\n' || ch == ' ')) {
         return;  // Will exit the runRound loop
     } else if (!levelComplete) {
@@ -420,12 +367,66 @@ void Game::handleInput() {
     }
 }
 
+// Follow a terminal resize: re-centre the arena, shift the player and coins
+// by the same amount and repaint the whole screen on the next render
+void Game::relayout() {
+    int dx = (COLS - arena->getWidth()) / 2 - arena->getX();
+    int dy = (LINES - arena->getHeight()) / 2 - arena->getY();
+
+    arena->moveTo(arena->getX() + dx, arena->getY() + dy);
+    player->setPosition(player->getX() + dx, player->getY() + dy);
+    for (auto& pool : coins) {
+        pool.translate(dx, dy);
+    }
+    clear();
+    invalidateHUD();
+}
+
+void Game::save(SnapshotBuffer& out) const {
+    out.put(arena->getX(), arena->getY(), *player);
+    for (const auto& pool : coins) {
+        pool.save(out);
+    }
+    out.put(coinsCollected, totalCoinsCollected, timeLimit, frameCount);
+    out.put(gameOver, victory, levelComplete, random);
+    // The level clock keeps running through a rewind, so note how far in
+    // this was taken
+    out.put(time(nullptr) - startTime);
+}
+
+void Game::restore(SnapshotBuffer& in) {
+    int arenaX, arenaY;
+    time_t elapsed;
+    in.get(arenaX, arenaY, *player);
+    for (auto& pool : coins) {
+        pool.restore(in);
+    }
+    in.get(coinsCollected, totalCoinsCollected, timeLimit, frameCount);
+    in.get(gameOver, victory, levelComplete, random);
+    in.get(elapsed);
+
+    // The timer restarts from where it was, not from how long ago that was;
+    // coin lifetimes are in frames and came back with the pools
+    startTime = time(nullptr) - elapsed;
+
+    // The arena may have moved since; shift into place and repaint
+    int dx = arena->getX() - arenaX;
+    int dy = arena->getY() - arenaY;
+    player->setPosition(player->getX() + dx, player->getY() + dy);
+    for (auto& pool : coins) {
+        pool.translate(dx, dy);
+    }
+    clear();
+    invalidateHUD();
+    arena->setNeedsRedraw();
+}
+
 void Game::processMovementInput(int ch) {
     switch (ch) {
-        case KEY_UP: player->setDirection(0.0f, -1.0f); break;
-        case KEY_DOWN: player->setDirection(0.0f, 1.0f); break;
-        case KEY_LEFT: player->setDirection(-1.0f, 0.0f); break;
-        case KEY_RIGHT: player->setDirection(1.0f, 0.0f); break;
+        case KEY_UP: player->setDirection(0, -1); break;
+        case KEY_DOWN: player->setDirection(0, 1); break;
+        case KEY_LEFT: player->setDirection(-1, 0); break;
+        case KEY_RIGHT: player->setDirection(1, 0); break;
         case ' ': player->stop(); break;
     }
 }
@@ -434,18 +435,32 @@ void Game::updateGameState(int frameCount) {
     updatePlayerPosition();
     
     // Spawn coins periodically with chance for special coins
-    int spawnRate = 25 - min(level, 20);
-    if (frameCount % spawnRate == 0 && countActiveCoins() < min(coinsRequired + 2, MAX_ACTIVE_COINS)) {
+    if (spawnInterval > 0 && frameCount % spawnInterval == 0 && countActiveCoins() < min(coinsRequired + 2, MAX_ACTIVE_COINS)) {
         trySpawnCoin();
     }
     
-    // Update all game elements
-    for (auto& coin : coins) {
-        coin.update(arena); // Pass arena for boundary checking
-        if (coin.isExpired()) {
-            coin.deactivate();
+    // Trap coins move randomly but stay within arena bounds
+    EntityPool& traps = coins[TRAP];
+    for (int i = 0; i < traps.size(); i++) {
+        if (traps.cooldown[i].ticks > 0) continue;
+        traps.cooldown[i].ticks = traps.cooldown[i].reload;
+        Position& at = traps.position[i];
+        Fixed newX = at.x + Fixed(random.nextInt(-1, 1)) * Fixed(0.5f);
+        Fixed newY = at.y + Fixed(random.nextInt(-1, 1)) * Fixed(0.5f);
+        if (arena->contains(newX, newY)) {
+            at.x = newX;
+            at.y = newY;
+            at.cellX = newX.cell();
+            at.cellY = newY.cell();
         }
     }
+
+    // Coins that were not collected in time disappear
+    for (auto& pool : coins) {
+        cooldownSystem(pool);
+        lifetimeSystem(pool);
+        pool.compact();
+    }
     
     checkCollisions();
     if (!levelComplete) {
@@ -462,78 +477,88 @@ void Game::trySpawnCoin() {
     int marginX = 3;  // Stay away from borders
     int marginY = 3;
     
-    uniform_int_distribution<int> xDist(arena->getX() + marginX, arena->getX() + arena->getWidth() - marginX);
-    uniform_int_distribution<int> yDist(arena->getY() + marginY, arena->getY() + arena->getHeight() - marginY);
-
-    int roll = rng() % 100;
+    int roll = random.nextInt(0, 99);
     CoinType type;
     
     // Determine coin type based on level and random chance
-    if (roll < 5 + level * 3) {  // Trap chance increases with level
+    if (roll < trapChance) {  // Trap chance increases with level
         type = TRAP;
-    } else if (roll < 5 + level * 3 + 100/SPECIAL_COIN_SPAWN_RATE) {
+    } else if (roll < trapChance + specialChance) {
         type = SPECIAL;
     } else {
         type = REGULAR;
     }
 
-    for (auto& coin : coins) {
-        if (!coin.isActive()) {
-            int xPos, yPos;
-            bool validPosition;
-            int attempts = 0;
-            
-            do {
-                xPos = xDist(rng);
-                yPos = yDist(rng);
-                
-                float playerX = player->getX();
-                float playerY = player->getY();
-                float dx = xPos - playerX;
-                float dy = yPos - playerY;
-                
-                validPosition = (dx*dx + dy*dy > 25);  // Min distance of 5 units from player
-                
-                // Check it's not too close to other coins
-                for (const auto& otherCoin : coins) {
-                    if (otherCoin.isActive()) {
-                        float coinDx = xPos - otherCoin.getX();
-                        float coinDy = yPos - otherCoin.getY();
-                        if (coinDx*coinDx + coinDy*coinDy < 4) {  // Min distance of 2 units between coins
-                            validPosition = false;
-                            break;
-                        }
-                    }
+    if (countActiveCoins() >= MAX_ACTIVE_COINS) return;
+
+    int xPos, yPos;
+    bool validPosition;
+    int attempts = 0;
+    
+    do {
+        xPos = random.nextInt(arena->getX() + marginX, arena->getX() + arena->getWidth() - marginX);
+        yPos = random.nextInt(arena->getY() + marginY, arena->getY() + arena->getHeight() - marginY);
+        
+        Fixed playerX = player->getX();
+        Fixed playerY = player->getY();
+        Fixed dx = xPos - playerX;
+        Fixed dy = yPos - playerY;
+        
+        validPosition = (dx*dx + dy*dy > 25);  // Min distance of 5 units from player
+        
+        // Check it's not too close to other coins
+        for (const auto& pool : coins) {
+            for (const Position& other : pool.position) {
+                Fixed coinDx = xPos - other.x;
+                Fixed coinDy = yPos - other.y;
+                if (coinDx*coinDx + coinDy*coinDy < 4) {  // Min distance of 2 units between coins
+                    validPosition = false;
+                    break;
                 }
-                
-                attempts++;
-            } while (!validPosition && attempts < 10);
-            
-            int coinValue = 1;  // All coins are worth 1
-            
-            coin.activate(static_cast<float>(xPos), static_cast<float>(yPos), type);
-            coin.setValue(coinValue);
-            break;
+            }
         }
-    }
+        
+        attempts++;
+    } while (!validPosition && attempts < 10);
+    
+    coins[type].spawn(xPos, yPos);
 }
 
+// The pools are compacted every frame, so every coin in them is live
 int Game::countActiveCoins() const {
-    return count_if(coins.begin(), coins.end(), 
-                  [](const Coin& c) { return c.isActive(); });
+    int count = 0;
+    for (const auto& pool : coins) {
+        count += pool.size();
+    }
+    return count;
+}
+
+// Takes every coin off the board and the screen
+void Game::removeCoins() {
+    for (auto& pool : coins) {
+        for (int i = 0; i < pool.size(); i++) {
+            pool.kill(i);
+        }
+        pool.clear();
+    }
 }
 
 void Game::checkCollisions() {
-    for (auto& coin : coins) {
-        if (coin.isActive() && coin.checkCollision(player->getX(), player->getY())) {
-            CoinType coinType = coin.getType();
+    // A coin is collected when the player stands in its cell
+    int playerX = player->getX().cell();
+    int playerY = player->getY().cell();
+    for (int coinType = 0; coinType < COIN_TYPES; coinType++) {
+        EntityPool& pool = coins[coinType];
+        int coin = pool.findAt(playerX, playerY);
+        if (coin >= 0) {
+            const Collider& effect = pool.collider[coin];
             
             if (coinType == TRAP) {
                 if (!player->isInvincible()) {
                     timeLimit -= 5;  // Lose time for trap
                     
                     // Reduce collected coins by 3 (but not below 0)
-                    int coinsLost = min(3, coinsCollected);
+                    int coinsLost = min(effect.damage, coinsCollected);
                     coinsCollected = max(0, coinsCollected - coinsLost);
                     totalCoinsCollected = max(0, totalCoinsCollected - coinsLost);  // Also reduce total
                     
@@ -541,24 +566,25 @@ void Game::checkCollisions() {
                     mvprintw(arena->getY() - 1, arena->getX() + arena->getWidth() / 2 - 16, 
                             "-5 seconds! -%d coins!", coinsLost);
                     attroff(COLOR_PAIR(5) | A_BOLD);
-                    refresh();
+                    presentFrame();
                     
                     player->makeInvincible(30);
                 }
             } else {
-                coinsCollected++;
-                totalCoinsCollected++;  // Track total coins across all levels
+                coinsCollected += effect.points;
+                totalCoinsCollected += effect.points;  // Track total coins across all levels
                 
                 if (coinType == SPECIAL) {
                     timeLimit += 5;
                     attron(COLOR_PAIR(4) | A_BOLD);
                     mvprintw(arena->getY() - 1, arena->getX() + arena->getWidth() / 2 - 5, "+5 seconds!");
                     attroff(COLOR_PAIR(4) | A_BOLD);
-                    refresh();
+                    presentFrame();
                 }
             }
             
-            coin.deactivate();
+            pool.kill(coin);
+            pool.compact();
             
             if (coinsCollected >= coinsRequired) {
                 levelComplete = true;
@@ -577,8 +603,8 @@ void Game::checkTimeLimit() {
 void Game::renderGame() {
     arena->draw();
     
-    for (const auto& coin : coins) {
-        coin.draw();
+    for (auto& pool : coins) {
+        drawSystem(pool);
     }
     
     player->draw();
@@ -588,7 +614,7 @@ void Game::renderGame() {
         drawCountdown();
     }
 
-    refresh();
+    presentFrame();
 }
 
 void Game::drawCountdown() {
@@ -622,7 +648,7 @@ void Game::drawCountdown() {
         for (size_t i = 0; i < countdownText.length(); i++) {
             mvaddch(centerY, centerX - countdownText.length()/2 + i, background[centerX - countdownText.length()/2 + i]);
         }
-        refresh();
+        presentFrame();
     }
 }
 
@@ -630,71 +656,64 @@ void Game::centerText(int y, const string& text) const {
     mvaddstr(y, COLS / 2 - text.length() / 2, text.c_str());
 }    
 
-void Game::drawHUD() const {
+void Game::drawHUD() {
     if (countdownActive) return;
 
     int hudY = arena->getY() - 5;
     
     if (hudY < 1) hudY = 1;
     
-    // Clear the entire HUD area
-    for (int i = 0; i < arena->getY(); i++) {
-        move(i, 0);
-        clrtoeol();
-    }
-    
-    attron(A_BOLD);
-    centerText(hudY, "COIN CHASE - Level: " + to_string(level) + "/" + to_string(MAX_LEVEL));
-    attroff(A_BOLD);
-    
-    string coinStatus = "Coins: " + to_string(coinsCollected) + "/" + to_string(coinsRequired);
-    centerText(hudY + 2, coinStatus);
+    hudTitle.show(COLS / 2, hudY, A_BOLD, "COIN CHASE - Level: %d/%d", level, MAX_LEVEL);
+    hudCoins.show(COLS / 2, hudY + 2, 0, "Coins: %d/%d", coinsCollected, coinsRequired);
 
     time_t currentTime = time(nullptr);
     int timeLeft = std::max(0, static_cast<int>(timeLimit - (currentTime - startTime)));
     
+    attr_t timeAttrs = 0;
     if (timeLeft <= 5) {
-        attron(COLOR_PAIR(1) | A_BOLD); // Red for low time
+        timeAttrs = COLOR_PAIR(1) | A_BOLD; // Red for low time
     } else if (timeLeft <= 10) {
-        attron(COLOR_PAIR(3)); // Yellow for medium time
-    }
-    
-    centerText(hudY + 3, "Time: " + to_string(timeLeft) + " sec");
-    
-    if (timeLeft <= 10) {
-        attroff(COLOR_PAIR(timeLeft <= 5 ? 1 : 3) | (timeLeft <= 5 ? A_BOLD : 0));
+        timeAttrs = COLOR_PAIR(3); // Yellow for medium time
     }
+    hudTime.show(COLS / 2, hudY + 3, timeAttrs, "Time: %d sec", timeLeft);
 
     // Draw level complete message in center of screen, not tied to HUD
     if (levelComplete) {
+        hudHint.hide();
         attron(COLOR_PAIR(4) | A_BOLD);
         string completeText = "LEVEL COMPLETE! Press SPACE to continue";
         centerText(LINES / 2, completeText);
         attroff(COLOR_PAIR(4) | A_BOLD);
     } else if (hudY + 4 < arena->getY()) {
-        attron(COLOR_PAIR(6));
-        string hintText = "$ = +Time +Coin | X = Danger! (-3 coins)";
-        centerText(hudY + 4, hintText);
-        attroff(COLOR_PAIR(6));
+        hudHint.show(COLS / 2, hudY + 4, COLOR_PAIR(6), "$ = +Time +Coin | X = Danger! (-3 coins)");
     }
 }
 
+// After the screen was cleared under the HUD
+void Game::invalidateHUD() {
+    hudTitle.invalidate();
+    hudCoins.invalidate();
+    hudTime.invalidate();
+    hudHint.invalidate();
+}
+
 void Game::resetLevel(int round) {
     level = round;
     coinsCollected = 0;
-    coinsRequired = BASE_COINS_PER_LEVEL + level * 3;
-    
-    // Calculate time for this level - decreasing by 10 seconds per level
-    timeLimit = BASE_TIME_FOR_LEVEL_1 - (level - 1) * TIME_DECREASE_PER_LEVEL;
+
+    // Difficulty of this level comes from 1320_rounds.txt
+    coinsRequired = roundTable.getInt(level, "coins_required");
+    timeLimit = roundTable.getInt(level, "time_limit");
+    spawnInterval = roundTable.getInt(level, "spawn_interval");
+    trapChance = roundTable.getInt(level, "trap_chance");
+    specialChance = roundTable.getInt(level, "special_chance");
     
     levelComplete = false;
     gameOver = false;
     victory = false;
     
-    // Deactivate all coins
-    for (auto& coin : coins) {
-        coin.deactivate();
-    }
+    // Remove all coins
+    removeCoins();
     
     // Center player
     player->setPosition(
@@ -705,6 +724,7 @@ void Game::resetLevel(int round) {
     player->makeInvincible(30);
     
     clear();
+    invalidateHUD();
     arena->setNeedsRedraw();
 }
 
@@ -746,7 +766,7 @@ void Game::showRoundComplete() const {
     centerText(boxY + boxHeight - 2, "Press ENTER to continue...");
     attroff(A_BOLD);
     
-    refresh();
+    presentFrame();
 }
 
 void Game::showRoundFailed() const {
@@ -786,14 +806,13 @@ void Game::showRoundFailed() const {
     centerText(boxY + boxHeight - 2, "Press ENTER to continue...");
     attroff(A_BOLD);
     
-    refresh();
+    presentFrame();
     
-    nodelay(stdscr, FALSE);
+    InputMode input(InputMode::BLOCKING);
     int ch;
     do {
         ch = getch();
-    } while (ch != '\n' && ch != ' ' && ch != KEY_ENTER && ch != 10 && ch != 13);
-    nodelay(stdscr, TRUE);
+    } while (!isEnterKey(ch) && ch != ' ');
 }
 
 // Standalone function to run a round
@@ -2,58 +2,25 @@
 #define COINGAME_H
 
 #include <vector>
-#include <random>
-#include <chrono>
+#include <string>
+#include "fixed_point.h"
+#include "snapshot_ring.h"
+#include "random.h"
+#include "hud.h"
+#include "entity_store.h"
 
 // Game constants
-constexpr int BASE_COINS_PER_LEVEL = 5;
-constexpr int BASE_TIME_FOR_LEVEL_1 = 60;  // 1 minute for first level
-constexpr int TIME_DECREASE_PER_LEVEL = 10; // Decrease by 10 seconds per level
 constexpr int MAX_ACTIVE_COINS = 15;
-constexpr int SPECIAL_COIN_SPAWN_RATE = 15; // 1 in 15 chance for special coin
-constexpr float PLAYER_SPEED = 0.3f;
+constexpr Fixed PLAYER_SPEED(0.3f);
 constexpr int MAX_LEVEL = 5;  // 5 rounds
 constexpr int COUNTDOWN_DURATION = 5; // 5-second countdown before each level
 
-// Coin types
+// Coin types, each kept in its own EntityPool (Game::coins[type])
 enum CoinType {
     REGULAR,  // Standard yellow coin
     SPECIAL,  // Blue coin that gives 5 seconds extra time
-    TRAP      // Purple coin that costs 5 seconds of time and 3 coins
-};
-
-// Forward declarations
-class Arena;
-
-// Coin class represents collectible objects
-class Coin {
-public:
-    Coin(float startX = 0.0f, float startY = 0.0f, float spd = 0.0f, int val = 1, 
-         CoinType type = REGULAR);
-    
-    void update(const Arena* arena);
-    void draw() const;
-    void setValue(int v);
-    void activate(float newX, float newY, CoinType newType = REGULAR);
-    void deactivate();
-    bool isExpired() const;
-    bool isActive() const;
-    int getValue() const;
-    CoinType getType() const;
-    float getX() const;
-    float getY() const;
-    bool checkCollision(float playerX, float playerY) const;
-    
-private:
-    float x, y;           // Position with floating-point precision
-    mutable int lastDrawnX, lastDrawnY; // Last drawn position for clearing
-    float speed;
-    bool active;
-    int value;
-    CoinType type;
-    char symbol;
-    int moveCounter;
-    std::chrono::steady_clock::time_point spawnTime;
+    TRAP,     // Purple coin that costs 5 seconds of time and 3 coins
+    COIN_TYPES
 };
 
 // Arena class that contains the game area
@@ -63,7 +30,8 @@ public:
     
     void draw();
     void setNeedsRedraw();
-    bool contains(float px, float py) const;
+    void moveTo(int newX, int newY);  // Border is redrawn at the new place
+    bool contains(Fixed px, Fixed py) const;
     
     int getX() const;
     int getY() const;
@@ -83,24 +51,24 @@ private:
 // Player class that the user controls
 class Player {
 public:
-    Player(float startX, float startY, float spd, Arena& arenaRef);
+    Player(Fixed startX, Fixed startY, Fixed spd, Arena& arenaRef);
     
     void update();
     void draw() const;
-    void setDirection(float newDx, float newDy);
+    void setDirection(Fixed newDx, Fixed newDy);
     void stop();
-    float getX() const;
-    float getY() const;
-    void setPosition(float newX, float newY);
+    Fixed getX() const;
+    Fixed getY() const;
+    void setPosition(Fixed newX, Fixed newY);
     void makeInvincible(int duration);
     bool isInvincible() const;
     
 private:
-    float x, y;        // Position with floating-point precision
+    Fixed x, y;        // Position with sub-cell precision
     mutable int lastDrawnX, lastDrawnY; // Last drawn position for clearing
-    float dx, dy;      // Direction (normalized)
-    float speed;
-    float aspectRatio; // For consistent speed horizontally/vertically
+    Fixed dx, dy;      // Direction (normalized)
+    Fixed speed;
+    Fixed aspectRatio; // For consistent speed horizontally/vertically
     int symbol;        // Player's visual representation
     bool invincible;
     int invincibleTimer;
@@ -121,14 +89,20 @@ public:
     void updateCountdown();
     void handleInput();
     void processMovementInput(int ch);
+    void relayout();
+    // Rewind support: player, coins, score and clocks, random generator included
+    void save(SnapshotBuffer& out) const;
+    void restore(SnapshotBuffer& in);
     void updateGameState(int frameCount);
     void updatePlayerPosition();
     void trySpawnCoin();
     int countActiveCoins() const;
+    void removeCoins();
     void checkCollisions();
     void checkTimeLimit();
     void renderGame();
-    void drawHUD() const;
+    void drawHUD();
+    void invalidateHUD();
     void drawCountdown();
     void centerText(int y, const std::string& text) const;
     void resetLevel(int round);
@@ -141,6 +115,9 @@ private:
     int level;
     int coinsRequired;
     int timeLimit;
+    int spawnInterval;   // Frames between spawn attempts
+    int trapChance;      // Percent of spawns that are trap coins
+    int specialChance;   // Percent of spawns that are special coins
     bool gameOver;
     bool victory;
     bool levelComplete;
@@ -148,13 +125,22 @@ private:
     int countdownValue;
     time_t countdownStartTime;
     time_t startTime;
+    int frameCount;      // Ticks since the round started
     
-    std::mt19937 rng;
     Arena* arena;
     Player* player;
-    std::vector<Coin> coins;
+    std::vector<EntityPool> coins;  // Indexed by CoinType
+    RandomGenerator random; // Coin spawns and trap moves, saved with the round
+    SnapshotRing history; // Recent states for the rewind key
+
+    // Lines above the arena, redrawn only when they change
+    HudText hudTitle, hudCoins, hudTime, hudHint;
 };
 
+// Loads 1320_rounds.bin (rebuilding it from the text if needed); prints the
+// problem and returns false on failure
+bool loadRoundTable();
+
 // Standalone function to run a round (used by the main menu)
 int runRound(int round = 1);
 
@@ -1,26 +1,29 @@
 #include "1320.h"
-#include "text_animator.h"
+#include "dialogue.h"
+#include "screen.h"
+#include "random.h"
+#include "stage_result.h"
 #include <ncurses.h>
 
 int main() {
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    nodelay(stdscr, TRUE);  // Non-blocking input
-    
-    // Set up colors if terminal supports them
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);     // Player
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);   // Arena
-        init_pair(3, COLOR_YELLOW, COLOR_BLACK);  // Regular coins & dialogue
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);    // Special coins & dialogue box
-        init_pair(5, COLOR_MAGENTA, COLOR_BLACK); // Trap coins
-        init_pair(6, COLOR_CYAN, COLOR_BLACK);    // Messages
+    if (!loadRoundTable()) {
+        return 1;
+    }
+    seedRandom();
+
+    // Initialize ncurses once with non-blocking input, and colors for the
+    // dialogues and every round if the terminal supports them
+    if (initScreen(true)) {
+        use_default_colors();
     }
+    PaletteScope palette({
+        {1, COLOR_RED, COLOR_BLACK},     // Player
+        {2, COLOR_GREEN, COLOR_BLACK},   // Arena
+        {3, COLOR_YELLOW, COLOR_BLACK},  // Regular coins & dialogue
+        {4, COLOR_BLUE, COLOR_BLACK},    // Special coins & dialogue box
+        {5, COLOR_MAGENTA, COLOR_BLACK}, // Trap coins
+        {6, COLOR_CYAN, COLOR_BLACK},    // Messages
+    });
 
     // Show game introduction
     showGameIntroduction();
@@ -30,8 +33,9 @@ int main() {
     
     // Run all five rounds in sequence
     for (int round = 1; round <= MAX_LEVEL; round++) {
-        // Show information about this round
-        clear();
+        // Show information about this round; erase() so only the cells
+        // that changed are sent, not a full repaint
+        erase();
         showRoundInfo(round);
         
         // Run the round
@@ -42,7 +46,8 @@ int main() {
             totalScore += round * 100;  // Score based on round number
             showRoundComplete(round, totalScore);
         } else {
-            // Failed the round
+            // Failed the round; there is no HP in this stage
+            reportStageOutcome(false, round, -1, totalScore);
             gameOver(false, round, totalScore);
             endwin();
             return 0;
@@ -50,6 +55,7 @@ int main() {
     }
     
     // Player completed all rounds
+    reportStageOutcome(true, MAX_LEVEL, -1, totalScore);
     gameOver(true, MAX_LEVEL, totalScore);
 
     // Clean up
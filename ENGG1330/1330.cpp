@@ -1,4 +1,13 @@
 #include "1330.h"
+#include "present.h"
+#include "hud.h"
+#include "frame_timer.h"
+#include "input.h"
+#include "lookup_tables.h"
+#include "fixed_point.h"
+#include "random.h"
+#include "snapshot_ring.h"
+#include "entity_store.h"
 #include <ncursesw/ncurses.h>
 #include <unistd.h>
 #include <cmath>
@@ -16,11 +25,11 @@ int getLastHP() {
 
 class Heart {
     private:
-        float x, y;
+        Fixed x, y;
         int lastDrawnX, lastDrawnY;
-        float directionX, directionY;
-        float baseSpeed;
-        float aspectRatio;
+        Fixed directionX, directionY;
+        Fixed baseSpeed;
+        Fixed aspectRatio;
         bool moving;
         int symbol;
         int hp;
@@ -32,10 +41,10 @@ class Heart {
     
     public:
         Heart(int startX, int startY) : 
-            x(static_cast<float>(startX)), y(static_cast<float>(startY)), 
+            x(startX), y(startY), 
             lastDrawnX(startX), lastDrawnY(startY),
-            directionX(0.0f), directionY(0.0f),
-            baseSpeed(0.3f), aspectRatio(2.0f),
+            directionX(0), directionY(0),
+            baseSpeed(0.3f), aspectRatio(2),
             moving(false), symbol(ACS_DIAMOND),
             hp(10), invincible(false), invincibleTimer(0), colorPair(1),
             canBeForceStarted(true), safeQuadrant(0), quadrantWarningState(0) {}
@@ -61,20 +70,20 @@ class Heart {
             hp = newHP;
         }
     
-        void setDirection(float dx, float dy) {
-            if (dx != 0.0f || dy != 0.0f) {
-                float length = sqrt(dx * dx + dy * dy);
-                directionX = dx / length;
-                directionY = dy / length;
+        void setDirection(Fixed dx, Fixed dy) {
+            if (dx != 0 || dy != 0) {
+                FixedVec2 direction = FixedVec2(dx, dy).normalized();
+                directionX = direction.x;
+                directionY = direction.y;
                 moving = true;
             }
         }
         
-        void setAspectRatio(float ratio) {
+        void setAspectRatio(Fixed ratio) {
             aspectRatio = ratio;
         }
         
-        void setSpeed(float speed) {
+        void setSpeed(Fixed speed) {
             baseSpeed = speed;
         }
         
@@ -96,20 +105,28 @@ class Heart {
             return canBeForceStarted;
         }
     
-        void setPosition(float newX, float newY) {
+        void setPosition(Fixed newX, Fixed newY) {
             x = newX;
             y = newY;
         }
+
+        // Shift by whole cells when the layout moves
+        void translate(int dx, int dy) {
+            x += dx;
+            y += dy;
+            lastDrawnX += dx;
+            lastDrawnY += dy;
+        }
     
         // Reset heart to initial state with given position
         void reset(int startX, int startY) {
             clearPrevious();
-            x = static_cast<float>(startX);
-            y = static_cast<float>(startY);
+            x = startX;
+            y = startY;
             lastDrawnX = startX;
             lastDrawnY = startY;
-            directionX = 0.0f;
-            directionY = 0.0f;
+            directionX = 0;
+            directionY = 0;
             moving = false;
             hp = 10;
             invincible = false;
@@ -125,8 +142,8 @@ class Heart {
     
         // Draw the heart at its current position
         void draw() {
-            int currentX = static_cast<int>(round(x));
-            int currentY = static_cast<int>(round(y));
+            int currentX = x.cell();
+            int currentY = y.cell();
             
             if (currentX != lastDrawnX || currentY != lastDrawnY) {
                 clearPrevious();
@@ -158,14 +175,14 @@ class Heart {
     
         int getHP() const { return hp; }
         bool isInvincible() const { return invincible; }
-        float getX() const { return x; }
-        float getY() const { return y; }
-        int getIntX() const { return static_cast<int>(round(x)); }
-        int getIntY() const { return static_cast<int>(round(y)); }
-        float getDirectionX() const { return directionX; }
-        float getDirectionY() const { return directionY; }
-        float getAspectRatio() const { return aspectRatio; }
-        float getSpeed() const { return baseSpeed; }
+        Fixed getX() const { return x; }
+        Fixed getY() const { return y; }
+        int getIntX() const { return x.cell(); }
+        int getIntY() const { return y.cell(); }
+        Fixed getDirectionX() const { return directionX; }
+        Fixed getDirectionY() const { return directionY; }
+        Fixed getAspectRatio() const { return aspectRatio; }
+        Fixed getSpeed() const { return baseSpeed; }
         bool isDead() const { return hp <= 0; }
         void setSafeQuadrant(int quadrant) { safeQuadrant = quadrant; }
         int getSafeQuadrant() const { return safeQuadrant; }
@@ -175,54 +192,6 @@ class Heart {
     };
 
 
-class BattleBox {
-private:
-    int x, y;
-    int width, height;
-    bool needsRedraw;
-
-public:
-    BattleBox(int startX, int startY, int w, int h) :
-        x(startX), y(startY), width(w), height(h), needsRedraw(true) {}
-
-    // Draw the battle box boundaries
-    void draw() {
-        attron(A_REVERSE);
-    
-        for (int i = -1; i <= width+1; i++) {
-            mvaddch(y, x + i, ' ');
-            mvaddch(y + height, x + i, ' ');
-        }
-    
-        for (int i = 0; i <= height; i++) {
-            mvaddch(y + i, x, ' ');
-            mvaddch(y + i, x + width, ' ');
-            mvaddch(y + i, x-1, ' ');
-            mvaddch(y + i, x+1 + width, ' ');
-        }
-    
-        attroff(A_REVERSE);
-        
-        needsRedraw = false;
-    }
-
-    void setNeedsRedraw() {
-        needsRedraw = true;
-    }
-
-    // Accessor methods for box dimensions
-    int getX() const { return x; }
-    int getY() const { return y; }
-    int getWidth() const { return width; }
-    int getHeight() const { return height; }
-    int getInnerMinX() const { return x + 1; }
-    int getInnerMinY() const { return y + 1; }
-    int getInnerMaxX() const { return x + width - 1; }
-    int getInnerMaxY() const { return y + height - 1; }
-    int getCenterX() const { return x + width / 2; }
-    int getCenterY() const { return y + height / 2; }
-};
-
 class Snake {
 private:
     std::deque<std::pair<int, int>> segments;
@@ -244,7 +213,7 @@ public:
     }
 
     // Update snake position to follow the heart
-    void update(int heartX, int heartY) {
+    void update(int heartX, int heartY, RandomGenerator& random) {
         if (!active) return;
         
         updateDelay++;
@@ -270,7 +239,7 @@ public:
             
             // Prevent diagonal movement
             if (dx != 0 && dy != 0) {
-                if (rand() % 2 == 0) {
+                if (random.nextInt(0, 1) == 0) {
                     dy = 0;
                 } else {
                     dx = 0;
@@ -340,9 +309,41 @@ public:
     bool isActive() const {
         return active;
     }
+
+    void translate(int dx, int dy) {
+        for (auto& segment : segments) {
+            segment.first += dx;
+            segment.second += dy;
+        }
+    }
+
+    // Rewind support
+    void save(SnapshotBuffer& out) const {
+        out.put(length, updateDelay, collisionCooldown, active, segments.size());
+        for (const auto& segment : segments) {
+            out.put(segment.first, segment.second);
+        }
+    }
+
+    void restore(SnapshotBuffer& in) {
+        size_t count;
+        in.get(length, updateDelay, collisionCooldown, active, count);
+        segments.clear();
+        for (size_t i = 0; i < count; i++) {
+            int segmentX, segmentY;
+            in.get(segmentX, segmentY);
+            segments.push_back(std::make_pair(segmentX, segmentY));
+        }
+    }
 };
 
 
+// A cell a laser has passed through, left burning for a second at 60 FPS;
+// draw() colours it by age
+const EntityKind TRAIL_KIND = {
+    POSITION | GLYPH | LIFETIME, '*' | COLOR_PAIR(3), 0, { 0, 0, 0 }, 60, 0
+};
+
 class Laser {
 private:
     int startX, startY;
@@ -355,10 +356,9 @@ private:
     LaserDirection direction;
     char symbol;
     
-    float projectilePos;
-    float projectileSpeed;
-    std::vector<std::pair<int, int>> trail;
-    std::vector<int> trailTimers;
+    Fixed projectilePos;
+    Fixed projectileSpeed;
+    EntityPool trail;     // Oldest first
     int maxTrailLength;
     
     int boxMinX, boxMinY, boxMaxX, boxMaxY;
@@ -370,9 +370,11 @@ public:
         warningTimer(0), activeTimer(60),
         colorPair(3), active(false), warning(false),
         direction(dir), symbol('*'),
-        projectilePos(0.0f), projectileSpeed(0.02f),
+        projectilePos(0), projectileSpeed(0.02f), trail(TRAIL_KIND),
         maxTrailLength(std::max(abs(eX - sX), abs(eY - sY)) + 1),
-        boxMinX(minX), boxMinY(minY), boxMaxX(maxX), boxMaxY(maxY) {}
+        boxMinX(minX), boxMinY(minY), boxMaxX(maxX), boxMaxY(maxY) {
+        trail.reserve(maxTrailLength);
+    }
 
     // Activate the laser and prepare for firing
     void activate() {
@@ -380,8 +382,7 @@ public:
         active = true;
         activeTimer = 60;
         trail.clear();
-        trailTimers.clear();
-        projectilePos = 0.0f;
+        projectilePos = 0;
     }
 
     // Update laser position and trail
@@ -391,76 +392,52 @@ public:
             
             projectilePos += projectileSpeed;
             
-            if (projectilePos <= 1.0f) {
+            if (projectilePos <= 1) {
                 int x, y;
                 getPointOnPath(projectilePos, x, y);
                 
                 if (x >= boxMinX && x <= boxMaxX && y >= boxMinY && y <= boxMaxY) {
-                    if (trail.empty() || trail.back().first != x || trail.back().second != y) {
-                        trail.push_back(std::make_pair(x, y));
-                        trailTimers.push_back(60);
+                    int last = trail.size() - 1;
+                    if (last < 0 || trail.position[last].cellX != x || trail.position[last].cellY != y) {
+                        trail.spawn(x, y);
                     }
                 }
             }
             
-            if (activeTimer <= 0 || projectilePos > 1.0f) {
+            if (activeTimer <= 0 || projectilePos > 1) {
                 active = false;
             }
         }
         
-        // Update trail timers and remove old trail segments
-        for (size_t i = 0; i < trailTimers.size(); i++) {
-            trailTimers[i]--;
-            
-            if (trailTimers[i] <= 0) {
-                mvaddch(trail[i].second, trail[i].first, ' ');
-                
-                trail.erase(trail.begin() + i);
-                trailTimers.erase(trailTimers.begin() + i);
-                i--;
-            }
-        }
+        // Age the trail; expired segments are cleared from the screen
+        lifetimeSystem(trail);
+        trail.compact();
     }
 
     void clear() {
-        if (!trail.empty()) {
-            for (const auto& point : trail) {
-                mvaddch(point.second, point.first, ' ');
-            }
+        for (const Position& point : trail.position) {
+            mvaddch(point.cellY, point.cellX, ' ');
         }
     }
 
     // Draw laser and its trail
     void draw() {
         if (active) {
-            for (size_t i = 0; i < trail.size(); i++) {
-                int colorIntensity = 3;
-                if (i < trail.size() / 2) {
-                    colorIntensity = 6;
-                }
-                
-                attron(COLOR_PAIR(colorIntensity));
-                mvaddch(trail[i].second, trail[i].first, '*');
-                attroff(COLOR_PAIR(colorIntensity));
+            // Older half of the trail in magenta, newer half in cyan
+            int half = trail.size() / 2;
+            for (int i = 0; i < trail.size(); i++) {
+                trail.glyph[i].look = '*' | COLOR_PAIR(i < half ? 6 : 3);
             }
+            drawSystem(trail);
             
-            if (projectilePos <= 1.0f) {
+            if (projectilePos <= 1) {
                 int x, y;
                 getPointOnPath(projectilePos, x, y);
                 
                 if (x >= boxMinX && x <= boxMaxX && y >= boxMinY && y <= boxMaxY) {
-                    attron(COLOR_PAIR(7));
-                    
-                    // Draw different symbols based on laser direction
-                    if (direction == LaserDirection::HORIZONTAL || direction == LaserDirection::VERTICAL) {
-                        mvaddch(y, x, 'R');
-                    } else if (direction == LaserDirection::DIAGONAL_DOWN || direction == LaserDirection::DIAGONAL_UP) {
-                        mvaddch(y, x, 'B');
-                    } else if (direction == LaserDirection::KNIGHT) {
-                        mvaddch(y, x, 'N');
-                    }
-                    
-                    attroff(COLOR_PAIR(7));
+                    // The chess piece firing it, indexed by LaserDirection
+                    const chtype heads[] = { 'R', 'R', 'B', 'B', 'N' };
+                    mvaddch(y, x, heads[static_cast<int>(direction)] | COLOR_PAIR(7));
                 }
             }
         }
@@ -468,18 +445,16 @@ public:
 
     // Check collision between laser and heart
     bool checkCollision(const Heart& heart) {
-        if (!active && trail.empty()) return false;
+        if (!active && trail.size() == 0) return false;
     
         int heartX = heart.getIntX();
         int heartY = heart.getIntY();
     
-        for (const auto& point : trail) {
-            if (point.first == heartX && point.second == heartY) {
-                return true;
-            }
+        if (trail.findAt(heartX, heartY) >= 0) {
+            return true;
         }
     
-        if (active && projectilePos <= 1.0f) {
+        if (active && projectilePos <= 1) {
             int x, y;
             getPointOnPath(projectilePos, x, y);
     
@@ -495,7 +470,7 @@ public:
 
     bool isActive() const { return active; }
     bool isWarning() const { return warning; }
-    bool isComplete() const { return !active && trail.empty(); }
+    bool isComplete() const { return !active && trail.size() == 0; }
     void setActiveTimer(int frames) { activeTimer = frames; }
 
     void updateEndPoint(int newEndX, int newEndY) {
@@ -503,14 +478,58 @@ public:
         endY = newEndY;
     }
 
+    // Move the path, the trail left so far and the box it is clipped to
+    void translate(int dx, int dy) {
+        startX += dx;
+        startY += dy;
+        endX += dx;
+        endY += dy;
+        trail.translate(dx, dy);
+        boxMinX += dx;
+        boxMinY += dy;
+        boxMaxX += dx;
+        boxMaxY += dy;
+    }
+
+    // Rewind support: the path, timers and trail
+    void save(SnapshotBuffer& out) const {
+        out.put(startX, startY, endX, endY, warningTimer, activeTimer, colorPair);
+        out.put(active, warning, direction, projectilePos, projectileSpeed, maxTrailLength);
+        out.put(boxMinX, boxMinY, boxMaxX, boxMaxY);
+        trail.save(out);
+    }
+
+    void restore(SnapshotBuffer& in) {
+        in.get(startX, startY, endX, endY, warningTimer, activeTimer, colorPair);
+        in.get(active, warning, direction, projectilePos, projectileSpeed, maxTrailLength);
+        in.get(boxMinX, boxMinY, boxMaxX, boxMaxY);
+        trail.restore(in);
+    }
+
 private:
     // Calculate point along the laser path based on interpolation parameter t
-    void getPointOnPath(float t, int& x, int& y) {
-        x = static_cast<int>(std::round(startX + t * (endX - startX)));
-        y = static_cast<int>(std::round(startY + t * (endY - startY)));
+    void getPointOnPath(Fixed t, int& x, int& y) {
+        x = (startX + t * (endX - startX)).cell();
+        y = (startY + t * (endY - startY)).cell();
     }
 };
 
+void saveLasers(SnapshotBuffer& out, const std::vector<Laser>& lasers) {
+    out.put(lasers.size());
+    for (const auto& laser : lasers) laser.save(out);
+}
+
+void restoreLasers(SnapshotBuffer& in, std::vector<Laser>& lasers) {
+    size_t count;
+    in.get(count);
+    lasers.clear();
+    for (size_t i = 0; i < count; i++) {
+        Laser laser(0, 0, 0, 0, LaserDirection::HORIZONTAL, 0, 0, 0, 0);
+        laser.restore(in);
+        lasers.push_back(laser);
+    }
+}
+
 class Knight {
 private:
     int x, y;
@@ -528,7 +547,7 @@ public:
         boxMinX(minX), boxMinY(minY), boxMaxX(maxX), boxMaxY(maxY) {}
     
     // Spawn knight at random position in battle box
-    void spawn(const BattleBox& box) {
+    void spawn(const BattleBox& box, RandomGenerator& random) {
         int minX = box.getInnerMinX();
         int minY = box.getInnerMinY();
         int maxX = box.getInnerMaxX();
@@ -539,8 +558,8 @@ public:
         boxMaxX = maxX;
         boxMaxY = maxY;
         
-        x = minX + rand() % (maxX - minX + 1);
-        y = minY + rand() % (maxY - minY + 1);
+        x = random.nextInt(minX, maxX);
+        y = random.nextInt(minY, maxY);
         
         active = true;
         
@@ -606,20 +625,38 @@ public:
     bool isActive() const {
         return active;
     }
+
+    void translate(int dx, int dy) {
+        x += dx;
+        y += dy;
+        boxMinX += dx;
+        boxMinY += dy;
+        boxMaxX += dx;
+        boxMaxY += dy;
+        for (auto& laser : lasers) {
+            laser.translate(dx, dy);
+        }
+    }
+
+    // Rewind support
+    void save(SnapshotBuffer& out) const {
+        out.put(x, y, spawnTimer, active, boxMinX, boxMinY, boxMaxX, boxMaxY);
+        saveLasers(out, lasers);
+    }
+
+    void restore(SnapshotBuffer& in) {
+        in.get(x, y, spawnTimer, active, boxMinX, boxMinY, boxMaxX, boxMaxY);
+        restoreLasers(in, lasers);
+    }
     
 private:
     // Create L-shaped laser patterns in 8 possible knight-move directions
     void createKnightLasers() {
         lasers.clear();
         
-        const int knightMoves[8][2] = {
-            {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, 
-            {-2, -1}, {-1, -2}, {1, -2}, {2, -1}
-        };
-        
-        for (int i = 0; i < 8; i++) {
-            int targetX = x + knightMoves[i][0];
-            int targetY = y + knightMoves[i][1];
+        for (const CellOffset& move : KNIGHT_MOVES) {
+            int targetX = x + move.dx;
+            int targetY = y + move.dy;
             
             if (targetX >= boxMinX && targetX <= boxMaxX && 
                 targetY >= boxMinY && targetY <= boxMaxY) {
@@ -632,25 +669,6 @@ private:
     }
 };
 
-// Draw health bar UI at specified position
-void drawHealthBar(int x, int y, int maxHP, int currentHP) {
-    mvprintw(y, x, "HP: %d/%d [", currentHP, maxHP);
-    
-    int barWidth = 20;
-    int filledWidth = static_cast<int>((static_cast<float>(currentHP) / maxHP) * barWidth);
-    
-    for (int i = 0; i < barWidth; i++) {
-        if (i < filledWidth) {
-            attron(COLOR_PAIR(1));
-            addch('=');
-            attroff(COLOR_PAIR(1));
-        } else {
-            addch('-');
-        }
-    }
-    addch(']');
-}
-
 // Create horizontal laser patterns with specified count
 std::vector<Laser> createHorizontalLines(const BattleBox& box, int count, int playerY) {
     std::vector<Laser> lasers;
@@ -972,7 +990,7 @@ void clearAllElements(std::vector<Laser>& lasers, Snake& snake, Knight& knight)
 
     snake.clear();
     knight.clear();
-    refresh();
+    presentFrame();
 }
 
 // Display message and wait for Enter key press
@@ -981,16 +999,9 @@ void waitForEnter(const char* message, int x, int y) {
     clrtoeol();
     
     mvprintw(y, x, "%s", message);
-    refresh();
+    presentFrame();
     
-    nodelay(stdscr, FALSE);
-    
-    int ch;
-    do {
-        ch = getch();
-    } while (ch != '\n' && ch != KEY_ENTER && ch != 10 && ch != 13);
-    
-    nodelay(stdscr, TRUE);
+    waitForEnter();
     
     move(y, x);
     clrtoeol();
@@ -1014,6 +1025,7 @@ bool runRound(int round, int initialHP) {
 
     Snake snake(maxX/2 - 10, maxY/2, 5);
     Knight knight(boxMinX, boxMinY, boxMaxX, boxMaxY);
+    RandomGenerator random;  // Attacks, knights and the snake's turns
     int knightSpawnTimer = 0;
 
     bool running = true;
@@ -1029,24 +1041,81 @@ bool runRound(int round, int initialHP) {
     bool gameStarted = false;
     int newSafeQuadrant = 0;
 
+    // Health and round, redrawn only when they change
+    HudHealthBar healthBar;
+    HudText roundLabel;
+
+    // Follow a terminal resize: re-centre the box, shift everything in it by
+    // the same amount and repaint the whole screen once
+    auto relayout = [&]() {
+        getmaxyx(stdscr, maxY, maxX);
+        int dx = maxX/2 - battleBox.getWidth()/2 - battleBox.getX();
+        int dy = maxY/2 - battleBox.getHeight()/2 - battleBox.getY();
+
+        battleBox.moveTo(battleBox.getX() + dx, battleBox.getY() + dy);
+        heart.translate(dx, dy);
+        snake.translate(dx, dy);
+        knight.translate(dx, dy);
+        for (auto& laser : lasers) laser.translate(dx, dy);
+        messageY += dy;
+
+        clear();
+        battleBox.draw();
+        mvprintw(maxY - 3, 2, "Arrow keys to set direction, Space to stop/start");
+        healthBar.invalidate();
+        roundLabel.invalidate();
+    };
+
+    // Rewind support: everything the round keeps from one frame to the
+    // next, random generator included
+    SnapshotRing history;
+    auto save = [&](SnapshotBuffer& out) {
+        out.put(battleBox, heart, knightSpawnTimer, inAttackCycle, messageY);
+        out.put(waveTimer, currentWave, maxWaves, randomAttackType, roundCompleted);
+        out.put(newSafeQuadrant, lastHeartHP, random);
+        snake.save(out);
+        knight.save(out);
+        saveLasers(out, lasers);
+    };
+    auto restore = [&](SnapshotBuffer& in) {
+        in.get(battleBox, heart, knightSpawnTimer, inAttackCycle, messageY);
+        in.get(waveTimer, currentWave, maxWaves, randomAttackType, roundCompleted);
+        in.get(newSafeQuadrant, lastHeartHP, random);
+        snake.restore(in);
+        knight.restore(in);
+        restoreLasers(in, lasers);
+
+        // Back in place for the current terminal size, repainted
+        relayout();
+    };
+
     battleBox.draw();
     mvprintw(maxY - 3, 2, "Arrow keys to set direction, Space to stop/start");
 
-    heart.setDirection(1.0f, 0.0f);
+    heart.setDirection(1, 0);
     heart.start();
 
-
+    FrameTimer frameTimer;
     while (running) {
         if (!gameStarted) {
+            // Keys wait in the queue until the round starts, but a resize
+            // is applied straight away
+            int ch = getch();
+            if (ch == KEY_RESIZE) {
+                relayout();
+            } else if (ch != ERR) {
+                ungetch(ch);
+            }
+
             mvprintw(messageY, maxX/2 - 17, "Get ready! Starting in %d seconds...", (initialDelay + 59) / 60);
-            refresh();
+            presentFrame();
 
             initialDelay--;
             if (initialDelay <= 0) {
                 gameStarted = true;
                 mvprintw(messageY, maxX/2 - 17, "                                  ");
             } else {
-                usleep(16667);
+                frameTimer.wait();
                 continue;
             }
         }
@@ -1081,7 +1150,7 @@ bool runRound(int round, int initialHP) {
                 case 3:
                     maxWaves = 5;
                     if (currentWave == 0 && waveTimer == 0) {
-                        randomAttackType = rand() % 4;
+                        randomAttackType = random.nextInt(0, 3);
                         if (randomAttackType == 0) {
                             lasers = createTicTacToePattern(battleBox);
                         } else if (randomAttackType == 1) {
@@ -1096,14 +1165,14 @@ bool runRound(int round, int initialHP) {
                     break;
                 case 4:
                     maxWaves = 4;
-                    newSafeQuadrant = rand() % 4;
+                    newSafeQuadrant = random.nextInt(0, 3);
                     heart.setSafeQuadrant(newSafeQuadrant);
                     heart.setQuadrantWarningState(0);
                     break;
                 case 5:
                     maxWaves = 4;
                     snake.setActive(true);
-                    randomAttackType = rand() % 4;
+                    randomAttackType = random.nextInt(0, 3);
                     if (randomAttackType == 0) {
                         std::vector<Laser> tt1 = createTicTacToePattern(battleBox);
                         std::vector<Laser> tt2 = createTicTacToePattern(battleBox);
@@ -1123,7 +1192,7 @@ bool runRound(int round, int initialHP) {
                     break;
                 case 6:
                     maxWaves = 6;
-                    randomAttackType = rand() % 4;
+                    randomAttackType = random.nextInt(0, 3);
                     if (randomAttackType == 0) {
                         std::vector<Laser> tt1 = createTicTacToePattern(battleBox);
                         std::vector<Laser> tt2 = createTicTacToePattern(battleBox);
@@ -1147,7 +1216,7 @@ bool runRound(int round, int initialHP) {
                     lasers = createHorizontalLines(battleBox, 3, heart.getIntY());
                     for (auto& laser : lasers) laser.activate();
                     snake.setActive(true);
-                    knight.spawn(battleBox);  // Spawn a knight from the start
+                    knight.spawn(battleBox, random);  // Spawn a knight from the start
                     break;
             }
             heart.start();
@@ -1161,22 +1230,26 @@ bool runRound(int round, int initialHP) {
                 if (heart.isMoving()) heart.stop();
                 else heart.start();
             } else if (ch == KEY_UP) {
-                heart.setDirection(0.0f, -1.0f); heart.start();
+                heart.setDirection(0, -1); heart.start();
             } else if (ch == KEY_DOWN) {
-                heart.setDirection(0.0f, 1.0f); heart.start();
+                heart.setDirection(0, 1); heart.start();
             } else if (ch == KEY_LEFT) {
-                heart.setDirection(-1.0f, 0.0f); heart.start();
+                heart.setDirection(-1, 0); heart.start();
             } else if (ch == KEY_RIGHT) {
-                heart.setDirection(1.0f, 0.0f); heart.start();
+                heart.setDirection(1, 0); heart.start();
+            } else if (ch == KEY_RESIZE) {
+                relayout();
+            } else if (rewindEnabled() && isRewindKey(ch)) {
+                if (SnapshotBuffer* snapshot = history.rewind()) restore(*snapshot);
             }
         }
 
         // Auto-start with current direction if heart can be force started
         if (!heart.isMoving() && heart.canForceStart()) {
-            float dirX = heart.getDirectionX();
-            float dirY = heart.getDirectionY();
-            if (dirX == 0.0f && dirY == 0.0f) {
-                heart.setDirection(1.0f, 0.0f);
+            Fixed dirX = heart.getDirectionX();
+            Fixed dirY = heart.getDirectionY();
+            if (dirX == 0 && dirY == 0) {
+                heart.setDirection(1, 0);
             }
             heart.start();
         }
@@ -1189,7 +1262,7 @@ bool runRound(int round, int initialHP) {
             if (knightSpawnTimer >= 60) {
                 knightSpawnTimer = 0;
                 if (knight.isActive()) knight.clear();
-                knight.spawn(battleBox);
+                knight.spawn(battleBox, random);
             }
             knight.update();
             if (knight.checkCollision(heart)) heart.takeDamage();
@@ -1198,21 +1271,21 @@ bool runRound(int round, int initialHP) {
         // Handle snake movement and collision
         if (snake.isActive()) {
             snake.clear();
-            snake.update(heart.getIntX(), heart.getIntY());
+            snake.update(heart.getIntX(), heart.getIntY(), random);
             if (snake.checkCollision(heart)) heart.takeDamage();
         }
 
         // Keep heart within battle box boundaries
-        float heartX = heart.getX();
-        float heartY = heart.getY();
+        Fixed heartX = heart.getX();
+        Fixed heartY = heart.getY();
         if (heartX < battleBox.getInnerMinX())
-            heart.setPosition(static_cast<float>(battleBox.getInnerMinX()), heartY);
+            heart.setPosition(battleBox.getInnerMinX(), heartY);
         if (heartX > battleBox.getInnerMaxX())
-            heart.setPosition(static_cast<float>(battleBox.getInnerMaxX()), heartY);
+            heart.setPosition(battleBox.getInnerMaxX(), heartY);
         if (heartY < battleBox.getInnerMinY())
-            heart.setPosition(heartX, static_cast<float>(battleBox.getInnerMinY()));
+            heart.setPosition(heartX, battleBox.getInnerMinY());
         if (heartY > battleBox.getInnerMaxY())
-            heart.setPosition(heartX, static_cast<float>(battleBox.getInnerMaxY()));
+            heart.setPosition(heartX, battleBox.getInnerMaxY());
 
         if (inAttackCycle) {
             waveTimer++;
@@ -1261,7 +1334,7 @@ bool runRound(int round, int initialHP) {
                         lasers.clear();
                         currentWave++;
                         waveTimer = 0;
-                        randomAttackType = rand() % 4;
+                        randomAttackType = random.nextInt(0, 3);
                         if (randomAttackType == 0) {
                             lasers = createTicTacToePattern(battleBox);
                         } else if (randomAttackType == 1) {
@@ -1345,7 +1418,7 @@ bool runRound(int round, int initialHP) {
                 
                             int previousSafeQuadrant = heart.getSafeQuadrant();
                             do {
-                                newSafeQuadrant = rand() % 4;
+                                newSafeQuadrant = random.nextInt(0, 3);
                             } while (newSafeQuadrant == previousSafeQuadrant);
                             heart.setSafeQuadrant(newSafeQuadrant);
                 
@@ -1360,7 +1433,7 @@ bool runRound(int round, int initialHP) {
                         lasers.clear();
                         currentWave++;
                         waveTimer = 0;
-                        randomAttackType = rand() % 4;
+                        randomAttackType = random.nextInt(0, 3);
                         if (randomAttackType == 0) {
                             std::vector<Laser> tt1 = createTicTacToePattern(battleBox);
                             std::vector<Laser> tt2 = createTicTacToePattern(battleBox);
@@ -1389,18 +1462,18 @@ bool runRound(int round, int initialHP) {
                         if (currentWave == 1) {
                             lasers = createHorizontalLines(battleBox, 3, heart.getIntY());
                             for (auto& laser : lasers) laser.activate();
-                            knight.spawn(battleBox);
+                            knight.spawn(battleBox, random);
                         } else if (currentWave == 2) {
                             lasers = createXCrossPattern(battleBox);
                             for (auto& laser : lasers) laser.activate();
-                            knight.spawn(battleBox);
+                            knight.spawn(battleBox, random);
                         } else if (currentWave == 3) {
                             std::vector<Laser> horizontal = createHorizontalLines(battleBox, 2, heart.getIntY());
                             std::vector<Laser> vertical = createVerticalLines(battleBox, 2, heart.getIntX());
                             lasers = horizontal;
                             lasers.insert(lasers.end(), vertical.begin(), vertical.end());
                             for (auto& laser : lasers) laser.activate();
-                            knight.spawn(battleBox);
+                            knight.spawn(battleBox, random);
                         }
                     }
                     break; // Added break to fix fall-through
@@ -1418,14 +1491,14 @@ bool runRound(int round, int initialHP) {
                                     std::vector<Laser> vertical = createVerticalLines(battleBox, 3, heart.getIntX());
                                     lasers = horizontal;
                                     lasers.insert(lasers.end(), vertical.begin(), vertical.end());
-                                    knight.spawn(battleBox); // Spawn a new knight
+                                    knight.spawn(battleBox, random); // Spawn a new knight
                                 }
                                 break;
                             case 3: lasers = createTicTacToePattern(battleBox); break;
                             case 4: 
                                 {
                                     lasers = createXCrossPattern(battleBox); 
-                                    knight.spawn(battleBox); // Spawn a new knight
+                                    knight.spawn(battleBox, random); // Spawn a new knight
                                 }
                                 break;
                             case 5: lasers = createHorizontalLines(battleBox, 5, heart.getIntY()); break;
@@ -1435,7 +1508,7 @@ bool runRound(int round, int initialHP) {
                                     std::vector<Laser> vertical = createVerticalLines(battleBox, 3, heart.getIntX() - 2);
                                     lasers = horizontal;
                                     lasers.insert(lasers.end(), vertical.begin(), vertical.end());
-                                    knight.spawn(battleBox); // Spawn a new knight
+                                    knight.spawn(battleBox, random); // Spawn a new knight
                                 }
                                 break;
                             case 7: 
@@ -1445,7 +1518,7 @@ bool runRound(int round, int initialHP) {
                                     std::vector<Laser> grid = createTicTacToePattern(battleBox);
                                     lasers = diagonals;
                                     lasers.insert(lasers.end(), grid.begin(), grid.end());
-                                    knight.spawn(battleBox); // Spawn a new knight
+                                    knight.spawn(battleBox, random); // Spawn a new knight
                                 }
                                 break;
                         }
@@ -1487,6 +1560,12 @@ bool runRound(int round, int initialHP) {
             }
         }
 
+        if (rewindEnabled()) {
+            if (SnapshotBuffer* snapshot = history.capture()) save(*snapshot);
+        }
+
+        // Lasers sweep across the border, so it is repainted every frame
+        battleBox.setNeedsRedraw();
         battleBox.draw();
 
         if ((round == 6 || round == 7) && inAttackCycle && knight.isActive()) {
@@ -1502,12 +1581,12 @@ bool runRound(int round, int initialHP) {
         }
         heart.draw();
 
-        drawHealthBar(2, maxY - 4, 10, heart.getHP());
+        healthBar.show(2, maxY - 4, 10, heart.getHP());
 
-        mvprintw(2, 2, "Round: %d/7", round);
+        roundLabel.show(2, 2, 0, "Round: %d/7", round);
 
-        refresh();
-        usleep(16667);  // ~60 fps timing
+        presentFrame();
+        frameTimer.wait();  // 60 fps timing
         lastHeartHP = heart.getHP();
     }
 
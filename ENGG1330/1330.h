@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <deque>
+#include "hud.h"
 
 enum class LaserDirection {
     HORIZONTAL,
@@ -19,7 +20,6 @@ enum class LaserDirection {
 };
 
 class Heart;
-class BattleBox;
 class Snake;
 class Laser;
 class Knight;
@@ -0,0 +1,80 @@
+#include "dialogue.h"
+#include "present.h"
+#include <string>
+
+void showGameIntroduction() {
+    clear();
+    
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Game Master", 100, true);
+    animator.loadDialogues("1330_dialogue.txt");
+    
+    for (int i = 0; i < 8; i++) {
+        clear();
+        animator.showDialogue(i);
+    }
+
+    // Offer to go over the rules again
+    ScriptVariables start = { 10, 0, 0 };
+    animator.runScript("rules_check", start);
+    clear();
+    maxY++;
+    maxY--;
+}
+
+void showRoundInfo(int round) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Game Master", 80, true);
+    animator.loadDialogues("1330_dialogue.txt");
+    
+    animator.showDialogue(7 + round);
+    maxY++;
+    maxY--;
+}
+
+void showRoundComplete(int round, bool success, int hp) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Game Master", 80, true);
+    animator.loadDialogues("1330_dialogue.txt");
+    
+    if (success) {
+        animator.showDialogue(14 + round);
+
+        // A word on how the round went
+        ScriptVariables variables = { hp, round, 0 };
+        animator.runScript("after_round", variables);
+    }
+    maxY++;
+    maxY--;
+}
+
+void gameOver(bool won, int finalRound) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dialogWidth = maxX * 3/4;
+    
+    TextAnimator animator(dialogWidth, "Game Master", 80, true);
+    animator.loadDialogues("1330_dialogue.txt");
+    
+    if (won) {
+        animator.showDialogue(22);
+    } else {
+        std::string text = animator.getDialogue(23);
+        size_t pos = text.find("ROUND");
+        if (pos != std::string::npos) {
+            text.replace(pos, 5, std::to_string(finalRound));
+        }
+        animator.animateText(text);
+    }
+    maxY++;
+    maxY--;
+}
\ No newline at end of file
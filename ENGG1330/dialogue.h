@@ -0,0 +1,15 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+// ENGG1330 intro, round and ending dialogue. The dialogue box itself is the
+// engine's TextAnimator; the branching parts are scripts in
+// 1330_dialogue.txt.
+
+#include "text_animator.h"
+
+void showGameIntroduction();
+void showRoundInfo(int round);
+void showRoundComplete(int round, bool success, int hp);  // hp carried into the next round
+void gameOver(bool won, int finalRound);
+
+#endif // DIALOGUE_H
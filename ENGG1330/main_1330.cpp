@@ -1,34 +1,32 @@
 #include "1330.h"
-#include "text_animator.h"
+#include "dialogue.h"
+#include "present.h"
+#include "random.h"
+#include "screen.h"
+#include "stage_result.h"
 #include <ncursesw/ncurses.h>
 
 int main() {
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    nodelay(stdscr, TRUE);
+    // Initialize ncurses once, with non-blocking input for the rounds;
+    // dialogues put it back the way they found it
+    initScreen(true);
     
     // Initialize random seed
-    srand(static_cast<unsigned int>(time(nullptr)));
+    seedRandom();
     
-    // Set up colors
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);
-        init_pair(3, COLOR_CYAN, COLOR_BLACK);
-        init_pair(4, COLOR_YELLOW, COLOR_BLACK);
-        init_pair(5, COLOR_GREEN, COLOR_BLACK);
-        init_pair(6, COLOR_BLUE, COLOR_BLACK);
-        init_pair(7, COLOR_WHITE, COLOR_BLACK);
-    }
+    // Set up colors for the whole game
+    PaletteScope palette({
+        {1, COLOR_RED, COLOR_BLACK},
+        {2, COLOR_GREEN, COLOR_BLACK},
+        {3, COLOR_CYAN, COLOR_BLACK},
+        {4, COLOR_YELLOW, COLOR_BLACK},
+        {5, COLOR_GREEN, COLOR_BLACK},
+        {6, COLOR_BLUE, COLOR_BLACK},
+        {7, COLOR_WHITE, COLOR_BLACK},
+    });
     
     // Show game introduction
     showGameIntroduction();
-    nodelay(stdscr, TRUE); // Reset nodelay after animation
     
     // Main game loop
     bool gameWon = true;
@@ -40,10 +38,11 @@ int main() {
         
         // Show dialogue
         showRoundInfo(round);
-        nodelay(stdscr, TRUE); // Reset nodelay after animation
         
-        clear();
-        refresh();
+        // erase() rather than clear(): only the cells that changed are
+        // sent. Not presented: the round's first frame replaces the
+        // dialogue directly.
+        erase();
         
         // Run the round with the current HP
         bool roundSuccess = runRound(round, currentHP);
@@ -52,15 +51,15 @@ int main() {
         currentHP = getLastHP(); // Get the updated HP after the round
         
         if (roundSuccess) {
-            showRoundComplete(round, true);
-            nodelay(stdscr, TRUE); // Reset nodelay after animation
+            showRoundComplete(round, true, currentHP);
         } else {
             gameWon = false;
             break;
         }
     }
     
-    // Show ending
+    // Report to the launcher (this stage has no score), then show ending
+    reportStageOutcome(gameWon, finalRound, currentHP, 0);
     gameOver(gameWon, finalRound);
     
     // Clean up
@@ -2,927 +2,693 @@
 #include <unistd.h>
 #include <cmath>
 #include <cstring>
+#include <cstdio>
 #include <vector>
 #include <random>
 #include <memory>
 #include <ctime>
 #include <algorithm>
+#include "present.h"
+#include "hud.h"
+#include "frame_timer.h"
+#include "input.h"
+#include "random.h"
+#include "screen.h"
+#include "round_table.h"
+#include "lookup_tables.h"
+#include "fixed_point.h"
+#include "snapshot_ring.h"
+#include "entity_store.h"
+#include "terminal_graphics.h"
+#include "1340.h"
+
+// Entity kinds, named for their Palette entries
+class Laser;
+class Spaceship;
+class Projectile;
+class Bomb;
+
+// Colour of each entity type (pairs are set up in main)
+template <> struct Palette<Heart> {
+    static constexpr chtype attr = COLOR_PAIR(1);       // Red heart
+    static constexpr chtype flashAttr = COLOR_PAIR(2);  // Yellow while invincible
+};
+template <> struct Palette<Laser> { static constexpr chtype attr = COLOR_PAIR(3); };       // Cyan
+template <> struct Palette<Spaceship> { static constexpr chtype attr = COLOR_PAIR(4); };   // Blue
+template <> struct Palette<Projectile> { static constexpr chtype attr = COLOR_PAIR(5); };  // Green
+template <> struct Palette<Bomb> { static constexpr chtype attr = COLOR_PAIR(6); };        // Magenta
+
+GameObject::GameObject(Fixed startX, Fixed startY, Fixed dx, Fixed dy, Fixed spd, int sym) :
+    x(startX), y(startY), 
+    cellX(startX.cell()),
+    cellY(startY.cell()),
+    lastDrawnX(cellX), lastDrawnY(cellY),
+    directionX(dx), directionY(dy),
+    speed(spd), symbol(sym), active(true) {}
+
+void GameObject::update() {
+    // Move in the current direction
+    x += directionX * speed;
+    y += directionY * speed;
+    updateCell();
+}
 
-// Game constants
-const int INITIAL_PLAYER_HEALTH = 10;
-const int LASER_DAMAGE = 1;
-const int SPACESHIP_DAMAGE = 1;
-const int BOMB_DAMAGE = 1;
-const float PROJECTILE_SPEED = 0.5f;
-const float SPACESHIP_SPEED = 0.1f;
-const float BOMB_SPEED = 0.2f;
-const float LASER_SPEED = 0.8f;
-const int SCORE_PER_SPACESHIP = 100;
-const int SCORE_PER_PROJECTILE = 10;
-const int SCORE_PER_BOMB = 50;
-
-class GameObject {
-protected:
-    float x, y;           // Position with floating-point precision
-    int lastDrawnX, lastDrawnY; // Last position where object was drawn
-    float directionX, directionY; // Direction vector (normalized)
-    float speed;          // Movement speed
-    int symbol;           // Symbol to represent the object
-    bool active;          // Whether the object is active/alive
-
-public:
-    GameObject(float startX, float startY, float dx, float dy, float spd, int sym) : 
-        x(startX), y(startY), 
-        lastDrawnX(static_cast<int>(round(startX))), 
-        lastDrawnY(static_cast<int>(round(startY))),
-        directionX(dx), directionY(dy),
-        speed(spd), symbol(sym), active(true) {}
-    
-    virtual ~GameObject() = default;
+// Rounded once per move, so drawing and the collision loops compare ints
+void GameObject::updateCell() {
+    cellX = x.cell();
+    cellY = y.cell();
+}
 
-    virtual void update() {
-        // Move in the current direction
-        x += directionX * speed;
-        y += directionY * speed;
-    }
+void GameObject::clearPrevious() {
+    // Clear the previous position
+    mvaddch(lastDrawnY, lastDrawnX, ' ');
+}
 
-    void clearPrevious() {
-        // Clear the previous position
-        mvaddch(lastDrawnY, lastDrawnX, ' ');
-    }
+// Shift by whole cells when the layout moves, keeping the last drawn
+// position in step so nothing is erased at the old place
+void GameObject::translate(int dx, int dy) {
+    x += dx;
+    y += dy;
+    cellX += dx;
+    cellY += dy;
+    lastDrawnX += dx;
+    lastDrawnY += dy;
+}
 
-    virtual void draw() {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
-        
-        // Only redraw if position has changed
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            // Clear previous position if it's different
-            clearPrevious();
-            
-            // Draw at new position
-            mvaddch(currentY, currentX, symbol);
-            
-            // Update last drawn position
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            // Redraw at same position (in case it was overwritten)
-            mvaddch(currentY, currentX, symbol);
-        }
+// Draws glyph (symbol and attributes) at the current cell, clearing the
+// previous one if the object moved. Redrawn every frame in case
+// something else overwrote it.
+void GameObject::drawCell(chtype glyph) {
+    if (cellX != lastDrawnX || cellY != lastDrawnY) {
+        clearPrevious();
+        lastDrawnX = cellX;
+        lastDrawnY = cellY;
     }
+    mvaddch(cellY, cellX, glyph);
+}
 
-    float getX() const { return x; }
-    float getY() const { return y; }
-    bool isActive() const { return active; }
-    void setActive(bool state) { 
-        if (active && !state) {
-            // If turning from active to inactive, clear from screen
-            clearPrevious();
-        }
-        active = state; 
-    }
-    void deactivate() {
+void GameObject::draw() {
+    drawCell(symbol);
+}
+
+Fixed GameObject::getX() const { return x; }
+Fixed GameObject::getY() const { return y; }
+bool GameObject::isActive() const { return active; }
+void GameObject::setActive(bool state) {
+    if (active && !state) {
+        // If turning from active to inactive, clear from screen
         clearPrevious();
-        refresh();
-    }
-    
-    // Check collision with another game object
-    bool collidesWith(const GameObject& other) const {
-        int thisX = static_cast<int>(round(x));
-        int thisY = static_cast<int>(round(y));
-        int otherX = static_cast<int>(round(other.x));
-        int otherY = static_cast<int>(round(other.y));
-        
-        return (thisX == otherX && thisY == otherY);
     }
-};
+    active = state; 
+}
+// Erased now, shown with the rest of the frame
+void GameObject::deactivate() {
+    clearPrevious();
+}
 
-class Heart : public GameObject {
-private:
-    float aspectRatio;    // Character aspect ratio (width/height)
-    bool moving;          // Whether the heart is moving
-    int health;           // Player health
-    int score;            // Player score
-    int invincibilityFrames; // Frames of invincibility after taking damage
-
-public:
-    Heart(int startX, int startY) : 
-        GameObject(static_cast<float>(startX), static_cast<float>(startY), 0.0f, 0.0f, 0.3f, ACS_DIAMOND),
-        aspectRatio(2.0f), moving(false), health(INITIAL_PLAYER_HEALTH), score(0), invincibilityFrames(0) {}
-
-    void update() override {
-        if (moving) {
-            // Move in the current direction with aspect ratio compensation
-            // Horizontal movement is sped up by the aspect ratio
-            x += directionX * speed * aspectRatio;
-            // Vertical movement stays at base speed
-            y += directionY * speed;
-        }
-        
-        // Decrease invincibility frames if player is invincible
-        if (invincibilityFrames > 0) {
-            invincibilityFrames--;
-        }
-    }
+// Check collision with another game object
+bool GameObject::collidesWith(const GameObject& other) const {
+    return cellX == other.cellX && cellY == other.cellY;
+}
 
-    void draw() override {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
-        
-        // Only redraw if position has changed
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            // Clear previous position if it's different
-            clearPrevious();
-            
-            // Draw at new position with appropriate color
-            if (invincibilityFrames > 0 && invincibilityFrames % 2 == 0) {
-                // Flashing effect during invincibility
-                attron(COLOR_PAIR(2)); // Yellow for invincibility
-            } else {
-                attron(COLOR_PAIR(1)); // Red heart color
-            }
-            
-            mvaddch(currentY, currentX, symbol);
-            
-            if (invincibilityFrames > 0 && invincibilityFrames % 2 == 0) {
-                attroff(COLOR_PAIR(2));
-            } else {
-                attroff(COLOR_PAIR(1));
-            }
-            
-            // Update last drawn position
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            // Redraw at same position (in case it was overwritten)
-            if (invincibilityFrames > 0 && invincibilityFrames % 2 == 0) {
-                attron(COLOR_PAIR(2));
-            } else {
-                attron(COLOR_PAIR(1));
-            }
-            
-            mvaddch(currentY, currentX, symbol);
-            
-            if (invincibilityFrames > 0 && invincibilityFrames % 2 == 0) {
-                attroff(COLOR_PAIR(2));
-            } else {
-                attroff(COLOR_PAIR(1));
-            }
-        }
-    }
+// Rewind support: position and direction; subclasses add their counters
+void GameObject::save(SnapshotBuffer& out) const {
+    out.put(x, y, directionX, directionY, speed, active);
+}
 
-    void setDirection(float dx, float dy) {
-        // Set a new direction vector
-        if (dx != 0.0f || dy != 0.0f) {
-            // Normalize the direction vector
-            float length = sqrt(dx * dx + dy * dy);
-            directionX = dx / length;
-            directionY = dy / length;
-            moving = true;  // Start moving when a direction is set
-        }
-    }
-    
-    void setAspectRatio(float ratio) {
-        aspectRatio = ratio;
-    }
-    
-    void stop() {
-        moving = false;
-    }
-    
-    void start() {
-        moving = true;
+void GameObject::restore(SnapshotBuffer& in) {
+    in.get(x, y, directionX, directionY, speed, active);
+    updateCell();
+    lastDrawnX = cellX;
+    lastDrawnY = cellY;
+}
+
+Heart::Heart(int startX, int startY) :
+    GameObject(startX, startY, 0, 0, Fixed(0.3f), ACS_DIAMOND),
+    aspectRatio(2), moving(false), health(INITIAL_PLAYER_HEALTH), score(0), invincibilityFrames(0) {}
+
+void Heart::update() {
+    if (moving) {
+        // Move in the current direction with aspect ratio compensation
+        // Horizontal movement is sped up by the aspect ratio
+        x += directionX * speed * aspectRatio;
+        // Vertical movement stays at base speed
+        y += directionY * speed;
+        updateCell();
     }
     
-    bool isMoving() const {
-        return moving;
+    // Decrease invincibility frames if player is invincible
+    if (invincibilityFrames > 0) {
+        invincibilityFrames--;
     }
+}
 
-    void setPosition(float newX, float newY) {
-        x = newX;
-        y = newY;
-    }
+void Heart::draw() {
+    // Flashing effect during invincibility
+    const chtype colours[2] = { Palette<Heart>::attr, Palette<Heart>::flashAttr };
+    bool flash = invincibilityFrames > 0 && invincibilityFrames % 2 == 0;
+    drawCell(symbol | colours[flash]);
+}
 
-    void takeDamage(int amount) {
-        if (invincibilityFrames <= 0) {
-            health -= amount;
-            if (health < 0) health = 0;
-            invincibilityFrames = 30; // About half a second at 60FPS
-        }
+void Heart::setDirection(Fixed dx, Fixed dy) {
+    // Set a new direction vector
+    if (dx != 0 || dy != 0) {
+        // Normalize the direction vector
+        FixedVec2 direction = FixedVec2(dx, dy).normalized();
+        directionX = direction.x;
+        directionY = direction.y;
+        moving = true;  // Start moving when a direction is set
     }
-    
-    void addScore(int amount) {
-        score += amount;
-    }
-    
-    int getHealth() const { return health; }
-    int getScore() const { return score; }
-    float getAspectRatio() const { return aspectRatio; }
-    bool isInvincible() const { return invincibilityFrames > 0; }
-    float getDirectionX() const { return directionX; }
-    float getDirectionY() const { return directionY; }
-};
+}
 
-class Laser : public GameObject {
-public:
-    Laser(float startX, float startY, float dx, float dy) :
-        GameObject(startX, startY, dx, dy, LASER_SPEED, '-') {}
-    
-    void draw() override {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
-        
-        // Only redraw if position has changed
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            clearPrevious();
-            
-            // Draw with cyan color
-            attron(COLOR_PAIR(3)); // Cyan for laser
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(3));
-            
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            attron(COLOR_PAIR(3));
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(3));
-        }
+void Heart::setAspectRatio(Fixed ratio) {
+    aspectRatio = ratio;
+}
+
+void Heart::stop() {
+    moving = false;
+}
+
+void Heart::start() {
+    moving = true;
+}
+
+bool Heart::isMoving() const { return moving; }
+
+void Heart::setPosition(Fixed newX, Fixed newY) {
+    x = newX;
+    y = newY;
+    updateCell();
+}
+
+void Heart::takeDamage(int amount) {
+    if (invincibilityFrames <= 0) {
+        health -= amount;
+        if (health < 0) health = 0;
+        invincibilityFrames = 30; // About half a second at 60FPS
     }
+}
+
+void Heart::addScore(int amount) {
+    score += amount;
+}
+
+int Heart::getHealth() const { return health; }
+int Heart::getScore() const { return score; }
+Fixed Heart::getAspectRatio() const { return aspectRatio; }
+bool Heart::isInvincible() const { return invincibilityFrames > 0; }
+Fixed Heart::getDirectionX() const { return directionX; }
+Fixed Heart::getDirectionY() const { return directionY; }
+
+void Heart::save(SnapshotBuffer& out) const {
+    GameObject::save(out);
+    out.put(aspectRatio, moving, health, score, invincibilityFrames);
+}
+
+void Heart::restore(SnapshotBuffer& in) {
+    GameObject::restore(in);
+    in.get(aspectRatio, moving, health, score, invincibilityFrames);
+}
+
+// Everything but the heart lives in an EntityPool per kind, described here.
+// Lasers hit ships, projectiles and bombs; the others hit the heart.
+const EntityKind LASER_KIND = {
+    POSITION | VELOCITY | GLYPH | COLLIDER, '-' | Palette<Laser>::attr, LASER_SPEED,
+    { LASER_DAMAGE, 0, 1 }, 0, 0
+};
+const EntityKind SPACESHIP_KIND = {
+    POSITION | VELOCITY | GLYPH | COLLIDER | COOLDOWN, 'C' | Palette<Spaceship>::attr, SPACESHIP_SPEED,
+    { SPACESHIP_DAMAGE, SCORE_PER_SPACESHIP, 1 }, 0, 120
+};
+const EntityKind PROJECTILE_KIND = {
+    POSITION | VELOCITY | GLYPH | COLLIDER, '+' | Palette<Projectile>::attr, PROJECTILE_SPEED,
+    { 1, SCORE_PER_PROJECTILE, 1 }, 0, 0
+};
+// Bombs fall for about two seconds at 60 FPS
+const EntityKind BOMB_KIND = {
+    POSITION | VELOCITY | GLYPH | COLLIDER | LIFETIME, 'O' | Palette<Bomb>::attr, BOMB_SPEED,
+    { BOMB_DAMAGE, SCORE_PER_BOMB, 1 }, 120, 0
 };
 
-class Spaceship : public GameObject {
-private:
-    int health;
-    int fireCooldown;
-    int maxFireCooldown;
-    bool reachedLeftEdge;
-
-public:
-    Spaceship(float startX, float startY, float dx, float dy) :
-        GameObject(startX, startY, dx, dy, SPACESHIP_SPEED, 'C'),
-        health(1),
-        fireCooldown(0),
-        maxFireCooldown(120),
-        reachedLeftEdge(false) {}
-    
-    void update() override {
-        GameObject::update();
-        //Decrease cooldown if active
-        if (fireCooldown > 0){
-            fireCooldown--;
-        }
-    }
+// Difficulty of each round, edited in 1340_rounds.txt. A reload swaps in a
+// whole new table; rounds read their settings once, when they are built.
+static std::shared_ptr<const RoundTable> roundTable;
+
+bool loadRoundTable() {
+    std::shared_ptr<RoundTable> table = std::make_shared<RoundTable>();
+    if (!table->load("1340_rounds.bin", "1340_rounds.txt", {
+            { "spaceship_spawn_interval", -1, 100000 },
+            { "bomb_spawn_interval", -1, 100000 },
+            { "max_enemies", 0, 100 } })) {
+        std::fprintf(stderr, "%s\n", table->error().c_str());
+        return false;
+    }
+    roundTable = table;
+    return true;
+}
 
-    bool canFire() const {
-        return fireCooldown <= 0;
-    }
+SpaceBattleRound::SpaceBattleRound(int roundNumber, int playerHealth, int maxX, int maxY) :
+    round(roundNumber), battleBox(maxX/2 - 20, maxY/2 - 8, 40, 16), heart(maxX/2, maxY/2),
+    spaceships(SPACESHIP_KIND), projectiles(PROJECTILE_KIND), bombs(BOMB_KIND), lasers(LASER_KIND),
+    frameCount(0), running(true), gameOver(false), resultCode(0) {
 
-    void resetFireCoolDown() {
-        fireCooldown = maxFireCooldown;
-    }
+    // Set difficulty based on round number (-1 bomb interval = no bombs)
+    spaceshipSpawnInterval = roundTable->getInt(round, "spaceship_spawn_interval");
+    bombSpawnInterval = roundTable->getInt(round, "bomb_spawn_interval");
+    maxEnemies = roundTable->getInt(round, "max_enemies");
 
-    void draw() override {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
-        
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            clearPrevious();
-            
-            // Draw with blue color
-            attron(COLOR_PAIR(4)); // Blue for spaceships
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(4));
-            
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            attron(COLOR_PAIR(4));
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(4));
-        }
-    }
-    
-    void takeDamage(int amount) {
-        health -= amount;
-        if (health <= 0) {
-            active = false;
+    // Room for as many ships and bombs as the round allows at once
+    spaceships.reserve(maxEnemies);
+    bombs.reserve(maxEnemies / 2);
+
+    // Initialize heart with passed health and score values
+    // Reset health to the passed value (carefully handling invincibility frames)
+    heart.takeDamage(INITIAL_PLAYER_HEALTH - playerHealth);
+}
+
+// Draw the static elements once. The round may have been built before
+// its dialogue, so it is centred on the screen as it is now.
+void SpaceBattleRound::begin() {
+    recentre();
+    battleBox.draw();
+}
+
+// Re-centre the box and shift everything in it by the same amount
+void SpaceBattleRound::recentre() {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int dx = maxX/2 - battleBox.getWidth()/2 - battleBox.getX();
+    int dy = maxY/2 - battleBox.getHeight()/2 - battleBox.getY();
+
+    battleBox.moveTo(battleBox.getX() + dx, battleBox.getY() + dy);
+    heart.translate(dx, dy);
+    lasers.translate(dx, dy);
+    spaceships.translate(dx, dy);
+    projectiles.translate(dx, dy);
+    bombs.translate(dx, dy);
+}
+
+// Follow a terminal resize: re-centre and repaint the whole screen once
+void SpaceBattleRound::relayout() {
+    recentre();
+    clear();
+    battleBox.draw();
+    stats.invalidate();
+    healthBar.invalidate();
+}
+
+// Rewind support: the whole battle, random generator included
+void SpaceBattleRound::save(SnapshotBuffer& out) const {
+    out.put(battleBox, frameCount, random);
+    heart.save(out);
+    spaceships.save(out);
+    projectiles.save(out);
+    bombs.save(out);
+    lasers.save(out);
+}
+
+void SpaceBattleRound::restore(SnapshotBuffer& in) {
+    in.get(battleBox, frameCount, random);
+    heart.restore(in);
+    spaceships.restore(in);
+    projectiles.restore(in);
+    bombs.restore(in);
+    lasers.restore(in);
+
+    // Back in place for the current terminal size, repainted
+    relayout();
+}
+
+// The battle box in pixels for YEAR1_GRAPHICS terminals: the same world,
+// each entity at its sub-cell position. The canvas covers the inside of
+// the border.
+void SpaceBattleRound::rasterise(PixelCanvas& canvas) const {
+    int cellWidth = canvas.getCellWidth();
+    int cellHeight = canvas.getCellHeight();
+    Fixed left = battleBox.getInnerMinX();
+    Fixed top = battleBox.getInnerMinY();
+    auto pixelAt = [&](Fixed x, Fixed y, int& px, int& py) {
+        px = canvas.pixelX(x - left);
+        py = canvas.pixelY(y - top);
+    };
+    int px, py;
+
+    canvas.clear(colourPixel(COLOR_BLACK));
+    Pixel colour = pairPixel(Palette<Laser>::attr);
+    for (int i = 0; i < lasers.size(); i++) {
+        if (!lasers.isAlive(i)) continue;
+        pixelAt(lasers.position[i].x, lasers.position[i].y, px, py);
+        canvas.blendRect(px - cellWidth, py - cellHeight / 4, 2 * cellWidth, cellHeight / 2,
+                         withAlpha(colour, 80));
+        canvas.fillRect(px - cellWidth / 2, py - 1, cellWidth, 2, colour);
+    }
+    colour = pairPixel(Palette<Spaceship>::attr);
+    for (int i = 0; i < spaceships.size(); i++) {
+        if (!spaceships.isAlive(i)) continue;
+        pixelAt(spaceships.position[i].x, spaceships.position[i].y, px, py);
+        canvas.fillRect(px - cellWidth / 2, py - cellHeight / 8, cellWidth, cellHeight / 4, colour);
+        canvas.fillDisc(px, py, cellWidth / 3, colour);
+    }
+    colour = pairPixel(Palette<Projectile>::attr);
+    for (int i = 0; i < projectiles.size(); i++) {
+        if (!projectiles.isAlive(i)) continue;
+        pixelAt(projectiles.position[i].x, projectiles.position[i].y, px, py);
+        canvas.fillDisc(px, py, cellWidth / 5, colour);
+    }
+    colour = pairPixel(Palette<Bomb>::attr);
+    for (int i = 0; i < bombs.size(); i++) {
+        if (!bombs.isAlive(i)) continue;
+        pixelAt(bombs.position[i].x, bombs.position[i].y, px, py);
+        canvas.blendRect(px - cellWidth, py - cellHeight / 2, 2 * cellWidth, cellHeight,
+                         withAlpha(colour, 64));
+        canvas.fillDisc(px, py, cellWidth / 2, colour);
+    }
+
+    // Flashes while invincible, like the glyph
+    bool flash = heart.isInvincible() && frameCount % 2 == 0;
+    pixelAt(heart.getX(), heart.getY(), px, py);
+    canvas.fillDiamond(px, py, cellWidth / 2, cellHeight / 3,
+                       pairPixel(flash ? Palette<Heart>::flashAttr : Palette<Heart>::attr));
+}
+
+// Process input, update and draw one frame (without refreshing).
+// Returns false once the round has ended.
+bool SpaceBattleRound::step() {
+    // Process all available input
+    int ch;
+    while ((ch = getch()) != ERR) {
+        if (ch == 'q' || ch == 'Q') {
+            running = false;
+            break;
+        } else if (ch == ' ') {
+            // Space toggles movement
+            if (heart.isMoving()) {
+                heart.stop();
+            } else {
+                heart.start();
+            }
+        } else if (ch == KEY_UP) {
+            heart.setDirection(0, -1);  // Up
+        } else if (ch == KEY_DOWN) {
+            heart.setDirection(0, 1);   // Down
+        } else if (ch == KEY_LEFT) {
+            heart.setDirection(-1, 0);  // Left
+        } else if (ch == KEY_RIGHT) {
+            heart.setDirection(1, 0);   // Right
+        } else if (ch == KEY_RESIZE) {
+            relayout();
+        } else if (rewindEnabled() && isRewindKey(ch)) {
+            if (SnapshotBuffer* snapshot = history.rewind()) restore(*snapshot);
+        } else if (ch == 'f' || ch == 'F') {
+            // Fire a laser to the right
+            lasers.spawn(heart.getX(), heart.getY(), FixedVec2(1, 0));
         }
     }
-    
-    // Check if spaceship has reached left edge
-    bool hasReachedLeft(int leftEdge) const {
-        return static_cast<int>(round(x)) <= leftEdge && !reachedLeftEdge;
-    }
-    
-    void markReachedLeftEdge() {
-        reachedLeftEdge = true;
-    }
-    
-    int getHealth() const { return health; }
-};
 
-class Projectile : public GameObject {
-public:
-    Projectile(float startX, float startY, float dx, float dy) :
-        GameObject(startX, startY, dx, dy, PROJECTILE_SPEED, '+') {}
-        
-    void draw() override {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
-        
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            clearPrevious();
-            
-            // Draw with green color
-            attron(COLOR_PAIR(5)); // Green for projectiles
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(5));
-            
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            attron(COLOR_PAIR(5));
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(5));
+    // Update heart position
+    heart.update();
+
+    // Boundary checking to keep heart inside the battle box
+    Fixed heartX = heart.getX();
+    Fixed heartY = heart.getY();
+
+    // Constrain position
+    if (heartX < battleBox.getX() + 1) {
+        heart.setPosition(battleBox.getX() + 1, heartY);
+    }
+    if (heartX > battleBox.getX() + battleBox.getWidth() - 1) {
+        heart.setPosition(battleBox.getX() + battleBox.getWidth() - 1, heartY);
+    }
+    if (heartY < battleBox.getY() + 1) {
+        heart.setPosition(heartX, battleBox.getY() + 1);
+    }
+    if (heartY > battleBox.getY() + battleBox.getHeight() - 1) {
+        heart.setPosition(heartX, battleBox.getY() + battleBox.getHeight() - 1);
+    }
+
+    // Spawn new enemies at regular intervals
+    frameCount++;
+    // Spawn new enemies at regular intervals
+    if (spaceshipSpawnInterval > 0 && frameCount % spaceshipSpawnInterval == 0 && 
+        spaceships.size() < maxEnemies) {
+        Fixed startX, startY;
+        Fixed dirX, dirY;
+    
+        // Start from right edge
+        startX = battleBox.getX() + battleBox.getWidth() - 1;
+        // Random Y position
+        startY = random.nextInt(battleBox.getY() + 1, battleBox.getY() + battleBox.getHeight() - 2);
+    
+        // Always move left (negative X direction)
+        dirX = -1;
+    
+        // Calculate maximum allowed vertical movement to ensure reaching left edge
+        // Distance to left edge
+        Fixed distanceToLeftEdge = startX - (battleBox.getX() + 1);
+        // Distance to top edge (how far we can go up)
+        Fixed distanceToTopEdge = startY - (battleBox.getY() + 1);
+        // Distance to bottom edge (how far we can go down)
+        Fixed distanceToBottomEdge = (battleBox.getY() + battleBox.getHeight() - 1) - startY;
+    
+        // Maximum allowed vertical movement per horizontal unit to reach left edge
+        Fixed maxUpSlope = distanceToTopEdge / distanceToLeftEdge;
+        Fixed maxDownSlope = distanceToBottomEdge / distanceToLeftEdge;
+    
+        // Random vertical direction within bounds that ensure reaching left edge
+        Fixed verticalRange = min(maxUpSlope, 1) + min(maxDownSlope, 1);
+        Fixed normalizedPosition = Fixed::fromRaw(random.nextInt(0, Fixed::ONE - 1)); // 0.0 to 1.0
+    
+        // Convert to range from -maxUpSlope to +maxDownSlope
+        dirY = -min(maxUpSlope, 1) + normalizedPosition * verticalRange;
+    
+        // Normalize the direction vector
+        FixedVec2 direction = FixedVec2(dirX, dirY).normalized();
+        dirX = direction.x;
+        dirY = direction.y;
+    
+        // Create the spaceship
+        spaceships.spawn(startX, startY, FixedVec2(dirX, dirY));
+    }
+    // Separately spawn bombs randomly from the top, not in round 1
+    if (bombSpawnInterval > 0 && frameCount % bombSpawnInterval == 0 && 
+        bombs.size() < maxEnemies / 2) {
+        // Random x position along the top of the battle box
+        Fixed bombX = random.nextInt(battleBox.getX() + 1, battleBox.getX() + battleBox.getWidth() - 2);
+        Fixed bombY = battleBox.getY() + 1; // Start at the top
+    
+        bombs.spawn(bombX, bombY, FixedVec2(0, 1));
+    }
+
+    // Randomly fire projectiles from spaceships
+    for (int i = 0; i < spaceships.size(); i++) {
+        Cooldown& cooldown = spaceships.cooldown[i];
+        if (spaceships.isAlive(i) && cooldown.ticks <= 0 && random.nextInt(0, 49) == 0) {
+            const Position& ship = spaceships.position[i];
+            // Direction towards player
+            FixedVec2 aim = FixedVec2(heart.getX() - ship.x, heart.getY() - ship.y).normalized();
+        
+            // Add some randomness to aim
+            aim.x += Fixed(random.nextInt(-50, 49)) / 500;
+            aim.y += Fixed(random.nextInt(-50, 49)) / 500;
+        
+            // Normalize again
+            aim = aim.normalized();
+        
+            projectiles.spawn(ship.x, ship.y, aim);
+
+            //Reset cooldown
+            cooldown.ticks = cooldown.reload;
         }
     }
-};
 
-class Bomb : public GameObject {
-private:
-    int timer;
+    // Update all game objects
+    int heartCellX = heart.getX().cell();
+    int heartCellY = heart.getY().cell();
+
+    // Update lasers
+    moveSystem(lasers);
+    cullSystem(lasers, battleBox);
+    for (int i = 0; i < lasers.size(); i++) {
+        if (!lasers.isAlive(i)) continue;
+        const Position& laser = lasers.position[i];
 
-public:
-    Bomb(float startX, float startY) :
-        GameObject(startX, startY, 0.0f, 1.0f, BOMB_SPEED, 'O'),
-        timer(120) {} // About 1 second at 60 FPS
+        // Check for collisions with enemies
+        int ship = spaceships.findAt(laser.cellX, laser.cellY);
+        if (ship >= 0) {
+            lasers.kill(i);
+            Collider& target = spaceships.collider[ship];
+            target.health -= lasers.collider[i].damage;
+            if (target.health <= 0) {
+                spaceships.kill(ship);
+                heart.addScore(target.points);
+            }
+            continue;
+        }
         
-    void update() override {
-        GameObject::update();
-        timer--;
-        if (timer <= 0) {
-            active = false; // Bomb "explodes" and disappears
+        // Check for collisions with projectiles
+        int proj = projectiles.findAt(laser.cellX, laser.cellY);
+        if (proj >= 0) {
+            projectiles.kill(proj);
+            lasers.kill(i);
+            heart.addScore(projectiles.collider[proj].points); // Small score for destroying projectile
+            continue;
         }
-    }
-    
-    void draw() override {
-        int currentX = static_cast<int>(round(x));
-        int currentY = static_cast<int>(round(y));
         
-        if (currentX != lastDrawnX || currentY != lastDrawnY) {
-            clearPrevious();
-            
-            // Draw with magenta color
-            attron(COLOR_PAIR(6)); // Magenta for bombs
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(6));
-            
-            lastDrawnX = currentX;
-            lastDrawnY = currentY;
-        } else {
-            attron(COLOR_PAIR(6));
-            mvaddch(currentY, currentX, symbol);
-            attroff(COLOR_PAIR(6));
+        // Check for collisions with bombs
+        int bomb = bombs.findAt(laser.cellX, laser.cellY);
+        if (bomb >= 0) {
+            bombs.kill(bomb);
+            lasers.kill(i);
+            heart.addScore(bombs.collider[bomb].points); // Medium score for destroying bomb
         }
     }
-    
-    int getTimer() const { return timer; }
-};
 
-class BattleBox {
-private:
-    int x, y;         // Top-left corner position
-    int width, height; // Box dimensions
-    bool needsRedraw;  // Flag to determine if the box needs redrawing
-
-public:
-    BattleBox(int startX, int startY, int w, int h) :
-        x(startX), y(startY), width(w), height(h), needsRedraw(true) {}
-
-    void draw() {
-        if (!needsRedraw) return;
+    // Update spaceships
+    moveSystem(spaceships);
+    cooldownSystem(spaceships);
+    cullSystem(spaceships, battleBox);
+    for (int i = 0; i < spaceships.size(); i++) {
+        if (!spaceships.isAlive(i)) continue;
+        const Position& ship = spaceships.position[i];
         
-        // Enable reverse highlighting
-        attron(A_REVERSE);
-    
-        // Draw the top and bottom borders of the battle box
-        for (int i = -1; i <= width+1; i++) {
-            mvaddch(y, x + i, ' ');              // Top border (space with reverse highlight)
-            mvaddch(y + height, x + i, ' ');     // Bottom border
+        // Check if ship has reached left edge of battlebox
+        if (ship.cellX <= battleBox.getX() + 1) {
+            heart.takeDamage(spaceships.collider[i].damage);
+            spaceships.kill(i);
+            continue;
         }
-    
-        // Draw the left and right borders of the battle box
-        for (int i = 0; i <= height; i++) {
-            mvaddch(y + i, x, ' ');              // Left border
-            mvaddch(y + i, x + width, ' ');      // Right border
-            mvaddch(y + i, x-1, ' ');            // Left border
-            mvaddch(y + i, x+1 + width, ' ');    // Right border
-        }
-    
-        // Disable reverse highlighting
-        attroff(A_REVERSE);
         
-        needsRedraw = false;
+        // Check for collision with player
+        if (ship.cellX == heartCellX && ship.cellY == heartCellY && !heart.isInvincible()) {
+            heart.takeDamage(spaceships.collider[i].damage);
+            spaceships.kill(i);
+        }
     }
 
-    void setNeedsRedraw() {
-        needsRedraw = true;
+    // Update projectiles and bombs: leave the box, expire or hit the player
+    moveSystem(projectiles);
+    moveSystem(bombs);
+    lifetimeSystem(bombs);
+    for (EntityPool* pool : { &projectiles, &bombs }) {
+        cullSystem(*pool, battleBox);
+        for (int i = 0; i < pool->size(); i++) {
+            const Position& at = pool->position[i];
+            if (pool->isAlive(i) && at.cellX == heartCellX && at.cellY == heartCellY && !heart.isInvincible()) {
+                heart.takeDamage(pool->collider[i].damage);
+                pool->kill(i);
+            }
+        }
     }
 
-    // Check if a position is inside the battle box (with a small margin)
-    bool contains(float checkX, float checkY) const {
-        int ix = static_cast<int>(round(checkX));
-        int iy = static_cast<int>(round(checkY));
-        return (ix > x && ix < x + width && iy > y && iy < y + height);
+    // Clean up inactive objects
+    lasers.compact();
+    spaceships.compact();
+    projectiles.compact();
+    bombs.compact();
+
+    if (rewindEnabled()) {
+        if (SnapshotBuffer* snapshot = history.capture()) save(*snapshot);
     }
-    
-    // Check if a position is outside the battle box (with a small margin)
-    bool isOutside(float checkX, float checkY) const {
-        return !contains(checkX, checkY);
+
+    // Check if game over conditions met
+    if (heart.getHealth() <= 0) {
+        gameOver = true;
+        resultCode = -1; // Player died
+    } else if (heart.getScore() >= 2000) {
+        gameOver = true;
+        resultCode = 1;  // Player won (reached score)
     }
 
-    int getX() const { return x; }
-    int getY() const { return y; }
-    int getWidth() const { return width; }
-    int getHeight() const { return height; }
-};
+    // Draw all game objects
+    heart.draw();
 
-void drawHealthBar(int x, int y, int maxHP, int currentHP) {
-    mvprintw(y, x, "HP: %d/%d [", currentHP, maxHP);
-    
-    int barWidth = 20; // Width of the health bar
-    int filledWidth = static_cast<int>((static_cast<float>(currentHP) / maxHP) * barWidth);
+    drawSystem(lasers);
+    drawSystem(spaceships);
+    drawSystem(projectiles);
+    drawSystem(bombs);
+
+    // Display game stats; written again only when they change
+    attron(COLOR_PAIR(7)); // White text
+    stats.show(battleBox.getX(), battleBox.getY() - 2, 0, "Round: %d  Score: %d",
+               round, heart.getScore());
+        
+    // Draw health bar on the line under the score
+    healthBar.show(battleBox.getX(), battleBox.getY() - 1, INITIAL_PLAYER_HEALTH, heart.getHealth());
+
+    attroff(COLOR_PAIR(7));
     
-    for (int i = 0; i < barWidth; i++) {
-        if (i < filledWidth) {
-            attron(COLOR_PAIR(1)); // Red for filled health
-            addch('=');
-            attroff(COLOR_PAIR(1));
-        } else {
-            addch('-');
-        }
-    }
-    addch(']');
+    return running && !gameOver;
 }
 
-// Runs a round of the game with behaviors specific to each round
-std::vector<int> runRound(int round, int playerHealth) {
-    
-    // Define different parameters for each round
-    int spaceship_spawn_interval; 
-    int bomb_spawn_interval;
-    int max_enemies;
-    
-    // Set difficulty based on round number
-    switch(round) {
-        case 1:
-            spaceship_spawn_interval = 60;
-            bomb_spawn_interval = -1; // No bombs in round 1
-            max_enemies = 8;
-            break;
-        case 2:
-            spaceship_spawn_interval = 50; // Faster spawning
-            bomb_spawn_interval = 120;
-            max_enemies = 10;
-            break;
-        case 3:
-            spaceship_spawn_interval = 40; // Even faster spawning
-            bomb_spawn_interval = 60;      // More bombs
-            max_enemies = 12;
-            break;
-        default:
-            spaceship_spawn_interval = 60;
-            bomb_spawn_interval = -1;
-            max_enemies = 8;
-    }
-    
-    // Seed the random number generator
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    nodelay(stdscr, TRUE);  // Non-blocking input
-    
-    // Enable function keys, arrow keys, etc.
-    keypad(stdscr, TRUE);
+// Round summary shown after the round ends
+void SpaceBattleRound::drawResult(int maxX, int maxY) {
+    erase();
+    mvprintw(maxY / 2 - 2, maxX / 2 - 5, "ROUND %d %s", 
+             round, resultCode > 0 ? "COMPLETE" : "FAILED");
+    mvprintw(maxY / 2, maxX / 2 - 10, "Score: %d", heart.getScore());
+    mvprintw(maxY / 2 + 1, maxX / 2 - 10, "Health: %d", heart.getHealth());
+    mvprintw(maxY / 2 + 3, maxX / 2 - 15, "Press ENTER to continue...");
+}
+
+const BattleBox& SpaceBattleRound::getBattleBox() const { return battleBox; }
+bool SpaceBattleRound::isGameOver() const { return gameOver; }
+int SpaceBattleRound::getResultCode() const { return resultCode; }
+int SpaceBattleRound::getHealth() const { return heart.getHealth(); }
+int SpaceBattleRound::getScore() const { return heart.getScore(); }
+
+std::unique_ptr<SpaceBattleRound> prepareRound(int round, int playerHealth) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    return std::unique_ptr<SpaceBattleRound>(new SpaceBattleRound(round, playerHealth, maxX, maxY));
+}
+
+// Plays a round built beforehand, e.g. while its dialogue was showing
+std::vector<int> runRound(SpaceBattleRound& battle) {
     
-    // Set up colors if terminal supports them
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);     // Red heart
-        init_pair(2, COLOR_YELLOW, COLOR_BLACK);  // Yellow for invincibility
-        init_pair(3, COLOR_CYAN, COLOR_BLACK);    // Cyan for laser
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);    // Blue for spaceships
-        init_pair(5, COLOR_GREEN, COLOR_BLACK);   // Green for projectiles
-        init_pair(6, COLOR_MAGENTA, COLOR_BLACK); // Magenta for bombs
-        init_pair(7, COLOR_WHITE, COLOR_BLACK);   // White for text
-    }
+    // The screen and colours set up in main() stay for every round; only
+    // the input is non-blocking while the round plays
+    InputMode input(InputMode::NON_BLOCKING);
 
     // Get terminal dimensions
     int maxY, maxX;
     getmaxyx(stdscr, maxY, maxX);
 
-    // Create battle box and heart
-    BattleBox battleBox(maxX/2 - 20, maxY/2 - 8, 40, 16);
-    Heart heart(maxX/2, maxY/2);
-
-    // Initialize heart with passed health and score values
-    // Reset health to the passed value (carefully handling invincibility frames)
-    heart.takeDamage(INITIAL_PLAYER_HEALTH - playerHealth);
+    battle.begin();
     
-    // Game objects
-    std::vector<std::unique_ptr<Spaceship>> spaceships;
-    std::vector<std::unique_ptr<Projectile>> projectiles;
-    std::vector<std::unique_ptr<Bomb>> bombs;
-    std::vector<std::unique_ptr<Laser>> lasers;
-    
-    // Game state
-    int frameCount = 0;
-    bool gameOver = false;
-    int resultCode = 0;
-    
-    // Draw the static elements once
-    battleBox.draw();
+    // With YEAR1_GRAPHICS the inside of the box is also drawn in pixels:
+    // as half blocks in place of the glyphs, or as an image laid over them
+    GraphicsPresenter graphics(graphicsMode());
+    std::unique_ptr<PixelCanvas> canvas;
+    if (graphicsMode() != GRAPHICS_OFF) {
+        const BattleBox& box = battle.getBattleBox();
+        canvas.reset(newBoxCanvas(graphicsMode(), box.getWidth() - 1, box.getHeight() - 1));
+    }
     
     // Game loop
     bool running = true;
-    while (running && !gameOver) {
-        // Process all available input
-        int ch;
-        while ((ch = getch()) != ERR) {
-            if (ch == 'q' || ch == 'Q') {
-                running = false;
-                break;
-            } else if (ch == ' ') {
-                // Space toggles movement
-                if (heart.isMoving()) {
-                    heart.stop();
-                } else {
-                    heart.start();
-                }
-            } else if (ch == KEY_UP) {
-                heart.setDirection(0.0f, -1.0f);  // Up
-            } else if (ch == KEY_DOWN) {
-                heart.setDirection(0.0f, 1.0f);   // Down
-            } else if (ch == KEY_LEFT) {
-                heart.setDirection(-1.0f, 0.0f);  // Left
-            } else if (ch == KEY_RIGHT) {
-                heart.setDirection(1.0f, 0.0f);   // Right
-            } else if (ch == 'f' || ch == 'F') {
-                float dx = 1.0f;
-                float dy = 0.0f;
-                // Create and add a new laser (replaced make_unique with direct new)
-                lasers.push_back(std::unique_ptr<Laser>(new Laser(
-                    heart.getX(), heart.getY(), dx, dy
-                )));
-            }
-        }
-        
-        // Update heart position
-        heart.update();
-        
-        // Boundary checking to keep heart inside the battle box
-        float heartX = heart.getX();
-        float heartY = heart.getY();
-        
-        // Constrain position
-        if (heartX < battleBox.getX() + 1) {
-            heart.setPosition(static_cast<float>(battleBox.getX() + 1), heartY);
-        }
-        if (heartX > battleBox.getX() + battleBox.getWidth() - 1) {
-            heart.setPosition(static_cast<float>(battleBox.getX() + battleBox.getWidth() - 1), heartY);
-        }
-        if (heartY < battleBox.getY() + 1) {
-            heart.setPosition(heartX, static_cast<float>(battleBox.getY() + 1));
-        }
-        if (heartY > battleBox.getY() + battleBox.getHeight() - 1) {
-            heart.setPosition(heartX, static_cast<float>(battleBox.getY() + battleBox.getHeight() - 1));
-        }
-        
-        // Spawn new enemies at regular intervals
-        frameCount++;
-        // Spawn new enemies at regular intervals
-        if (frameCount % spaceship_spawn_interval == 0 && 
-            static_cast<int>(spaceships.size()) < max_enemies) {
-            float startX, startY;
-            float dirX, dirY;
-            
-            // Start from right edge
-            startX = static_cast<float>(battleBox.getX() + battleBox.getWidth() - 1);
-            // Random Y position
-            startY = static_cast<float>(battleBox.getY() + 1 + std::rand() % (battleBox.getHeight() - 2));
-            
-            // Always move left (negative X direction)
-            dirX = -1.0f;
-            
-            // Calculate maximum allowed vertical movement to ensure reaching left edge
-            // Distance to left edge
-            float distanceToLeftEdge = startX - (battleBox.getX() + 1);
-            // Distance to top edge (how far we can go up)
-            float distanceToTopEdge = startY - (battleBox.getY() + 1);
-            // Distance to bottom edge (how far we can go down)
-            float distanceToBottomEdge = (battleBox.getY() + battleBox.getHeight() - 1) - startY;
-            
-            // Maximum allowed vertical movement per horizontal unit to reach left edge
-            float maxUpSlope = distanceToTopEdge / distanceToLeftEdge;
-            float maxDownSlope = distanceToBottomEdge / distanceToLeftEdge;
-            
-            // Random vertical direction within bounds that ensure reaching left edge
-            float verticalRange = std::min(maxUpSlope, 1.0f) + std::min(maxDownSlope, 1.0f);
-            float normalizedPosition = static_cast<float>(std::rand()) / RAND_MAX; // 0.0 to 1.0
-            
-            // Convert to range from -maxUpSlope to +maxDownSlope
-            dirY = -std::min(maxUpSlope, 1.0f) + normalizedPosition * verticalRange;
-            
-            // Normalize the direction vector
-            float length = std::sqrt(dirX * dirX + dirY * dirY);
-            dirX /= length;
-            dirY /= length;
-            
-            // Create the spaceship (replaced make_unique with direct new)
-            spaceships.push_back(std::unique_ptr<Spaceship>(new Spaceship(startX, startY, dirX, dirY)));
-        }
-        // Separately spawn bombs randomly from the top, not in round 1
-        if (bomb_spawn_interval > 0 && frameCount % bomb_spawn_interval == 0 && 
-            static_cast<int>(bombs.size()) < max_enemies / 2) {
-            // Random x position along the top of the battle box
-            float bombX = static_cast<float>(
-                battleBox.getX() + 1 + std::rand() % (battleBox.getWidth() - 2)
-            );
-            float bombY = static_cast<float>(battleBox.getY() + 1); // Start at the top
-            
-            bombs.push_back(std::unique_ptr<Bomb>(new Bomb(bombX, bombY)));
-        }
-        
-        // Randomly fire projectiles from spaceships
-        for (auto& ship : spaceships) {
-            if (ship->isActive() && ship->canFire() && ::rand() % 50 == 0) {
-                // Direction towards player
-                float dx = heart.getX() - ship->getX();
-                float dy = heart.getY() - ship->getY();
-                float length = std::sqrt(dx * dx + dy * dy);
-                
-                // Add some randomness to aim
-                dx = dx / length + (std::rand() % 100 - 50) / 500.0f;
-                dy = dy / length + (std::rand() % 100 - 50) / 500.0f;
-                
-                // Normalize again
-                length = std::sqrt(dx * dx + dy * dy);
-                dx /= length;
-                dy /= length;
-                
-                projectiles.push_back(std::unique_ptr<Projectile>(new Projectile(
-                    ship->getX(), ship->getY(), dx, dy
-                )));
-
-                //Reset cooldown
-                ship->resetFireCoolDown();
-            }
-        }
-        
-        // Update all game objects
-        
-        // Update lasers
-        for (auto& laser : lasers) {
-            if (laser->isActive()) {
-                laser->update();
-                
-                // Check if laser has left the battle box
-                if (battleBox.isOutside(laser->getX(), laser->getY())) {
-                    laser->setActive(false);
-                    laser->deactivate();
-                    continue;
-                }
-
-                bool collisionDetected = false;
-                
-                // Check for collisions with enemies
-                for (auto& ship : spaceships) {
-                    if (ship->isActive() && laser->collidesWith(*ship)) {
-                        ship->takeDamage(LASER_DAMAGE);
-                        laser->setActive(false);
-                        collisionDetected = true;
-                        if (!ship->isActive()) {
-                            ship->deactivate();
-                            heart.addScore(SCORE_PER_SPACESHIP);
-                        }
-                        break;
-                    }
-                }
-
-                // Skip further checks if laser is no longer active
-                if (!laser->isActive()) continue;
-                // Skip further collision checks if a collision was already detected
-                if (collisionDetected) continue;
-                
-                // Check for collisions with projectiles
-                for (auto& proj : projectiles) {
-                    if (proj->isActive() && laser->collidesWith(*proj)) {
-                        proj->setActive(false);
-                        laser->setActive(false);
-                        heart.addScore(SCORE_PER_PROJECTILE); // Small score for destroying projectile
-                        break;
-                    }
-                }
-                
-                // Skip further checks if laser is no longer active
-                if (!laser->isActive()) continue;
-                // Skip further collision checks if a collision was already detected
-                if (collisionDetected) continue;
-                
-                // Check for collisions with bombs
-                for (auto& bomb : bombs) {
-                    if (bomb->isActive() && laser->collidesWith(*bomb)) {
-                        bomb->setActive(false);
-                        laser->setActive(false);
-                        heart.addScore(SCORE_PER_BOMB); // Medium score for destroying bomb
-                        break;
-                    }
-                }
-            }
-        }
-        
-        // Update spaceships
-        for (auto& ship : spaceships) {
-            if (ship->isActive()) {
-                ship->update();
-                
-                // Check if ship has left the battle box
-                if (battleBox.isOutside(ship->getX(), ship->getY())) {
-                    ship->setActive(false);
-                    continue;
-                }
-                
-                // Check if ship has reached left edge of battlebox
-                if (ship->hasReachedLeft(battleBox.getX() + 1)) {
-                    heart.takeDamage(SPACESHIP_DAMAGE);
-                    ship->markReachedLeftEdge();
-                    ship->setActive(false);
-                    continue;
-                }
-                
-                // Check for collision with player
-                if (ship->collidesWith(heart) && !heart.isInvincible()) {
-                    heart.takeDamage(SPACESHIP_DAMAGE);
-                    ship->setActive(false);
-                }
-            }
+    FrameTimer frameTimer;
+    while (running) {
+        running = battle.step();
+        const BattleBox& box = battle.getBattleBox();
+        if (canvas) battle.rasterise(*canvas);
+        if (canvas && graphicsMode() == GRAPHICS_HALF_BLOCK) {
+            drawHalfBlocks(*canvas, box.getInnerMinX(), box.getInnerMinY());
         }
         
-        // Update projectiles
-        for (auto& proj : projectiles) {
-            if (proj->isActive()) {
-                proj->update();
-                
-                // Check if projectile has left the battle box
-                if (battleBox.isOutside(proj->getX(), proj->getY())) {
-                    proj->setActive(false);
-                    continue;
-                }
-                
-                // Check for collision with player
-                if (proj->collidesWith(heart) && !heart.isInvincible()) {
-                    heart.takeDamage(1);
-                    proj->setActive(false);
-                }
-            }
-        }
-        
-        // Update bombs
-        for (auto& bomb : bombs) {
-            if (bomb->isActive()) {
-                bomb->update();
-                
-                // Check if bomb has left the battle box
-                if (battleBox.isOutside(bomb->getX(), bomb->getY())) {
-                    bomb->setActive(false);
-                    continue;
-                }
-                
-                // Check for collision with player
-                if (bomb->collidesWith(heart) && !heart.isInvincible()) {
-                    heart.takeDamage(BOMB_DAMAGE);
-                    bomb->setActive(false);
-                }
-            }
-        }
-        
-        // Clean up inactive objects - replace auto with explicit types in lambdas
-        lasers.erase(
-            std::remove_if(
-                lasers.begin(), lasers.end(),
-                [](const std::unique_ptr<Laser>& laser) { return !laser->isActive(); }
-            ),
-            lasers.end()
-        );
-        
-        spaceships.erase(
-            std::remove_if(
-                spaceships.begin(), spaceships.end(),
-                [](const std::unique_ptr<Spaceship>& ship) { return !ship->isActive(); }
-            ),
-            spaceships.end()
-        );
-        
-        projectiles.erase(
-            std::remove_if(
-                projectiles.begin(), projectiles.end(),
-                [](const std::unique_ptr<Projectile>& proj) { return !proj->isActive(); }
-            ),
-            projectiles.end()
-        );
-        
-        bombs.erase(
-            std::remove_if(
-                bombs.begin(), bombs.end(),
-                [](const std::unique_ptr<Bomb>& bomb) { return !bomb->isActive(); }
-            ),
-            bombs.end()
-        );
-        
-        // Check if game over conditions met
-        if (heart.getHealth() <= 0) {
-            gameOver = true;
-            resultCode = -1; // Player died
-        } else if (heart.getScore() >= 2000) {
-            gameOver = true;
-            resultCode = 1;  // Player won (reached score)
-        }
-        
-        // Draw all game objects
-        heart.draw();
-        
-        for (auto& laser : lasers) {
-            if (laser->isActive()) {
-                laser->draw();
-            }
-        }
-        
-        for (auto& ship : spaceships) {
-            if (ship->isActive()) {
-                ship->draw();
-            }
-        }
-        
-        for (auto& proj : projectiles) {
-            if (proj->isActive()) {
-                proj->draw();
-            }
-        }
-        
-        for (auto& bomb : bombs) {
-            if (bomb->isActive()) {
-                bomb->draw();
-            }
-        }
-        
-        // Display game stats
-        attron(COLOR_PAIR(7)); // White text
-        mvprintw(battleBox.getY() - 2, battleBox.getX(), "Round: %d  Score: %d", 
-                round, heart.getScore());
-                
-        // Draw health bar on the same line after the score
-        drawHealthBar(battleBox.getX(), battleBox.getY() - 1, INITIAL_PLAYER_HEALTH, heart.getHealth());
-
-        attroff(COLOR_PAIR(7));
-        
         // Refresh screen and control frame rate
-        refresh();
-        usleep(16667);  // ~60 FPS (1,000,000 microseconds / 60)
+        presentFrame();
+        if (canvas) graphics.present(*canvas, box.getInnerMinX(), box.getInnerMinY());
+        frameTimer.wait();  // 60 FPS
     }
+    graphics.hide();
     
     // Game over screen
-    if (gameOver) {
-        clear();
-        mvprintw(maxY / 2 - 2, maxX / 2 - 5, "ROUND %d %s", 
-                 round, resultCode > 0 ? "COMPLETE" : "FAILED");
-        mvprintw(maxY / 2, maxX / 2 - 10, "Score: %d", heart.getScore());
-        mvprintw(maxY / 2 + 1, maxX / 2 - 10, "Health: %d", heart.getHealth());
-        mvprintw(maxY / 2 + 3, maxX / 2 - 15, "Press ENTER to continue...");
-        
-        // Clear the input buffer by reading all pending input
-        nodelay(stdscr, TRUE);  // Non-blocking mode
-        while (getch() != ERR) {
-            // Consume all pending input
-        }
-        // Now wait for the ENTER key specifically
-        nodelay(stdscr, FALSE);  // Blocking mode
-        int ch;
-        do {
-            ch = getch();
-        } while (ch != '\n' && ch != KEY_ENTER && ch != '\r');
+    if (battle.isGameOver()) {
+        battle.drawResult(maxX, maxY);
+        waitForEnter();
     }
 
-    // Clean up
-    endwin();
-    
     // Return the result vector: [resultCode, health, score]
-    std::vector<int> result = {resultCode, heart.getHealth(), heart.getScore()};
+    std::vector<int> result = {battle.getResultCode(), battle.getHealth(), battle.getScore()};
     return result;
 }
\ No newline at end of file
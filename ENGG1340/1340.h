@@ -7,50 +7,64 @@
 #include <random>
 #include <ctime>
 #include <cmath>
+#include "hud.h"
+#include "fixed_point.h"
+#include "snapshot_ring.h"
+#include "random.h"
+#include "entity_store.h"
+#include "pixel_canvas.h"
 
 // Game constants
 const int INITIAL_PLAYER_HEALTH = 10;
 const int LASER_DAMAGE = 1;
 const int SPACESHIP_DAMAGE = 1;
 const int BOMB_DAMAGE = 1;
-const float PROJECTILE_SPEED = 0.5f;
-const float SPACESHIP_SPEED = 0.1f;
-const float BOMB_SPEED = 0.2f;
-const float LASER_SPEED = 0.8f;
+const Fixed PROJECTILE_SPEED(0.5f);
+const Fixed SPACESHIP_SPEED(0.1f);
+const Fixed BOMB_SPEED(0.2f);
+const Fixed LASER_SPEED(0.8f);
 const int SCORE_PER_SPACESHIP = 100;
 const int SCORE_PER_PROJECTILE = 10;
 const int SCORE_PER_BOMB = 50;
 
 class GameObject {
 protected:
-    float x, y;           // Position with floating-point precision
+    Fixed x, y;           // Position with sub-cell precision
+    int cellX, cellY;     // Screen cell of x, y; updated whenever they change
     int lastDrawnX, lastDrawnY; // Last position where object was drawn
-    float directionX, directionY; // Direction vector (normalized)
-    float speed;          // Movement speed
+    Fixed directionX, directionY; // Direction vector (normalized)
+    Fixed speed;          // Movement speed
     int symbol;           // Symbol to represent the object
     bool active;          // Whether the object is active/alive
 
 public:
-    GameObject(float startX, float startY, float dx, float dy, float spd, int sym);
+    GameObject(Fixed startX, Fixed startY, Fixed dx, Fixed dy, Fixed spd, int sym);
     virtual ~GameObject() = default;
 
     virtual void update();
+    void updateCell();
     void clearPrevious();
+    void translate(int dx, int dy);
+    void drawCell(chtype glyph);
     virtual void draw();
 
-    float getX() const;
-    float getY() const;
+    Fixed getX() const;
+    Fixed getY() const;
     bool isActive() const;
     void setActive(bool state);
     void deactivate();
     
     // Check collision with another game object
     bool collidesWith(const GameObject& other) const;
+
+    // Rewind support: position and direction; subclasses add their counters
+    virtual void save(SnapshotBuffer& out) const;
+    virtual void restore(SnapshotBuffer& in);
 };
 
 class Heart : public GameObject {
 private:
-    float aspectRatio;    // Character aspect ratio (width/height)
+    Fixed aspectRatio;    // Character aspect ratio (width/height)
     bool moving;          // Whether the heart is moving
     int health;           // Player health
     int score;            // Player score
@@ -61,93 +75,99 @@ public:
 
     void update() override;
     void draw() override;
-    void setDirection(float dx, float dy);
-    void setAspectRatio(float ratio);
+    void setDirection(Fixed dx, Fixed dy);
+    void setAspectRatio(Fixed ratio);
     void stop();
     void start();
     bool isMoving() const;
-    void setPosition(float newX, float newY);
+    void setPosition(Fixed newX, Fixed newY);
     void takeDamage(int amount);
     void addScore(int amount);
     
     int getHealth() const;
     int getScore() const;
-    float getAspectRatio() const;
+    Fixed getAspectRatio() const;
     bool isInvincible() const;
-    float getDirectionX() const;
-    float getDirectionY() const;
-};
-
-class Laser : public GameObject {
-public:
-    Laser(float startX, float startY, float dx, float dy);
-    void draw() override;
+    Fixed getDirectionX() const;
+    Fixed getDirectionY() const;
+    void save(SnapshotBuffer& out) const override;
+    void restore(SnapshotBuffer& in) override;
 };
 
-class Spaceship : public GameObject {
+// One round of the space battle, advanced a frame at a time so it can be
+// driven by runRound's own loop or by the session server's shared tick
+class SpaceBattleRound {
 private:
-    int health;
-    int fireCooldown;
-    int maxFireCooldown;
-    bool reachedLeftEdge;
+    int round;
+    int spaceshipSpawnInterval;
+    int bombSpawnInterval;
+    int maxEnemies;
 
-public:
-    Spaceship(float startX, float startY, float dx, float dy);
-    
-    void update() override;
-    bool canFire() const;
-    void resetFireCoolDown();
-    void draw() override;
-    void takeDamage(int amount);
-    
-    // Check if spaceship has reached left edge
-    bool hasReachedLeft(int leftEdge) const;
-    void markReachedLeftEdge();
-    int getHealth() const;
-};
+    BattleBox battleBox;
+    Heart heart;
 
-class Projectile : public GameObject {
-public:
-    Projectile(float startX, float startY, float dx, float dy);
-    void draw() override;
-};
+    // Game objects, one pool per kind
+    EntityPool spaceships;
+    EntityPool projectiles;
+    EntityPool bombs;
+    EntityPool lasers;
 
-class Bomb : public GameObject {
-private:
-    int timer;
+    // Round, score and health above the box
+    HudText stats;
+    HudHealthBar healthBar;
 
-public:
-    Bomb(float startX, float startY);
-    void update() override;
-    void draw() override;
-    int getTimer() const;
-};
+    // Game state
+    int frameCount;
+    bool running;
+    bool gameOver;
+    int resultCode;
 
-class BattleBox {
-private:
-    int x, y;         // Top-left corner position
-    int width, height; // Box dimensions
-    bool needsRedraw;  // Flag to determine if the box needs redrawing
+    RandomGenerator random;  // This round's spawns and aim, saved with it
+    SnapshotRing history;  // Recent states for the rewind key
 
 public:
-    BattleBox(int startX, int startY, int w, int h);
+    // Reads the round's settings and sizes the pools; draws nothing, so a
+    // round can be built while something else is on the screen
+    SpaceBattleRound(int roundNumber, int playerHealth, int maxX, int maxY);
 
-    void draw();
-    void setNeedsRedraw();
-    
-    // Check if a position is inside the battle box (with a small margin)
-    bool contains(float checkX, float checkY) const;
-    
-    // Check if a position is outside the battle box (with a small margin)
-    bool isOutside(float checkX, float checkY) const;
+    // Draws the box, centred on the screen as it is by then
+    void begin();
 
-    int getX() const;
-    int getY() const;
-    int getWidth() const;
-    int getHeight() const;
+    // Moves the box and everything in it to the middle of the screen
+    void recentre();
+
+    // Re-centres the round on the current screen size after KEY_RESIZE
+    void relayout();
+
+    // Rewind support: the whole battle, random generator included
+    void save(SnapshotBuffer& out) const;
+    void restore(SnapshotBuffer& in);
+
+    // The battle box in pixels for YEAR1_GRAPHICS terminals
+    void rasterise(PixelCanvas& canvas) const;
+    
+    // Process input, update and draw one frame (without refreshing).
+    // Returns false once the round has ended.
+    bool step();
+    void drawResult(int maxX, int maxY);
+
+    const BattleBox& getBattleBox() const;
+    bool isGameOver() const;
+    int getResultCode() const;
+    int getHealth() const;
+    int getScore() const;
 };
 
-// Game function
-std::vector<int> runRound(int round, int playerHealth);
+// Loads 1340_rounds.bin (rebuilding it from the text if needed). Call before
+// the first round, and again to pick up edits from the next round on. Prints
+// the problem and returns false on failure, keeping the previous table.
+bool loadRoundTable();
+
+// Builds a round for the current screen size without drawing it, e.g. to
+// have it ready before the round's dialogue
+std::unique_ptr<SpaceBattleRound> prepareRound(int round, int playerHealth);
+
+// Plays a round until it ends: [status (1 won, -1 lost), health, score]
+std::vector<int> runRound(SpaceBattleRound& battle);
 
 #endif // HEART_GAME_H
\ No newline at end of file
@@ -3,34 +3,32 @@
 #include <ctime>
 #include <cstdlib>
 #include <vector>
-#include "text_animator.h"
+#include "dialogue.h"
 #include "1340.h"
+#include "present.h"
+#include "random.h"
+#include "screen.h"
+#include "stage_result.h"
 
 int main() {
+    if (!loadRoundTable()) {
+        return 1;
+    }
+
     // Seed the random number generator
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    
-    // Initialize ncurses
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);  // Hide cursor
-    
-    // Enable function keys, arrow keys, etc.
-    keypad(stdscr, TRUE);
+    seedRandom();
     
-    // Set up colors if terminal supports them
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_RED, COLOR_BLACK);     // Red heart
-        init_pair(2, COLOR_YELLOW, COLOR_BLACK);  // Yellow for invincibility
-        init_pair(3, COLOR_CYAN, COLOR_BLACK);    // Cyan for laser/name
-        init_pair(4, COLOR_BLUE, COLOR_BLACK);    // Blue for spaceships/dialogue box
-        init_pair(5, COLOR_GREEN, COLOR_BLACK);   // Green for projectiles
-        init_pair(6, COLOR_MAGENTA, COLOR_BLACK); // Magenta for bombs
-        init_pair(7, COLOR_WHITE, COLOR_BLACK);   // White for text
-    }
+    // One ncurses screen and palette for the dialogues and every round
+    initScreen();
+    PaletteScope palette({
+        {1, COLOR_RED, COLOR_BLACK},     // Red heart
+        {2, COLOR_YELLOW, COLOR_BLACK},  // Yellow for invincibility
+        {3, COLOR_CYAN, COLOR_BLACK},    // Cyan for laser/name
+        {4, COLOR_BLUE, COLOR_BLACK},    // Blue for spaceships/dialogue box
+        {5, COLOR_GREEN, COLOR_BLACK},   // Green for projectiles
+        {6, COLOR_MAGENTA, COLOR_BLACK}, // Magenta for bombs
+        {7, COLOR_WHITE, COLOR_BLACK},   // White for text
+    });
 
     // Get terminal dimensions
     int maxY, maxX;
@@ -50,22 +48,23 @@ int main() {
     int playerScore = 0;
     
     for (int currentRound = 1; currentRound <= 3; currentRound++) {
-        // Important: Set nodelay mode for non-blocking input during gameplay
-        nodelay(stdscr, TRUE);
-        
-        // Show round info dialogue
-        clear();
+        // Build the round first, so it is ready to play the moment its
+        // dialogue is dismissed
+        std::unique_ptr<SpaceBattleRound> battle = prepareRound(currentRound, playerHealth);
+
+        // Show round info dialogue. erase() rather than clear(): the next
+        // refresh only sends the cells that changed instead of repainting
+        // the whole terminal
+        erase();
         showRoundInfo(currentRound);
         
-        // Clear screen before starting the round
-        clear();
-        refresh();
+        // Clear screen for the round without presenting it: the round's
+        // first frame replaces the dialogue directly. The round makes its
+        // input non-blocking while it plays
+        erase();
         
         // Run the round with current player stats
-        std::vector<int> result = runRound(currentRound, playerHealth);
-        
-        // Switch back to blocking input for dialogues
-        nodelay(stdscr, FALSE);
+        std::vector<int> result = runRound(*battle);
         
         // Process round result
         // result[0] is status: 1 = won, -1 = lost
@@ -93,7 +92,8 @@ int main() {
         }
     }
     
-    // Game end dialogue
+    // Report to the launcher, then the game end dialogue
+    reportStageOutcome(gameCompleted, finalRound, playerHealth, playerScore);
     gameOver(gameCompleted, finalRound, playerScore);
     
     // Clean up
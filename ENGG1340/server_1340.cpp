@@ -0,0 +1,193 @@
+#include <ncursesw/ncurses.h>
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <clocale>
+#include <string>
+#include <vector>
+#include <memory>
+#include "1340.h"
+#include "text_animator.h"
+#include "session_server.h"
+#include "input.h"
+#include "random.h"
+#include "terminal_graphics.h"
+
+static const char* DIALOGUE_FILE = "1340_dialogue.txt";
+static const char* ROUNDS_FILE = "1340_rounds.txt";
+
+// Both files are watched while the server runs. An edit is parsed once into a
+// new snapshot; sessions pick it up at their next round boundary.
+static void reloadFile(const std::string& path) {
+    bool loaded = path == ROUNDS_FILE ? loadRoundTable() : reloadDialogueSnapshot(path);
+    std::fprintf(stderr, "%s %s\n", loaded ? "Reloaded" : "Kept the previous", path.c_str());
+}
+
+static void replaceToken(std::string& text, const std::string& token, int value) {
+    size_t pos = text.find(token);
+    if (pos != std::string::npos) {
+        text.replace(pos, token.size(), std::to_string(value));
+    }
+}
+
+// Title above the dialogue box, in the middle of a cleared screen
+static void drawTitle(const std::string& title) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    clear();
+    attron(COLOR_PAIR(3) | A_BOLD);
+    mvprintw(maxY / 3, (maxX - static_cast<int>(title.size())) / 2, "%s", title.c_str());
+    attroff(COLOR_PAIR(3) | A_BOLD);
+}
+
+// The ENGG1340 stage as a tick-driven state machine:
+// round intro -> playing -> round result -> ... -> game over
+class SpaceBattleSession : public SessionApp {
+private:
+    enum State { ROUND_INTRO, PLAYING, ROUND_RESULT, GAME_OVER };
+
+    State state;
+    int round;
+    int playerHealth;
+    int playerScore;
+    int lastResult;
+    std::unique_ptr<SpaceBattleRound> battle;
+    std::unique_ptr<PixelCanvas> halfBlocks;  // YEAR1_GRAPHICS=halfblock only
+    std::shared_ptr<const DialogueBundle> dialogue;  // Snapshot taken at each round boundary
+    TextAnimator professor;  // Typed out a little every tick, never blocking the server
+
+    // Clears the screen to a title above an empty dialogue box; start the
+    // box's text next
+    void openBox(const std::string& title) {
+        drawTitle(title);
+        professor = TextAnimator(getmaxx(stdscr) * 3 / 4, "Professor", 80, true);
+    }
+
+    // One tick of the dialogue box; false once the player pressed Enter
+    bool dialogueTick() {
+        int ch;
+        while ((ch = getch()) != ERR) professor.handleKey(ch);
+        if (!professor.update()) return false;
+        professor.draw();
+        return true;
+    }
+
+    void showRoundIntro() {
+        // The round is built now, from the settings of this round boundary,
+        // so the tick that dismisses the dialogue can already play it
+        battle = prepareRound(round, playerHealth);
+        if (graphicsMode() == GRAPHICS_HALF_BLOCK) {
+            const BattleBox& box = battle->getBattleBox();
+            halfBlocks.reset(newBoxCanvas(GRAPHICS_HALF_BLOCK, box.getWidth() - 1, box.getHeight() - 1));
+        }
+
+        dialogue = dialogueSnapshot(DIALOGUE_FILE);
+        openBox("ROUND " + std::to_string(round));
+        // Every session shows the same line at the same width, so they
+        // share the snapshot's layout of it
+        professor.start(*dialogue, 7 + round);
+        state = ROUND_INTRO;
+    }
+
+    void showGameOver(bool won) {
+        dialogue = dialogueSnapshot(DIALOGUE_FILE);
+        std::string text = dialogue->line(won ? 14 : 15).str();
+        replaceToken(text, "ROUND", round);
+        replaceToken(text, "SCORE", playerScore);
+        openBox(won ? "COURSE PASSED" : "COURSE FAILED");
+        professor.start(text);
+        state = GAME_OVER;
+    }
+
+public:
+    SpaceBattleSession() :
+        state(ROUND_INTRO), round(1), playerHealth(INITIAL_PLAYER_HEALTH), playerScore(0), lastResult(0),
+        professor(0, "Professor") {}
+
+    void start() override {
+        if (has_colors()) {
+            start_color();
+            init_pair(1, COLOR_RED, COLOR_BLACK);     // Red heart
+            init_pair(2, COLOR_YELLOW, COLOR_BLACK);  // Yellow for invincibility
+            init_pair(3, COLOR_CYAN, COLOR_BLACK);    // Cyan for laser/name
+            init_pair(4, COLOR_BLUE, COLOR_BLACK);    // Blue for spaceships
+            init_pair(5, COLOR_GREEN, COLOR_BLACK);   // Green for projectiles
+            init_pair(6, COLOR_MAGENTA, COLOR_BLACK); // Magenta for bombs
+            init_pair(7, COLOR_WHITE, COLOR_BLACK);   // White for text
+        }
+        showRoundIntro();
+    }
+
+    bool tick() override {
+        int maxY, maxX;
+        getmaxyx(stdscr, maxY, maxX);
+
+        switch (state) {
+            case ROUND_INTRO:
+                if (dialogueTick()) break;
+                clear();
+                battle->begin();
+                state = PLAYING;
+                // fall through: the round's first frame goes out with this tick
+
+            case PLAYING:
+                if (battle->step()) {
+                    if (halfBlocks) {
+                        const BattleBox& box = battle->getBattleBox();
+                        battle->rasterise(*halfBlocks);
+                        drawHalfBlocks(*halfBlocks, box.getInnerMinX(), box.getInnerMinY());
+                    }
+                } else {
+                    lastResult = battle->getResultCode();
+                    playerHealth = battle->getHealth();
+                    playerScore = battle->getScore();
+                    if (battle->isGameOver()) {
+                        battle->drawResult(maxX, maxY);
+                        state = ROUND_RESULT;
+                    } else {
+                        // Player quit with 'q'
+                        showGameOver(false);
+                    }
+                    battle.reset();
+                }
+                break;
+
+            case ROUND_RESULT:
+                if (enterPressed()) {
+                    if (lastResult == -1) {
+                        showGameOver(false);
+                    } else if (round == 3) {
+                        showGameOver(true);
+                    } else {
+                        round++;
+                        showRoundIntro();
+                    }
+                }
+                break;
+
+            case GAME_OVER:
+                if (!dialogueTick()) {
+                    return false;
+                }
+                break;
+        }
+        return true;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    // Half blocks are a Unicode character, sent in the server's encoding
+    if (graphicsMode() == GRAPHICS_HALF_BLOCK) setlocale(LC_ALL, "");
+    if (!loadRoundTable()) {
+        return 1;
+    }
+    seedRandom();
+    dialogueSnapshot(DIALOGUE_FILE);
+
+    std::string socketPath = argc > 1 ? argv[1] : "/tmp/year1_1340.sock";
+    SessionServer server(socketPath, []() {
+        return std::unique_ptr<SessionApp>(new SpaceBattleSession());
+    });
+    server.watchFiles({ DIALOGUE_FILE, ROUNDS_FILE }, reloadFile);
+    return server.run();
+}
@@ -14,3 +14,6 @@ cd ..
 cd ENGG1340
 make clean
 cd ..
+cd engine
+make clean
+cd ..
@@ -0,0 +1,53 @@
+#include "compiled_file.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+long long modifiedTime(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return -1;
+    return info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+}
+
+bool writeCompiledFile(const std::string& path, const std::vector<char>& image, std::string& error) {
+    std::string temporary = path + ".tmp";
+    FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (!out) {
+        error = temporary + ": " + std::strerror(errno);
+        return false;
+    }
+    bool written = std::fwrite(image.data(), 1, image.size(), out) == image.size();
+    written = std::fclose(out) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = path + ": " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+void* mapCompiledFile(const std::string& path, size_t& size, std::string& error) {
+    size = 0;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    void* mapping = nullptr;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        size = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) mapping = nullptr;
+    }
+    close(fd);
+    if (!mapping) {
+        size = 0;
+        error = path + ": cannot be mapped";
+    }
+    return mapping;
+}
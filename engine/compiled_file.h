@@ -0,0 +1,24 @@
+#ifndef COMPILED_FILE_H
+#define COMPILED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// File handling shared by the data compiled from designers' text files
+// (round tables, dialogue bundles): the text is the source, the binary next
+// to it is rebuilt whenever the text is newer and is then mapped, not read.
+
+// Modification time of a file in nanoseconds, or -1 if it does not exist.
+// Whole seconds are too coarse once edits are reloaded while running.
+long long modifiedTime(const std::string& path);
+
+// Writes image to path through a temporary file and a rename, so a running
+// program never maps a half-written file
+bool writeCompiledFile(const std::string& path, const std::vector<char>& image, std::string& error);
+
+// Maps the whole file read-only. Returns nullptr (with error set) if it
+// cannot be opened or is empty; release it with munmap(mapping, size).
+void* mapCompiledFile(const std::string& path, size_t& size, std::string& error);
+
+#endif // COMPILED_FILE_H
@@ -0,0 +1,466 @@
+#include "dialogue_bundle.h"
+#include "compiled_file.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+
+namespace {
+
+const char MAGIC[4] = { 'Y', 'D', 'B', '2' };
+
+const char* const VARIABLE_NAMES[] = { "hp", "round", "score" };
+const char* const COMPARISON_NAMES[] = { "<", "<=", ">", ">=", "==", "!=" };
+
+std::string trimmed(const std::string& text) {
+    size_t first = 0;
+    size_t last = text.size();
+    while (first < last && std::isspace(static_cast<unsigned char>(text[first]))) first++;
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) last--;
+    return text.substr(first, last - first);
+}
+
+template <size_t N>
+int findName(const char* const (&names)[N], const std::string& name) {
+    for (size_t i = 0; i < N; i++) {
+        if (name == names[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Jumps in a row, without a line or a choice in between, after which a
+// script is taken to be looping and ended
+const uint32_t MAX_JUMPS = 256;
+
+// Whether [offset, offset + length) lies within a table or text of size
+// entries, without the sum wrapping around. Entries are checked like this
+// as they are used rather than all at load, so attaching stays constant
+// time; a damaged entry reads as empty or ends the conversation.
+bool fits(uint32_t offset, uint32_t length, uint32_t size) {
+    return static_cast<uint64_t>(offset) + length <= size;
+}
+
+// Whether the condition of a BRANCH_IF step holds
+bool holds(const DialogueBundle::Step& step, const ScriptVariables& variables) {
+    int value = step.variable == DialogueBundle::HP ? variables.hp
+              : step.variable == DialogueBundle::ROUND ? variables.round
+              : variables.score;
+    switch (step.comparison) {
+        case DialogueBundle::LESS: return value < step.value;
+        case DialogueBundle::LESS_EQUAL: return value <= step.value;
+        case DialogueBundle::GREATER: return value > step.value;
+        case DialogueBundle::GREATER_EQUAL: return value >= step.value;
+        case DialogueBundle::EQUAL: return value == step.value;
+        case DialogueBundle::NOT_EQUAL: return value != step.value;
+    }
+    return false;
+}
+
+} // namespace
+
+WrappedLines wrapWords(const std::vector<TextSpan>& words, int width) {
+    WrappedLines lines(1);
+    int column = 0;
+    for (const TextSpan& word : words) {
+        int wordLength = static_cast<int>(word.length);
+        if (column + wordLength >= width) {
+            lines.push_back(std::string());
+            column = 0;
+        }
+        if (column > 0) lines.back() += ' ';
+        lines.back().append(word.data, word.length);
+        column += wordLength + 1;
+    }
+    return lines;
+}
+
+DialogueBundle::DialogueBundle()
+    : mapping(nullptr), mappingSize(0), header(nullptr), lineTable(nullptr), wordTable(nullptr),
+      nodeTable(nullptr), stepTable(nullptr), text(nullptr) {}
+
+DialogueBundle::~DialogueBundle() {
+    release();
+}
+
+void DialogueBundle::release() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    compiled.clear();
+    layouts.clear();
+    header = nullptr;
+    lineTable = nullptr;
+    wordTable = nullptr;
+    nodeTable = nullptr;
+    stepTable = nullptr;
+    text = nullptr;
+}
+
+bool DialogueBundle::attach(const char* data, size_t size) {
+    if (size < sizeof(Header)) return false;
+    const Header* candidate = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    size_t linesSize = (static_cast<size_t>(candidate->lines) + candidate->scriptLines) * sizeof(Line);
+    size_t wordsSize = static_cast<size_t>(candidate->words) * sizeof(Word);
+    size_t nodesSize = static_cast<size_t>(candidate->nodes) * sizeof(Node);
+    size_t stepsSize = static_cast<size_t>(candidate->steps) * sizeof(Step);
+    if (size != sizeof(Header) + linesSize + wordsSize + nodesSize + stepsSize + candidate->textSize) return false;
+
+    header = candidate;
+    const char* table = data + sizeof(Header);
+    lineTable = reinterpret_cast<const Line*>(table);
+    table += linesSize;
+    wordTable = reinterpret_cast<const Word*>(table);
+    table += wordsSize;
+    nodeTable = reinterpret_cast<const Node*>(table);
+    table += nodesSize;
+    stepTable = reinterpret_cast<const Step*>(table);
+    text = table + stepsSize;
+    return true;
+}
+
+bool DialogueBundle::load(const std::string& binaryPath, const std::string& sourcePath) {
+    release();
+    lastError.clear();
+
+    // Bring the binary up to date with the text if the writer edited it
+    long long sourceTime = modifiedTime(sourcePath);
+    if (sourceTime >= 0 && sourceTime > modifiedTime(binaryPath)) {
+        std::string compileError;
+        if (!compileFile(sourcePath, binaryPath, compileError)) {
+            // Could not write it (read-only directory?): use it from memory
+            if (!compile(sourcePath, compiled, lastError)) return false;
+            if (attach(compiled.data(), compiled.size())) return true;
+            lastError = sourcePath + ": compiled bundle is invalid";
+            return false;
+        }
+    }
+
+    mapping = mapCompiledFile(binaryPath, mappingSize, lastError);
+    if (!mapping) return false;
+    if (!attach(static_cast<const char*>(mapping), mappingSize)) {
+        release();
+        // Written by an older dialogue_compiler: use the text from memory
+        if (sourceTime >= 0 && compile(sourcePath, compiled, lastError) &&
+            attach(compiled.data(), compiled.size())) {
+            return true;
+        }
+        release();
+        lastError = binaryPath + ": not a dialogue bundle";
+        return false;
+    }
+    return true;
+}
+
+TextSpan DialogueBundle::line(size_t index) const {
+    if (index >= allLines()) return TextSpan{ "", 0 };
+    const Line& entry = lineTable[index];
+    if (!fits(entry.offset, entry.length, header->textSize)) return TextSpan{ "", 0 };
+    return TextSpan{ text + entry.offset, entry.length };
+}
+
+size_t DialogueBundle::wordCount(size_t index) const {
+    if (index >= allLines()) return 0;
+    const Line& entry = lineTable[index];
+    return fits(entry.firstWord, entry.wordCount, header->words) ? entry.wordCount : 0;
+}
+
+TextSpan DialogueBundle::word(size_t index, size_t word) const {
+    if (word >= wordCount(index)) return TextSpan{ "", 0 };
+    const Word& entry = wordTable[lineTable[index].firstWord + word];
+    if (!fits(entry.offset, entry.length, header->textSize)) return TextSpan{ "", 0 };
+    return TextSpan{ text + entry.offset, entry.length };
+}
+
+std::shared_ptr<const WrappedLines> DialogueBundle::wrapped(size_t index, int width) const {
+    std::shared_ptr<const WrappedLines>& layout = layouts[std::make_pair(index, width)];
+    if (!layout) {
+        std::vector<TextSpan> words;
+        for (size_t word = 0; word < wordCount(index); word++) words.push_back(this->word(index, word));
+        layout = std::make_shared<WrappedLines>(wrapWords(words, width));
+    }
+    return layout;
+}
+
+uint32_t DialogueBundle::findNode(const std::string& label) const {
+    if (!header) return NO_NODE;
+    for (uint32_t node = 0; node < header->nodes; node++) {
+        const Node& entry = nodeTable[node];
+        if (entry.labelLength == label.size() &&
+            fits(entry.labelOffset, entry.labelLength, header->textSize) &&
+            std::memcmp(text + entry.labelOffset, label.data(), label.size()) == 0) {
+            return node;
+        }
+    }
+    return NO_NODE;
+}
+
+uint32_t DialogueBundle::stepCount(uint32_t node) const {
+    if (!header || node >= header->nodes) return 0;
+    const Node& entry = nodeTable[node];
+    return fits(entry.firstStep, entry.stepCount, header->steps) ? entry.stepCount : 0;
+}
+
+const DialogueBundle::Step& DialogueBundle::step(uint32_t node, uint32_t index) const {
+    return stepTable[nodeTable[node].firstStep + index];
+}
+
+bool DialogueBundle::nodeIntact(uint32_t node) const {
+    if (!header || node >= header->nodes) return false;
+    const Node& entry = nodeTable[node];
+    if (!fits(entry.firstStep, entry.stepCount, header->steps)) return false;
+    for (uint32_t i = 0; i < entry.stepCount; i++) {
+        const Step& current = stepTable[entry.firstStep + i];
+        if (current.kind > GOTO || current.variable > SCORE || current.comparison > NOT_EQUAL) return false;
+        // Only SAY and CHOICE show a line; jumps leave it 0
+        if ((current.kind == SAY || current.kind == CHOICE) && current.line >= allLines()) return false;
+        if (current.target != NO_NODE && current.target >= header->nodes) return false;
+    }
+    return true;
+}
+
+bool DialogueBundle::compile(const std::string& sourcePath, std::vector<char>& image, std::string& error) {
+    std::ifstream file(sourcePath);
+    if (!file.is_open()) {
+        error = sourcePath + ": cannot open";
+        return false;
+    }
+
+    std::vector<Line> lines;
+    std::vector<Word> words;
+    std::vector<Node> nodes;
+    std::vector<Step> steps;
+    std::vector<std::string> labels;
+    std::string allText;
+    uint32_t numberedLines = 0;
+
+    // Jumps name nodes that may come later; resolved at the end
+    struct Reference {
+        size_t step;
+        std::string label;
+        std::string where;
+    };
+    std::vector<Reference> references;
+
+    auto addLine = [&](const std::string& line) {
+        Line entry;
+        entry.offset = static_cast<uint32_t>(allText.size());
+        entry.length = static_cast<uint32_t>(line.size());
+        entry.firstWord = static_cast<uint32_t>(words.size());
+        size_t pos = 0;
+        while (pos < line.size()) {
+            while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) pos++;
+            size_t start = pos;
+            while (pos < line.size() && !std::isspace(static_cast<unsigned char>(line[pos]))) pos++;
+            if (pos > start) {
+                words.push_back(Word{ static_cast<uint32_t>(entry.offset + start),
+                                      static_cast<uint32_t>(pos - start) });
+            }
+        }
+        entry.wordCount = static_cast<uint32_t>(words.size()) - entry.firstWord;
+        lines.push_back(entry);
+        allText += line;
+        return static_cast<uint32_t>(lines.size() - 1);
+    };
+    auto addStep = [&](StepKind kind, uint32_t line) -> Step& {
+        Step step = { kind, HP, LESS, 0, 0, line, NO_NODE };
+        steps.push_back(step);
+        nodes.back().stepCount++;
+        return steps.back();
+    };
+    auto jumpTo = [&](const std::string& label, const std::string& where) {
+        references.push_back(Reference{ steps.size() - 1, label, where });
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+        std::string where = sourcePath + ":" + std::to_string(lineNumber) + ": ";
+
+        bool directive = line[0] == '@' || line[0] == '?' || line[0] == '>' || line.compare(0, 2, "->") == 0;
+        if (nodes.empty() && !directive) {
+            addLine(line);
+            numberedLines++;
+            continue;
+        }
+        if (nodes.empty() && line[0] != '@') {
+            error = where + "script line outside a node";
+            return false;
+        }
+
+        if (line[0] == '@') {
+            std::string label = trimmed(line.substr(1));
+            if (label.empty() || label.find_first_of(" \t") != std::string::npos) {
+                error = where + "a node needs a one-word label";
+                return false;
+            }
+            for (const std::string& existing : labels) {
+                if (existing == label) {
+                    error = where + "node " + label + " is defined twice";
+                    return false;
+                }
+            }
+            labels.push_back(label);
+            Node node = { 0, static_cast<uint32_t>(label.size()), static_cast<uint32_t>(steps.size()), 0 };
+            nodes.push_back(node);
+        } else if (line.compare(0, 2, "->") == 0) {
+            addStep(GOTO, 0);
+            jumpTo(trimmed(line.substr(2)), where);
+        } else if (line[0] == '?') {
+            // ? <variable> <comparison> <number> -> <label>
+            std::istringstream fields(line.substr(1));
+            std::string variable, comparison, value, arrow, label;
+            fields >> variable >> comparison >> value >> arrow >> label;
+            int variableIndex = findName(VARIABLE_NAMES, variable);
+            int comparisonIndex = findName(COMPARISON_NAMES, comparison);
+            char* end = nullptr;
+            long number = std::strtol(value.c_str(), &end, 10);
+            if (variableIndex < 0 || comparisonIndex < 0 || value.empty() || *end != '\0' ||
+                arrow != "->" || label.empty()) {
+                error = where + "expected \"? hp|round|score <|<=|>|>=|==|!= <number> -> <label>\"";
+                return false;
+            }
+            Step& step = addStep(BRANCH_IF, 0);
+            step.variable = static_cast<Variable>(variableIndex);
+            step.comparison = static_cast<Comparison>(comparisonIndex);
+            step.value = static_cast<int32_t>(number);
+            jumpTo(label, where);
+        } else if (line[0] == '>') {
+            // > <text> [-> <label>]
+            std::string option = line.substr(1);
+            std::string label;
+            size_t arrow = option.rfind("->");
+            if (arrow != std::string::npos) {
+                label = trimmed(option.substr(arrow + 2));
+                option.erase(arrow);
+            }
+            option = trimmed(option);
+            if (option.empty()) {
+                error = where + "a choice needs text";
+                return false;
+            }
+            int group = 0;
+            for (size_t i = steps.size(); i > nodes.back().firstStep && steps[i - 1].kind == CHOICE; i--) group++;
+            if (group == MAX_CHOICES) {
+                error = where + "more than " + std::to_string(MAX_CHOICES) + " choices in a row";
+                return false;
+            }
+            addStep(CHOICE, addLine(option));
+            if (!label.empty()) jumpTo(label, where);
+        } else {
+            addStep(SAY, addLine(line));
+        }
+    }
+
+    for (const Reference& reference : references) {
+        size_t node = 0;
+        while (node < labels.size() && labels[node] != reference.label) node++;
+        if (node == labels.size()) {
+            error = reference.where + "no node " + reference.label;
+            return false;
+        }
+        steps[reference.step].target = static_cast<uint32_t>(node);
+    }
+
+    // Labels go after the lines in the text
+    for (size_t node = 0; node < nodes.size(); node++) {
+        nodes[node].labelOffset = static_cast<uint32_t>(allText.size());
+        allText += labels[node];
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.lines = numberedLines;
+    header.scriptLines = static_cast<uint32_t>(lines.size()) - numberedLines;
+    header.words = static_cast<uint32_t>(words.size());
+    header.nodes = static_cast<uint32_t>(nodes.size());
+    header.steps = static_cast<uint32_t>(steps.size());
+    header.textSize = static_cast<uint32_t>(allText.size());
+    header.reserved = 0;
+
+    size_t linesSize = lines.size() * sizeof(Line);
+    size_t wordsSize = words.size() * sizeof(Word);
+    size_t nodesSize = nodes.size() * sizeof(Node);
+    size_t stepsSize = steps.size() * sizeof(Step);
+    image.assign(sizeof(Header) + linesSize + wordsSize + nodesSize + stepsSize + allText.size(), 0);
+    char* out = image.data();
+    std::memcpy(out, &header, sizeof(Header));
+    out += sizeof(Header);
+    if (linesSize) std::memcpy(out, lines.data(), linesSize);
+    out += linesSize;
+    if (wordsSize) std::memcpy(out, words.data(), wordsSize);
+    out += wordsSize;
+    if (nodesSize) std::memcpy(out, nodes.data(), nodesSize);
+    out += nodesSize;
+    if (stepsSize) std::memcpy(out, steps.data(), stepsSize);
+    out += stepsSize;
+    std::memcpy(out, allText.data(), allText.size());
+    return true;
+}
+
+bool DialogueBundle::compileFile(const std::string& sourcePath, const std::string& binaryPath, std::string& error) {
+    std::vector<char> image;
+    if (!compile(sourcePath, image, error)) return false;
+    return writeCompiledFile(binaryPath, image, error);
+}
+
+ScriptCursor::ScriptCursor() : node(DialogueBundle::NO_NODE), step(0) {}
+
+bool ScriptCursor::start(const std::shared_ptr<const DialogueBundle>& script, const std::string& label) {
+    bundle = script;
+    enter(bundle ? bundle->findNode(label) : DialogueBundle::NO_NODE);
+    return node != DialogueBundle::NO_NODE;
+}
+
+void ScriptCursor::enter(uint32_t target) {
+    node = target != DialogueBundle::NO_NODE && bundle->nodeIntact(target) ? target : DialogueBundle::NO_NODE;
+    step = 0;
+}
+
+ScriptCursor::Event ScriptCursor::next(const ScriptVariables& variables, std::vector<size_t>& lines) {
+    lines.clear();
+    uint32_t jumps = 0;
+    while (node != DialogueBundle::NO_NODE && step < bundle->stepCount(node)) {
+        const DialogueBundle::Step& current = bundle->step(node, step);
+        switch (current.kind) {
+            case DialogueBundle::SAY:
+                step++;
+                lines.push_back(current.line);
+                return SAY;
+
+            case DialogueBundle::CHOICE:
+                while (step < bundle->stepCount(node) && lines.size() < DialogueBundle::MAX_CHOICES &&
+                       bundle->step(node, step).kind == DialogueBundle::CHOICE) {
+                    const DialogueBundle::Step& option = bundle->step(node, step);
+                    choiceTargets[lines.size()] = option.target;
+                    lines.push_back(option.line);
+                    step++;
+                }
+                return CHOOSE;
+
+            case DialogueBundle::BRANCH_IF:
+            case DialogueBundle::GOTO:
+                if (current.kind == DialogueBundle::GOTO || holds(current, variables)) {
+                    if (++jumps > MAX_JUMPS) {
+                        node = DialogueBundle::NO_NODE;
+                        break;
+                    }
+                    enter(current.target);
+                } else {
+                    step++;
+                }
+                break;
+        }
+    }
+    node = DialogueBundle::NO_NODE;
+    return END;
+}
+
+void ScriptCursor::choose(size_t option) {
+    enter(option < DialogueBundle::MAX_CHOICES ? choiceTargets[option] : DialogueBundle::NO_NODE);
+}
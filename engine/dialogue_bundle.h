@@ -0,0 +1,197 @@
+#ifndef DIALOGUE_BUNDLE_H
+#define DIALOGUE_BUNDLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Characters inside a mapped bundle, not copied and not NUL-terminated
+// (C++11 has no std::string_view)
+struct TextSpan {
+    const char* data;
+    size_t length;
+
+    std::string str() const { return std::string(data, length); }
+};
+
+// A text broken into the lines of a dialogue box
+typedef std::vector<std::string> WrappedLines;
+
+// Breaks words into lines the way the dialogue box always has: a word goes
+// to the next line once it would reach column width
+WrappedLines wrapWords(const std::vector<TextSpan>& words, int width);
+
+// What script conditions can test, filled in by the stage
+struct ScriptVariables {
+    int hp;
+    int round;
+    int score;
+};
+
+// A stage's dialogue lines, indexed for the dialogue box.
+//
+// Writers edit a text file (e.g. 1340_dialogue.txt), one line per dialogue,
+// skipping empty lines and lines starting with #. dialogue_compiler turns it
+// into a bundle (1340_dialogue.bin) holding the text, where each line
+// starts and where each of its words starts, so nothing is parsed, copied
+// or split at startup or when a line is shown. Like a RoundTable the bundle
+// is rebuilt by make, or by load() itself when it is missing or older than
+// the text.
+//
+// After the numbered lines the file may hold scripts: branching
+// conversations in labelled nodes.
+//     @after_round                 starts the node "after_round"
+//     ? hp <= 3 -> low_hp          jumps if the condition holds (hp, round
+//                                  or score against a number)
+//     Well played!                 shows a line
+//     > Tell me again -> rules     choices, one after another (up to 4);
+//     > Let's go                   without a target the script ends there
+//     -> rules                     jumps
+// A node that runs out ends the conversation. The nodes are compiled into
+// the bundle too, so a conversation only touches the pages of the lines it
+// reaches, and all that is kept per conversation is a ScriptCursor.
+class DialogueBundle {
+public:
+    static const int MAX_CHOICES = 4;  // One per row of the box
+    static const uint32_t NO_NODE = 0xffffffff;
+
+    // On-disk layout: header, lines, words, nodes, steps, then the text of
+    // every line and label back to back. Offsets are into the text.
+    struct Header {
+        char magic[4];       // "YDB2"
+        uint32_t lines;      // Numbered lines
+        uint32_t scriptLines;// Lines of the scripts, after them in the line table
+        uint32_t words;
+        uint32_t nodes;
+        uint32_t steps;
+        uint32_t textSize;
+        uint32_t reserved;
+    };
+
+    struct Line {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t firstWord;  // Index of its first word in the word table
+        uint32_t wordCount;
+    };
+
+    struct Word {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Node {
+        uint32_t labelOffset;
+        uint32_t labelLength;
+        uint32_t firstStep;
+        uint32_t stepCount;
+    };
+
+    enum StepKind : uint8_t { SAY, BRANCH_IF, CHOICE, GOTO };
+    enum Variable : uint8_t { HP, ROUND, SCORE };
+    enum Comparison : uint8_t { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL };
+
+    struct Step {
+        StepKind kind;
+        Variable variable;     // BRANCH_IF
+        Comparison comparison; // BRANCH_IF
+        uint8_t reserved;
+        int32_t value;         // BRANCH_IF
+        uint32_t line;         // SAY, and the text of a CHOICE
+        uint32_t target;       // Node jumped to, NO_NODE to end
+    };
+
+private:
+    void* mapping;              // The mapped .bin, if it could be used
+    size_t mappingSize;
+    std::vector<char> compiled; // Otherwise the bundle compiled in memory
+    const Header* header;
+    const Line* lineTable;
+    const Word* wordTable;
+    const Node* nodeTable;
+    const Step* stepTable;
+    const char* text;
+    std::string lastError;
+
+    // Wrapped lines by (line, width), filled in as lines are shown
+    mutable std::map<std::pair<size_t, int>, std::shared_ptr<const WrappedLines>> layouts;
+
+    bool attach(const char* data, size_t size);
+    void release();
+    size_t allLines() const { return header ? header->lines + header->scriptLines : 0; }
+
+public:
+    DialogueBundle();
+    ~DialogueBundle();
+    DialogueBundle(const DialogueBundle&) = delete;
+    DialogueBundle& operator=(const DialogueBundle&) = delete;
+
+    // Maps binaryPath, compiling sourcePath first if the binary is missing or
+    // out of date. Returns false with error() set if neither can be used.
+    bool load(const std::string& binaryPath, const std::string& sourcePath);
+
+    // Numbered lines; the scripts' own lines follow them
+    size_t size() const { return header ? header->lines : 0; }
+
+    // Lines are numbered from 0; past the end they are empty
+    TextSpan line(size_t index) const;
+    size_t wordCount(size_t index) const;
+    TextSpan word(size_t index, size_t word) const;
+
+    // Line index wrapped for a box width columns wide: worked out the first
+    // time it is asked for, then shared by every box that shows the line
+    // (and every session of the server) for as long as the bundle lives.
+    // Not thread safe, like the rest of the dialogue box.
+    std::shared_ptr<const WrappedLines> wrapped(size_t index, int width) const;
+
+    // Script nodes: the node with a label (NO_NODE if there is none), and
+    // its steps
+    uint32_t findNode(const std::string& label) const;
+    uint32_t stepCount(uint32_t node) const;
+    const Step& step(uint32_t node, uint32_t index) const;
+
+    // Whether every step of a node is well formed: known kinds, lines and
+    // targets in range. Checked as a conversation enters the node, so a
+    // damaged bundle costs nothing at load and only ends that conversation.
+    bool nodeIntact(uint32_t node) const;
+
+    const std::string& error() const { return lastError; }
+
+    // Text form -> binary image; words are split at whitespace. Script
+    // errors are reported with their line number.
+    static bool compile(const std::string& sourcePath, std::vector<char>& image, std::string& error);
+    static bool compileFile(const std::string& sourcePath, const std::string& binaryPath, std::string& error);
+};
+
+// Where a conversation is in a bundle's script. It runs conditions and
+// jumps itself and stops at each line to show or choice to make.
+class ScriptCursor {
+public:
+    enum Event { SAY, CHOOSE, END };
+
+private:
+    std::shared_ptr<const DialogueBundle> bundle;
+    uint32_t node;
+    uint32_t step;
+    uint32_t choiceTargets[DialogueBundle::MAX_CHOICES];
+
+    // Moves to the start of a node, or to the end if it is damaged
+    void enter(uint32_t target);
+
+public:
+    ScriptCursor();
+
+    // False (and at the end) if the bundle has no node with that label
+    bool start(const std::shared_ptr<const DialogueBundle>& script, const std::string& label);
+
+    // Moves to the next line or choice. For SAY, lines holds the line to
+    // show; for CHOOSE, the line of each option, answered with choose().
+    Event next(const ScriptVariables& variables, std::vector<size_t>& lines);
+    void choose(size_t option);
+};
+
+#endif // DIALOGUE_BUNDLE_H
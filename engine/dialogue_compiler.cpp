@@ -0,0 +1,18 @@
+// Compiles a stage's dialogue from text to the bundle the stage maps.
+// Usage: dialogue_compiler <dialogue.txt> <dialogue.bin>
+#include "dialogue_bundle.h"
+#include <cstdio>
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <dialogue.txt> <dialogue.bin>\n", argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    if (!DialogueBundle::compileFile(argv[1], argv[2], error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    return 0;
+}
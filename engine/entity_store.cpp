@@ -0,0 +1,185 @@
+#include "entity_store.h"
+#include "hud.h"
+
+EntityPool::EntityPool(const EntityKind& entityKind) : kind(entityKind) {}
+
+void EntityPool::reserve(int count) {
+    size_t n = static_cast<size_t>(count);
+    position.reserve(n);
+    if (has(VELOCITY)) velocity.reserve(n);
+    if (has(GLYPH)) glyph.reserve(n);
+    if (has(COLLIDER)) collider.reserve(n);
+    if (has(LIFETIME)) lifetime.reserve(n);
+    if (has(COOLDOWN)) cooldown.reserve(n);
+    if (has(EXTENT)) extent.reserve(n);
+    alive.reserve(n);
+}
+
+int EntityPool::spawn(Fixed x, Fixed y, FixedVec2 direction) {
+    Position at = { x, y, x.cell(), y.cell() };
+    position.push_back(at);
+    if (has(VELOCITY)) {
+        Velocity v = { direction.x * kind.speed, direction.y * kind.speed };
+        velocity.push_back(v);
+    }
+    if (has(GLYPH)) {
+        Glyph g = { kind.look, at.cellX, at.cellY };
+        glyph.push_back(g);
+    }
+    if (has(COLLIDER)) collider.push_back(kind.collider);
+    if (has(LIFETIME)) {
+        Lifetime l = { kind.lifetime };
+        lifetime.push_back(l);
+    }
+    if (has(COOLDOWN)) {
+        Cooldown c = { 0, kind.reload };
+        cooldown.push_back(c);
+    }
+    if (has(EXTENT)) extent.push_back(kind.extent);
+    alive.push_back(1);
+    return size() - 1;
+}
+
+// Writes ch over every cell an entity covers with its top left at (x, y)
+static void fillCells(const EntityPool& pool, int i, int x, int y, chtype ch) {
+    if (!pool.has(EXTENT)) {
+        mvaddch(y, x, ch);
+        return;
+    }
+    for (int row = 0; row < pool.extent[i].height; row++) {
+        for (int col = 0; col < pool.extent[i].width; col++) {
+            mvaddch(y + row, x + col, ch);
+        }
+    }
+}
+
+void EntityPool::kill(int i) {
+    if (!alive[i]) return;
+    alive[i] = 0;
+    if (has(GLYPH)) fillCells(*this, i, glyph[i].drawnX, glyph[i].drawnY, ' ');
+}
+
+// Stable removal of the dead from one array
+template <class T>
+static void keepAlive(std::vector<T>& values, const std::vector<unsigned char>& alive) {
+    if (values.empty()) return;
+    size_t kept = 0;
+    for (size_t i = 0; i < alive.size(); i++) {
+        if (alive[i]) values[kept++] = values[i];
+    }
+    values.resize(kept);
+}
+
+void EntityPool::compact() {
+    keepAlive(position, alive);
+    keepAlive(velocity, alive);
+    keepAlive(glyph, alive);
+    keepAlive(collider, alive);
+    keepAlive(lifetime, alive);
+    keepAlive(cooldown, alive);
+    keepAlive(extent, alive);
+    size_t living = position.size();
+    alive.assign(living, 1);
+}
+
+void EntityPool::clear() {
+    position.clear();
+    velocity.clear();
+    glyph.clear();
+    collider.clear();
+    lifetime.clear();
+    cooldown.clear();
+    extent.clear();
+    alive.clear();
+}
+
+void EntityPool::translate(int dx, int dy) {
+    for (Position& p : position) {
+        p.x += dx;
+        p.y += dy;
+        p.cellX += dx;
+        p.cellY += dy;
+    }
+    // Nothing is erased at the old place
+    for (Glyph& g : glyph) {
+        g.drawnX += dx;
+        g.drawnY += dy;
+    }
+}
+
+int EntityPool::findAt(int cellX, int cellY) const {
+    if (has(EXTENT)) {
+        for (int i = 0; i < size(); i++) {
+            int dx = cellX - position[i].cellX;
+            int dy = cellY - position[i].cellY;
+            if (alive[i] && dx >= 0 && dx < extent[i].width && dy >= 0 && dy < extent[i].height) return i;
+        }
+        return -1;
+    }
+    for (int i = 0; i < size(); i++) {
+        if (alive[i] && position[i].cellX == cellX && position[i].cellY == cellY) return i;
+    }
+    return -1;
+}
+
+void EntityPool::save(SnapshotBuffer& out) const {
+    out.put(alive, position, velocity, glyph, collider, lifetime, cooldown, extent);
+}
+
+void EntityPool::restore(SnapshotBuffer& in) {
+    in.get(alive, position, velocity, glyph, collider, lifetime, cooldown, extent);
+    // Drawn again where they are now, on a freshly cleared screen
+    for (size_t i = 0; i < glyph.size(); i++) {
+        glyph[i].drawnX = position[i].cellX;
+        glyph[i].drawnY = position[i].cellY;
+    }
+}
+
+void moveSystem(EntityPool& pool) {
+    if (!pool.has(POSITION | VELOCITY)) return;
+    for (int i = 0; i < pool.size(); i++) {
+        if (!pool.isAlive(i)) continue;
+        Position& p = pool.position[i];
+        p.x += pool.velocity[i].dx;
+        p.y += pool.velocity[i].dy;
+        p.cellX = p.x.cell();
+        p.cellY = p.y.cell();
+    }
+}
+
+void lifetimeSystem(EntityPool& pool) {
+    if (!pool.has(LIFETIME)) return;
+    for (int i = 0; i < pool.size(); i++) {
+        if (pool.isAlive(i) && --pool.lifetime[i].ticks <= 0) pool.kill(i);
+    }
+}
+
+void cooldownSystem(EntityPool& pool) {
+    if (!pool.has(COOLDOWN)) return;
+    for (Cooldown& c : pool.cooldown) {
+        if (c.ticks > 0) c.ticks--;
+    }
+}
+
+void cullSystem(EntityPool& pool, const BattleBox& box) {
+    if (!pool.has(POSITION)) return;
+    for (int i = 0; i < pool.size(); i++) {
+        if (pool.isAlive(i) && box.isOutside(pool.position[i].x, pool.position[i].y)) pool.kill(i);
+    }
+}
+
+void drawSystem(EntityPool& pool) {
+    if (!pool.has(POSITION | GLYPH)) return;
+    for (int i = 0; i < pool.size(); i++) {
+        if (!pool.isAlive(i)) continue;
+        const Position& p = pool.position[i];
+        Glyph& g = pool.glyph[i];
+        if (p.cellX != g.drawnX || p.cellY != g.drawnY) {
+            fillCells(pool, i, g.drawnX, g.drawnY, ' ');
+            g.drawnX = p.cellX;
+            g.drawnY = p.cellY;
+        }
+        // Redrawn every frame in case something else overwrote it
+        fillCells(pool, i, p.cellX, p.cellY, g.look);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include "fixed_point.h"
+#include "snapshot_ring.h"
+#include <ncursesw/ncurses.h>
+#include <vector>
+
+class BattleBox;
+
+// Components an entity kind can have
+enum Component : unsigned {
+    POSITION = 1 << 0,  // Where it is, and the cell that rounds to
+    VELOCITY = 1 << 1,  // Added to the position every tick
+    GLYPH    = 1 << 2,  // Character and attributes drawn at the cell
+    COLLIDER = 1 << 3,  // What touching or shooting it does
+    LIFETIME = 1 << 4,  // Ticks left before it expires
+    COOLDOWN = 1 << 5,  // Ticks until it may act (fire) again
+    EXTENT   = 1 << 6   // Covers more than one cell (a brick)
+};
+
+struct Position {
+    Fixed x, y;
+    int cellX, cellY;   // Rounded once per move; collisions compare these
+};
+
+struct Velocity {
+    Fixed dx, dy;
+};
+
+struct Glyph {
+    chtype look;        // Symbol | attributes, drawn with one mvaddch
+    int drawnX, drawnY; // Cell it was last drawn in, cleared when it moves
+};
+
+struct Collider {
+    int damage;         // Done to whatever it touches
+    int points;         // Scored for destroying it
+    int health;         // Hits it takes
+};
+
+struct Lifetime {
+    int ticks;
+};
+
+struct Cooldown {
+    int ticks;          // Ready at zero
+    int reload;         // Set again after acting
+};
+
+// Cells covered right of and below the position; the glyph fills them all
+// and collisions test all of them
+struct Extent {
+    int width, height;
+};
+
+// What a new entity of a kind starts with. Kinds are described once per
+// stage, e.g. { POSITION | VELOCITY | GLYPH, '+' | COLOR_PAIR(5), speed, ... }
+struct EntityKind {
+    unsigned components;
+    chtype look;
+    Fixed speed;        // Spawn direction is scaled by this
+    Collider collider;
+    int lifetime;
+    int reload;
+    Extent extent;      // Kinds without EXTENT may leave it out
+};
+
+// Every entity of one kind, each component the kind has kept as a dense
+// array with entity i at index i of all of them (an archetype). Systems walk
+// the arrays front to back instead of following a pointer per entity.
+// Arrays of components the kind lacks stay empty.
+//
+// Killing only marks an entity; compact() removes the dead ones, keeping
+// the others in order, so which of two entities in a cell is hit first
+// does not change from tick to tick.
+class EntityPool {
+private:
+    EntityKind kind;
+    std::vector<unsigned char> alive;
+
+public:
+    std::vector<Position> position;
+    std::vector<Velocity> velocity;
+    std::vector<Glyph> glyph;
+    std::vector<Collider> collider;
+    std::vector<Lifetime> lifetime;
+    std::vector<Cooldown> cooldown;
+    std::vector<Extent> extent;
+
+    explicit EntityPool(const EntityKind& entityKind);
+
+    // Makes room for count entities up front, so spawning up to that many
+    // during play never reallocates
+    void reserve(int count);
+
+    bool has(unsigned components) const { return (kind.components & components) == components; }
+    int size() const { return static_cast<int>(alive.size()); }
+    bool isAlive(int i) const { return alive[i] != 0; }
+
+    // Adds an entity at (x, y) moving along direction (a unit vector) at
+    // the kind's speed; returns its index
+    int spawn(Fixed x, Fixed y, FixedVec2 direction = FixedVec2());
+
+    // Marks it dead and clears its glyph from the screen
+    void kill(int i);
+    void compact();
+    void clear();
+
+    // Shifts everything by whole cells when the layout moves
+    void translate(int dx, int dy);
+
+    // First living entity in (or, with EXTENT, covering) the cell, or -1
+    int findAt(int cellX, int cellY) const;
+
+    // Rewind support: the arrays as they are
+    void save(SnapshotBuffer& out) const;
+    void restore(SnapshotBuffer& in);
+};
+
+// Systems, run once per tick over a whole pool. Each skips pools without
+// the components it works on.
+void moveSystem(EntityPool& pool);                        // VELOCITY
+void lifetimeSystem(EntityPool& pool);                    // LIFETIME: kills at zero
+void cooldownSystem(EntityPool& pool);                    // COOLDOWN
+void cullSystem(EntityPool& pool, const BattleBox& box);  // Kills what left the box
+void drawSystem(EntityPool& pool);                        // GLYPH
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,76 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+// Splits a path into its directory and file name
+static void splitPath(const std::string& path, std::string& directory, std::string& name) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        directory = ".";
+        name = path;
+    } else {
+        directory = slash == 0 ? "/" : path.substr(0, slash);
+        name = path.substr(slash + 1);
+    }
+}
+
+FileWatcher::FileWatcher() : inotifyFd(-1) {}
+
+FileWatcher::~FileWatcher() {
+    if (inotifyFd >= 0) close(inotifyFd);
+}
+
+bool FileWatcher::watch(const std::string& path) {
+    if (inotifyFd < 0) {
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0) {
+            std::perror("inotify_init1");
+            return false;
+        }
+    }
+
+    std::string directory, name;
+    splitPath(path, directory, name);
+
+    // Closing after a write covers editing in place, moving in covers
+    // write-then-rename saves. Adding a directory twice returns the same
+    // descriptor.
+    int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        std::perror(directory.c_str());
+        return false;
+    }
+    directories[wd] = directory;
+    files.push_back(path);
+    return true;
+}
+
+std::vector<std::string> FileWatcher::changedFiles() {
+    std::vector<std::string> changed;
+    if (inotifyFd < 0) return changed;
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+        const char* p = buffer;
+        while (p < buffer + length) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto directory = directories.find(event->wd);
+            if (event->len == 0 || directory == directories.end()) continue;
+
+            for (const std::string& file : files) {
+                std::string fileDirectory, fileName;
+                splitPath(file, fileDirectory, fileName);
+                if (fileDirectory == directory->second && fileName == event->name &&
+                    std::find(changed.begin(), changed.end(), file) == changed.end()) {
+                    changed.push_back(file);
+                }
+            }
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,34 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Reports when watched files are rewritten, using inotify. The directory of
+// each file is watched rather than the file itself, so editors that save by
+// writing a new file and renaming it over the old one are still noticed.
+// fd() can be added to an epoll set; it is readable when changes are pending.
+class FileWatcher {
+private:
+    int inotifyFd;
+    std::map<int, std::string> directories;  // Watch descriptor -> directory
+    std::vector<std::string> files;          // Paths as given to watch()
+
+public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Returns false (after printing why) if the file's directory cannot be watched
+    bool watch(const std::string& path);
+
+    int fd() const { return inotifyFd; }
+
+    // Drains pending events without blocking and returns each watched file
+    // that was written or replaced since the last call, once
+    std::vector<std::string> changedFiles();
+};
+
+#endif // FILE_WATCHER_H
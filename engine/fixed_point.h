@@ -0,0 +1,123 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+#include <type_traits>
+
+// Q16.16 fixed-point number for game positions, directions and speeds:
+// 16 integer bits (far more than any terminal) and 16 fraction bits (1/65536
+// of a cell). Every operation is integer arithmetic, so a simulation gives
+// the same result bit for bit on any compiler and optimisation level, which
+// float expressions do not promise.
+//
+// Ints convert implicitly, so Fixed reads like the int and float code it
+// replaced (x += directionX * speed, y = top + 1). Floating-point values must
+// be converted by name, Fixed(0.95f), so a float expression cannot slip into
+// the simulation unnoticed. There is no implicit conversion back: cell()
+// rounds to a screen cell, toFloat() is for display only.
+class Fixed {
+private:
+    int32_t value;
+
+    struct RawTag {};
+    constexpr Fixed(int32_t raw, RawTag) : value(raw) {}
+
+public:
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    constexpr Fixed() : value(0) {}
+    // Integers only: a float must not reach this by truncation
+    template <typename Int, typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+    constexpr Fixed(Int whole) : value(static_cast<int32_t>(whole) * ONE) {}
+    explicit constexpr Fixed(double real)
+        : value(static_cast<int32_t>(real * ONE + (real < 0 ? -0.5 : 0.5))) {}
+
+    static constexpr Fixed fromRaw(int32_t raw) { return Fixed(raw, RawTag()); }
+    constexpr int32_t raw() const { return value; }
+
+    // Nearest cell, halves rounded up (same as std::round for the positive
+    // coordinates the stages use)
+    constexpr int cell() const { return (value + ONE / 2) >> FRACTION_BITS; }
+    constexpr int floor() const { return value >> FRACTION_BITS; }
+    constexpr float toFloat() const { return static_cast<float>(value) / ONE; }
+
+    constexpr Fixed operator-() const { return fromRaw(-value); }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.value + b.value); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.value - b.value); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(a.value) * b.value) >> FRACTION_BITS));
+    }
+    // Dividing by zero saturates towards the sign of a (0 / 0 is 0) rather
+    // than trapping, like a float heading for infinity
+    friend constexpr Fixed operator/(Fixed a, Fixed b) {
+        return b.value != 0 ? fromRaw(static_cast<int32_t>((static_cast<int64_t>(a.value) * ONE) / b.value))
+             : a.value > 0 ? fromRaw(INT32_MAX)
+             : a.value < 0 ? fromRaw(INT32_MIN)
+             : Fixed();
+    }
+
+    Fixed& operator+=(Fixed other) { return *this = *this + other; }
+    Fixed& operator-=(Fixed other) { return *this = *this - other; }
+    Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.value == b.value; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a.value != b.value; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.value < b.value; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.value <= b.value; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.value > b.value; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.value >= b.value; }
+
+    friend constexpr Fixed abs(Fixed a) { return a.value < 0 ? -a : a; }
+    friend constexpr Fixed min(Fixed a, Fixed b) { return a < b ? a : b; }
+    friend constexpr Fixed max(Fixed a, Fixed b) { return a < b ? b : a; }
+    friend Fixed sqrt(Fixed a);
+};
+
+// Integer square root, rounded down, so normalising a direction is exact too
+inline Fixed sqrt(Fixed a) {
+    if (a.value <= 0) return Fixed();
+    // sqrt(v / 2^16) * 2^16 = sqrt(v * 2^16)
+    uint64_t n = static_cast<uint64_t>(a.value) << Fixed::FRACTION_BITS;
+    uint64_t root = 0;
+    uint64_t bit = uint64_t(1) << 62;
+    while (bit > n) bit >>= 2;
+    while (bit != 0) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return Fixed::fromRaw(static_cast<int32_t>(root));
+}
+
+// A position or direction in cells
+struct FixedVec2 {
+    Fixed x, y;
+
+    constexpr FixedVec2() {}
+    constexpr FixedVec2(Fixed vx, Fixed vy) : x(vx), y(vy) {}
+
+    int cellX() const { return x.cell(); }
+    int cellY() const { return y.cell(); }
+
+    FixedVec2 operator+(FixedVec2 other) const { return FixedVec2(x + other.x, y + other.y); }
+    FixedVec2 operator-(FixedVec2 other) const { return FixedVec2(x - other.x, y - other.y); }
+    FixedVec2 operator*(Fixed scale) const { return FixedVec2(x * scale, y * scale); }
+    FixedVec2& operator+=(FixedVec2 other) { x += other.x; y += other.y; return *this; }
+
+    Fixed length() const { return sqrt(x * x + y * y); }
+
+    // Same direction, length 1; the zero vector stays zero
+    FixedVec2 normalized() const {
+        Fixed size = length();
+        return size == Fixed() ? *this : FixedVec2(x / size, y / size);
+    }
+};
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,266 @@
+#define NCURSES_WIDECHAR 1
+#include "frame_encoder.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Attribute bits that map onto SGR codes; colour and charset are handled separately
+const uint32_t SGR_ATTRS = A_BOLD | A_DIM | A_UNDERLINE | A_BLINK | A_REVERSE | A_STANDOUT;
+
+// Line-drawing characters are stored by ncurses as VT100 alternate charset
+// letters. Translate them so recordings replay on any UTF-8 terminal.
+uint32_t translateAcs(uint32_t ch) {
+    switch (ch) {
+        case '`': return 0x25C6; // diamond (the heart in every stage)
+        case 'a': return 0x2592; // checker board
+        case 'f': return 0x00B0; // degree
+        case 'g': return 0x00B1; // plus/minus
+        case 'h': return 0x2592; // board of squares
+        case 'j': return 0x2518; // lower right corner
+        case 'k': return 0x2510; // upper right corner
+        case 'l': return 0x250C; // upper left corner
+        case 'm': return 0x2514; // lower left corner
+        case 'n': return 0x253C; // cross
+        case 'o': return 0x23BA; // scan line 1
+        case 'p': return 0x23BB; // scan line 3
+        case 'q': return 0x2500; // horizontal line
+        case 'r': return 0x23BC; // scan line 7
+        case 's': return 0x23BD; // scan line 9
+        case 't': return 0x251C; // left tee
+        case 'u': return 0x2524; // right tee
+        case 'v': return 0x2534; // bottom tee
+        case 'w': return 0x252C; // top tee
+        case 'x': return 0x2502; // vertical line
+        case 'y': return 0x2264; // less or equal
+        case 'z': return 0x2265; // greater or equal
+        case '{': return 0x03C0; // pi
+        case '|': return 0x2260; // not equal
+        case '}': return 0x00A3; // pound
+        case '~': return 0x00B7; // bullet
+        case '0': return 0x2588; // solid block
+        case ',': return 0x2190; // arrow left
+        case '+': return 0x2192; // arrow right
+        case '.': return 0x2193; // arrow down
+        case '-': return 0x2191; // arrow up
+        default:  return ch;
+    }
+}
+
+void appendNumber(std::string& out, int value) {
+    char buf[16];
+    int len = std::snprintf(buf, sizeof(buf), "%d", value);
+    out.append(buf, len);
+}
+
+void appendColour(std::string& out, short colour, int base, int brightBase) {
+    out += ';';
+    if (colour < 0) {
+        appendNumber(out, base + 9); // default colour
+    } else if (colour < 8) {
+        appendNumber(out, base + colour);
+    } else if (colour < 16) {
+        appendNumber(out, brightBase + colour - 8);
+    } else {
+        appendNumber(out, base + 8);
+        out += ";5;";
+        appendNumber(out, colour);
+    }
+}
+
+} // namespace
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+ScreenFrame::ScreenFrame() : rows(0), cols(0) {}
+
+void ScreenFrame::resize(int newRows, int newCols) {
+    rows = newRows;
+    cols = newCols;
+    ScreenCell blank = {' ', 0, 0};
+    cells.assign(static_cast<size_t>(rows) * cols, blank);
+    cchar_t empty;
+    std::memset(&empty, 0, sizeof(empty));
+    raw.assign(static_cast<size_t>(rows) * cols, empty);
+    line.assign(cols + 1, empty);
+    dirty.assign(rows, 1);
+}
+
+void ScreenFrame::capture(WINDOW* win) {
+    int maxY, maxX;
+    getmaxyx(win, maxY, maxX);
+    bool resized = maxY != rows || maxX != cols;
+    if (resized) {
+        resize(maxY, maxX);
+    }
+
+    const size_t rowBytes = sizeof(cchar_t) * cols;
+    for (int y = 0; y < rows; y++) {
+        cchar_t* saved = &raw[static_cast<size_t>(y) * cols];
+        if (mvwin_wchnstr(win, y, 0, &line[0], cols) == ERR) {
+            std::memset(&line[0], 0, rowBytes);
+        }
+        if (!resized && std::memcmp(saved, &line[0], rowBytes) == 0) {
+            dirty[y] = 0;
+            continue;
+        }
+        std::memcpy(saved, &line[0], rowBytes);
+        dirty[y] = 1;
+
+        for (int x = 0; x < cols; x++) {
+            ScreenCell& cell = at(y, x);
+            wchar_t wch[CCHARW_MAX + 1];
+            attr_t attrs = 0;
+            short pair = 0;
+            if (getcchar(&saved[x], wch, &attrs, &pair, nullptr) == ERR) {
+                wch[0] = ' ';
+            }
+
+            uint32_t ch = wch[0] ? static_cast<uint32_t>(wch[0]) : ' ';
+            if (attrs & A_ALTCHARSET) {
+                ch = translateAcs(ch);
+            }
+            cell.ch = ch;
+            cell.attr = attrs & SGR_ATTRS;
+            cell.pair = pair;
+        }
+    }
+}
+
+FrameEncoder::FrameEncoder(int keyframeEvery)
+    : keyframeInterval(keyframeEvery), framesSinceKeyframe(0), keyframePending(true),
+      penAttr(0), penPair(0), penY(-1), penX(-1) {}
+
+void FrameEncoder::requestKeyframe() {
+    keyframePending = true;
+}
+
+void FrameEncoder::setPen(std::string& out, uint32_t attr, short pair) {
+    if (attr == penAttr && pair == penPair) return;
+
+    out += "\x1b[0";
+    if (attr & A_BOLD) out += ";1";
+    if (attr & A_DIM) out += ";2";
+    if (attr & A_UNDERLINE) out += ";4";
+    if (attr & A_BLINK) out += ";5";
+    if (attr & (A_REVERSE | A_STANDOUT)) out += ";7";
+    if (pair != 0) {
+        short fg = -1, bg = -1;
+        if (pair_content(pair, &fg, &bg) == ERR) {
+            fg = -1;
+            bg = -1;
+        }
+        appendColour(out, fg, 30, 90);
+        appendColour(out, bg, 40, 100);
+    }
+    out += 'm';
+
+    penAttr = attr;
+    penPair = pair;
+}
+
+void FrameEncoder::moveTo(std::string& out, int y, int x) {
+    if (y == penY && x == penX) return;
+    out += "\x1b[";
+    appendNumber(out, y + 1);
+    out += ';';
+    appendNumber(out, x + 1);
+    out += 'H';
+    penY = y;
+    penX = x;
+}
+
+void FrameEncoder::putCell(std::string& out, const ScreenCell& cell) {
+    setPen(out, cell.attr, cell.pair);
+    appendUtf8(out, cell.ch);
+    penX++;
+    // Writing the last column leaves the terminal in a pending-wrap state,
+    // so always position explicitly after it
+    if (penX >= current.getCols()) {
+        penX = -1;
+        penY = -1;
+    }
+}
+
+void FrameEncoder::encodeFull(std::string& out) {
+    // Reset attributes, hide the cursor and clear, then paint every non-blank
+    // cell as a diff against an empty screen
+    out += "\x1b[0m\x1b[?25l\x1b[H\x1b[2J";
+    penAttr = 0;
+    penPair = 0;
+    penY = 0;
+    penX = 0;
+
+    previous.resize(current.getRows(), current.getCols());
+    encodeDiff(out, true);
+}
+
+bool FrameEncoder::encodeDiff(std::string& out, bool allRows) {
+    const size_t startSize = out.size();
+    // Re-sending a few unchanged cells is cheaper than a cursor move sequence
+    const int maxGap = 4;
+
+    for (int y = 0; y < current.getRows(); y++) {
+        if (!allRows && !current.isRowDirty(y)) continue;
+
+        int lastWritten = -100;
+        for (int x = 0; x < current.getCols(); x++) {
+            const ScreenCell& cell = current.at(y, x);
+            if (cell == previous.at(y, x)) continue;
+
+            if (penY == y && penX >= 0 && x > penX && x - penX <= maxGap && lastWritten == penX - 1) {
+                for (int gap = penX; gap < x; gap++) {
+                    putCell(out, current.at(y, gap));
+                }
+            } else {
+                moveTo(out, y, x);
+            }
+            putCell(out, cell);
+            previous.at(y, x) = cell;
+            lastWritten = x;
+        }
+    }
+    return out.size() != startSize;
+}
+
+bool FrameEncoder::encode(std::string& out, bool& isKeyframe) {
+    int oldRows = current.getRows();
+    int oldCols = current.getCols();
+    current.capture(curscr);
+
+    isKeyframe = keyframePending ||
+                 current.getRows() != oldRows ||
+                 current.getCols() != oldCols ||
+                 (keyframeInterval > 0 && framesSinceKeyframe >= keyframeInterval);
+
+    if (isKeyframe) {
+        encodeFull(out);
+        keyframePending = false;
+        framesSinceKeyframe = 0;
+        return true;
+    }
+
+    framesSinceKeyframe++;
+    return encodeDiff(out, false);
+}
+
+bool FrameEncoder::encode(std::string& out) {
+    bool isKeyframe;
+    return encode(out, isKeyframe);
+}
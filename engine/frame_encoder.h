@@ -0,0 +1,85 @@
+#ifndef FRAME_ENCODER_H
+#define FRAME_ENCODER_H
+
+#include <ncursesw/ncurses.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// One character cell as it was last sent to the terminal
+struct ScreenCell {
+    uint32_t ch;    // Unicode code point (ACS glyphs already translated)
+    uint32_t attr;  // A_BOLD, A_REVERSE, ... without colour or charset bits
+    short pair;     // Colour pair number
+
+    bool operator==(const ScreenCell& other) const {
+        return ch == other.ch && attr == other.attr && pair == other.pair;
+    }
+    bool operator!=(const ScreenCell& other) const { return !(*this == other); }
+};
+
+// Copy of the whole terminal screen, read back from curscr after a refresh.
+// The raw ncurses cells are kept so rows that did not change since the last
+// capture can be skipped with a memcmp instead of being decoded again.
+class ScreenFrame {
+private:
+    int rows, cols;
+    std::vector<ScreenCell> cells;
+    std::vector<cchar_t> raw;
+    std::vector<cchar_t> line;        // Scratch row for mvwin_wchnstr
+    std::vector<unsigned char> dirty; // Rows changed by the last capture
+
+public:
+    ScreenFrame();
+
+    void capture(WINDOW* win);
+    void resize(int newRows, int newCols);
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    bool isRowDirty(int y) const { return dirty[y] != 0; }
+    const ScreenCell& at(int y, int x) const { return cells[y * cols + x]; }
+    ScreenCell& at(int y, int x) { return cells[y * cols + x]; }
+};
+
+// Turns consecutive screen captures into ANSI byte streams.
+// Normal frames only contain the cells that changed since the previous
+// frame; every keyframeInterval frames (or after a resize) a full repaint
+// is produced so a player can start from that point.
+class FrameEncoder {
+private:
+    ScreenFrame previous;  // What the output stream currently shows
+    ScreenFrame current;
+    int keyframeInterval;
+    int framesSinceKeyframe;
+    bool keyframePending;
+
+    uint32_t penAttr;  // SGR state of the output stream while encoding
+    short penPair;
+    int penY, penX;    // Cursor position of the output stream, -1 if unknown
+
+    void setPen(std::string& out, uint32_t attr, short pair);
+    void moveTo(std::string& out, int y, int x);
+    void putCell(std::string& out, const ScreenCell& cell);
+    void encodeFull(std::string& out);
+    bool encodeDiff(std::string& out, bool allRows);
+
+public:
+    explicit FrameEncoder(int keyframeEvery = 300);
+
+    // Reads the screen and appends the encoded update to out.
+    // Returns false (and appends nothing) if the screen did not change.
+    bool encode(std::string& out, bool& isKeyframe);
+    bool encode(std::string& out);
+
+    // Make the next encode() emit a full repaint
+    void requestKeyframe();
+
+    int getRows() const { return current.getRows(); }
+    int getCols() const { return current.getCols(); }
+};
+
+// Append a code point to a UTF-8 string
+void appendUtf8(std::string& out, uint32_t codePoint);
+
+#endif // FRAME_ENCODER_H
@@ -0,0 +1,29 @@
+#include "frame_timer.h"
+#include "stage_result.h"
+#include <thread>
+
+FrameTimer::FrameTimer(int fps, bool report)
+    : period(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / fps),
+      nextFrame(std::chrono::steady_clock::now() + period), frameStart(nextFrame - period),
+      reported(report) {}
+
+void FrameTimer::wait() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    unsigned dropped = 0;
+    if (now > nextFrame + period) {
+        dropped = static_cast<unsigned>((now - nextFrame) / period);
+        nextFrame = now;
+    } else {
+        std::this_thread::sleep_until(nextFrame);
+    }
+    if (reported) {
+        stageResult().addFrame(std::chrono::duration<double>(now - frameStart).count(), dropped);
+    }
+    nextFrame += period;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void FrameTimer::reset() {
+    frameStart = std::chrono::steady_clock::now();
+    nextFrame = frameStart + period;
+}
@@ -0,0 +1,30 @@
+#ifndef FRAME_TIMER_H
+#define FRAME_TIMER_H
+
+#include <chrono>
+
+// Paces a game loop at a fixed rate. Unlike a plain usleep(16667) after
+// each frame, the time spent updating and drawing counts towards the frame,
+// so the loop runs at the real rate instead of drifting slower.
+// Each frame's work time and any frames skipped go into stageResult(),
+// unless the timer is made with report = false (loops that are not the
+// game, such as the dialogue box, so they don't skew its figures).
+class FrameTimer {
+private:
+    std::chrono::steady_clock::duration period;
+    std::chrono::steady_clock::time_point nextFrame;
+    std::chrono::steady_clock::time_point frameStart;  // When the last wait() returned
+    bool reported;
+
+public:
+    explicit FrameTimer(int fps = 60, bool report = true);
+
+    // Sleeps until the next frame is due. If the loop has fallen more than a
+    // frame behind, the schedule restarts from now instead of rushing.
+    void wait();
+
+    // Restart the schedule, e.g. after blocking on a dialogue box
+    void reset();
+};
+
+#endif // FRAME_TIMER_H
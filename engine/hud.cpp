@@ -0,0 +1,165 @@
+#include "hud.h"
+#include <cstdio>
+
+BattleBox::BattleBox(int startX, int startY, int w, int h) :
+    x(startX), y(startY), width(w), height(h), needsRedraw(true) {}
+
+void BattleBox::draw() {
+    if (!needsRedraw) return;
+    
+    // Enable reverse highlighting
+    attron(A_REVERSE);
+
+    // Draw the top and bottom borders of the battle box
+    for (int i = -1; i <= width+1; i++) {
+        mvaddch(y, x + i, ' ');              // Top border (space with reverse highlight)
+        mvaddch(y + height, x + i, ' ');     // Bottom border
+    }
+
+    // Draw the left and right borders of the battle box
+    for (int i = 0; i <= height; i++) {
+        mvaddch(y + i, x, ' ');              // Left border
+        mvaddch(y + i, x + width, ' ');      // Right border
+        mvaddch(y + i, x-1, ' ');            // Left border
+        mvaddch(y + i, x+1 + width, ' ');    // Right border
+    }
+
+    // Disable reverse highlighting
+    attroff(A_REVERSE);
+    
+    needsRedraw = false;
+}
+
+void BattleBox::setNeedsRedraw() {
+    needsRedraw = true;
+}
+
+void BattleBox::moveTo(int newX, int newY) {
+    x = newX;
+    y = newY;
+    needsRedraw = true;
+}
+
+bool BattleBox::contains(Fixed checkX, Fixed checkY) const {
+    int ix = checkX.cell();
+    int iy = checkY.cell();
+    return (ix > x && ix < x + width && iy > y && iy < y + height);
+}
+
+bool BattleBox::isOutside(Fixed checkX, Fixed checkY) const {
+    return !contains(checkX, checkY);
+}
+
+void drawHealthBar(WINDOW* win, int x, int y, int maxHP, int currentHP) {
+    if (win == NULL) win = stdscr;
+
+    mvwprintw(win, y, x, "HP: %d/%d [", currentHP, maxHP);
+    
+    int barWidth = 20; // Width of the health bar
+    int filledWidth = static_cast<int>((static_cast<float>(currentHP) / maxHP) * barWidth);
+    
+    for (int i = 0; i < barWidth; i++) {
+        if (i < filledWidth) {
+            wattron(win, COLOR_PAIR(1)); // Red for filled health
+            waddch(win, '=');
+            wattroff(win, COLOR_PAIR(1));
+        } else {
+            waddch(win, '-');
+        }
+    }
+    waddch(win, ']');
+}
+
+void drawHealthBar(int x, int y, int maxHP, int currentHP) {
+    drawHealthBar(stdscr, x, y, maxHP, currentHP);
+}
+
+// Blanks width cells from (x, y) on
+static void blank(WINDOW* win, int x, int y, int width) {
+    if (width > 0) mvwprintw(win, y, x, "%*s", width, "");
+}
+
+HudText::HudText(Align alignment) :
+    align(alignment), win(NULL), format(NULL), x(0), y(0), values(), attrs(0),
+    shownX(0), shownY(0), shownWidth(0), stale(true) {}
+
+bool HudText::show(WINDOW* window, int atX, int atY, attr_t textAttrs, const char* textFormat,
+                   int a, int b, int c) {
+    if (window == NULL) window = stdscr;
+    if (!stale && window == win && textFormat == format && atX == x && atY == y &&
+        textAttrs == attrs && a == values[0] && b == values[1] && c == values[2]) {
+        return false;
+    }
+
+    char text[128];
+    int width = std::snprintf(text, sizeof(text), textFormat, a, b, c);
+    if (width < 0) width = 0;
+    if (width >= static_cast<int>(sizeof(text))) width = sizeof(text) - 1;
+    int left = align == CENTRE ? atX - width / 2 : atX;
+
+    // Blank whatever the old text covered that the new one will not
+    if (!stale && win == window) {
+        if (shownY != atY) {
+            blank(win, shownX, shownY, shownWidth);
+        } else {
+            blank(win, shownX, shownY, left - shownX);
+            int end = left + width;
+            blank(win, end, shownY, shownX + shownWidth - end);
+        }
+    }
+
+    if (textAttrs) wattron(window, textAttrs);
+    mvwaddstr(window, atY, left, text);
+    if (textAttrs) wattroff(window, textAttrs);
+
+    win = window;
+    format = textFormat;
+    x = atX;
+    y = atY;
+    attrs = textAttrs;
+    values[0] = a;
+    values[1] = b;
+    values[2] = c;
+    shownX = left;
+    shownY = atY;
+    shownWidth = width;
+    stale = false;
+    return true;
+}
+
+bool HudText::show(int atX, int atY, attr_t textAttrs, const char* textFormat, int a, int b, int c) {
+    return show(stdscr, atX, atY, textAttrs, textFormat, a, b, c);
+}
+
+void HudText::hide() {
+    if (win != NULL && !stale) blank(win, shownX, shownY, shownWidth);
+    shownWidth = 0;
+    stale = true;
+}
+
+HudHealthBar::HudHealthBar() :
+    win(NULL), x(0), y(0), maxHP(0), currentHP(0), shownWidth(0), stale(true) {}
+
+bool HudHealthBar::show(WINDOW* window, int atX, int atY, int maxHealth, int health) {
+    if (window == NULL) window = stdscr;
+    if (!stale && window == win && atX == x && atY == y && maxHealth == maxHP && health == currentHP) {
+        return false;
+    }
+
+    // The bar is 20 cells after "HP: 7/10 [", and one shorter at 9 HP than at 10
+    if (!stale && win == window) blank(win, x, y, shownWidth);
+    drawHealthBar(window, atX, atY, maxHealth, health);
+
+    win = window;
+    x = atX;
+    y = atY;
+    maxHP = maxHealth;
+    currentHP = health;
+    shownWidth = getcurx(window) - atX;
+    stale = false;
+    return true;
+}
+
+bool HudHealthBar::show(int atX, int atY, int maxHealth, int health) {
+    return show(stdscr, atX, atY, maxHealth, health);
+}
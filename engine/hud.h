@@ -0,0 +1,101 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <ncursesw/ncurses.h>
+#include "fixed_point.h"
+
+// Arena border used by the battle stages: a reverse-video frame two cells
+// thick on the sides so it looks square in a terminal
+class BattleBox {
+private:
+    int x, y;         // Top-left corner position
+    int width, height; // Box dimensions
+    bool needsRedraw;  // Flag to determine if the box needs redrawing
+
+public:
+    BattleBox(int startX, int startY, int w, int h);
+    BattleBox() : x(0), y(0), width(0), height(0), needsRedraw(false) {}
+
+    // Draws the border if it was marked for redrawing since the last draw
+    void draw();
+    void setNeedsRedraw();
+
+    // Moves the top-left corner, e.g. after a terminal resize; the border is
+    // drawn at the new place by the next draw()
+    void moveTo(int newX, int newY);
+
+    // Check if a position is strictly inside the border
+    bool contains(Fixed checkX, Fixed checkY) const;
+    bool isOutside(Fixed checkX, Fixed checkY) const;
+
+    int getX() const { return x; }
+    int getY() const { return y; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getInnerMinX() const { return x + 1; }
+    int getInnerMinY() const { return y + 1; }
+    int getInnerMaxX() const { return x + width - 1; }
+    int getInnerMaxY() const { return y + height - 1; }
+    int getCenterX() const { return x + width / 2; }
+    int getCenterY() const { return y + height / 2; }
+};
+
+// "HP: 7/10 [==============------]" with the filled part in colour pair 1.
+// A NULL window draws to stdscr.
+void drawHealthBar(WINDOW* win, int x, int y, int maxHP, int currentHP);
+void drawHealthBar(int x, int y, int maxHP, int currentHP);
+
+// Retained HUD widgets. A game loop calls show() every frame as it would
+// mvprintw, but the text is only formatted and written when something in it
+// changed, so a score that changes a few times a round costs a few writes a
+// round instead of sixty a second, and ncurses has no HUD lines to compare.
+// Call invalidate() after anything cleared the screen under a widget.
+
+// A line of text with up to three numbers in it, e.g. "Round: %d  Score: %d".
+// The format must be a literal (it is compared by address). When the text
+// gets shorter or moves, the cells it no longer covers are blanked.
+class HudText {
+public:
+    enum Align { LEFT, CENTRE };  // x is the first column, or the middle one
+
+private:
+    Align align;
+    WINDOW* win;
+    const char* format;
+    int x, y, values[3];
+    attr_t attrs;
+    int shownX, shownY, shownWidth;  // Cells the text covers on screen
+    bool stale;
+
+public:
+    explicit HudText(Align alignment = LEFT);
+
+    // attrs are turned on for the text only; 0 uses the window's current ones.
+    // Returns whether it wrote anything.
+    bool show(WINDOW* window, int atX, int atY, attr_t textAttrs, const char* textFormat,
+              int a = 0, int b = 0, int c = 0);
+    bool show(int atX, int atY, attr_t textAttrs, const char* textFormat,
+              int a = 0, int b = 0, int c = 0);
+
+    // Blanks the text, e.g. a hint that no longer applies
+    void hide();
+    void invalidate() { stale = true; }
+};
+
+// drawHealthBar() that only redraws when the health or place changes
+class HudHealthBar {
+private:
+    WINDOW* win;
+    int x, y, maxHP, currentHP;
+    int shownWidth;
+    bool stale;
+
+public:
+    HudHealthBar();
+
+    bool show(WINDOW* window, int atX, int atY, int maxHealth, int health);
+    bool show(int atX, int atY, int maxHealth, int health);
+    void invalidate() { stale = true; }
+};
+
+#endif // HUD_H
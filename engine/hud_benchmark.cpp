@@ -0,0 +1,90 @@
+// Times the 1340 HUD (score line and health bar) drawn every frame with
+// mvprintw and drawHealthBar against the retained HudText and HudHealthBar,
+// on a headless ncurses screen whose output goes to a temporary file, so the
+// bytes ncurses sends to the terminal can be counted too.
+// Usage: hud_benchmark [frames]
+#include "hud.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Result {
+    double drawTime, refreshTime;
+    long bytes;
+    long redraws;
+};
+
+// Score goes up every 45 frames and health down every 200, about as often
+// as in a busy round
+static void values(long frame, int& score, int& health) {
+    score = static_cast<int>(frame / 45) * 100;
+    health = 10 - static_cast<int>(frame / 200) % 10;
+}
+
+static Result run(bool retained, long frames, FILE* out) {
+    Result result = { 0, 0, 0, 0 };
+    HudText stats;
+    HudHealthBar healthBar;
+    clear();
+    refresh();
+    long before = std::ftell(out);
+
+    for (long frame = 0; frame < frames; frame++) {
+        int score, health;
+        values(frame, score, health);
+
+        auto start = std::chrono::steady_clock::now();
+        attron(COLOR_PAIR(7));
+        if (retained) {
+            result.redraws += stats.show(20, 3, 0, "Round: %d  Score: %d", 1, score);
+            result.redraws += healthBar.show(20, 4, 10, health);
+        } else {
+            mvprintw(3, 20, "Round: %d  Score: %d", 1, score);
+            drawHealthBar(20, 4, 10, health);
+            result.redraws += 2;
+        }
+        attroff(COLOR_PAIR(7));
+        result.drawTime += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        refresh();
+        std::fflush(out);
+        result.refreshTime += secondsSince(start);
+    }
+    result.bytes = std::ftell(out) - before;
+    return result;
+}
+
+static void report(const char* name, double before, double after, long frames, const char* unit) {
+    std::printf("%-24s %9.3f -> %9.3f %s  (%.1fx)\n", name,
+                before / frames, after / frames, unit, after > 0 ? before / after : 0.0);
+}
+
+int main(int argc, char* argv[]) {
+    long frames = argc > 1 ? std::atol(argv[1]) : 6000;
+
+    FILE* out = std::tmpfile();
+    FILE* in = std::fopen("/dev/null", "r");
+    if (out == NULL || in == NULL || newterm("xterm-256color", out, in) == NULL) {
+        std::fprintf(stderr, "hud_benchmark: no headless terminal\n");
+        return 1;
+    }
+    start_color();
+    init_pair(1, COLOR_RED, COLOR_BLACK);
+    init_pair(7, COLOR_WHITE, COLOR_BLACK);
+
+    Result immediate = run(false, frames, out);
+    Result retained = run(true, frames, out);
+    endwin();
+
+    std::printf("%ld frames, per frame: immediate -> retained\n", frames);
+    report("HUD draw", immediate.drawTime * 1e6, retained.drawTime * 1e6, frames, "us");
+    report("refresh", immediate.refreshTime * 1e6, retained.refreshTime * 1e6, frames, "us");
+    report("widgets formatted", immediate.redraws, retained.redraws, frames, "  ");
+    report("bytes to terminal", immediate.bytes, retained.bytes, frames, "B ");
+    return 0;
+}
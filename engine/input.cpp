@@ -0,0 +1,28 @@
+#include "input.h"
+#include "screen.h"
+#include "startup_timer.h"
+#include <ncursesw/ncurses.h>
+
+bool isEnterKey(int ch) {
+    return ch == '\n' || ch == '\r' || ch == KEY_ENTER;
+}
+
+void waitForEnter() {
+    InputMode input(InputMode::BLOCKING);
+    markStartup(STARTUP_INPUT);
+    flushinp();
+    int ch;
+    do {
+        ch = getch();
+    } while (!isEnterKey(ch));
+}
+
+bool enterPressed() {
+    int ch;
+    bool pressed = false;
+    markStartup(STARTUP_INPUT);
+    while ((ch = getch()) != ERR) {
+        if (isEnterKey(ch)) pressed = true;
+    }
+    return pressed;
+}
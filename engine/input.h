@@ -0,0 +1,14 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// Enter arrives as '\n', '\r' or KEY_ENTER depending on the terminal mode
+bool isEnterKey(int ch);
+
+// Discards pending keys, then blocks until Enter is pressed (whatever the
+// current nodelay mode, which is restored afterwards)
+void waitForEnter();
+
+// Non-blocking: drains pending keys and reports whether Enter was among them
+bool enterPressed();
+
+#endif // INPUT_H
@@ -0,0 +1,206 @@
+// Simulates many players against the session server.
+// Usage: load_generator [socket] [players] [seconds] [server pid] [spectators]
+// Each fake player connects, presses keys at random and reads every frame.
+// Spectators all watch the newest session and only read.
+// With a server pid the server's CPU time and memory are reported per player.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct FakePlayer {
+    int fd;
+    unsigned long bytes;
+    unsigned long reads;
+    double lastReceive;   // Seconds since start
+    double longestGap;    // Longest silence between two reads
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// utime + stime of a process in seconds, -1 if unavailable
+static double processCpuSeconds(int pid) {
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) return -1;
+
+    // Fields after the command name, which is wrapped in parentheses
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    unsigned long utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && fields >> field; i++) {
+        if (i == 14) utime = std::strtoul(field.c_str(), nullptr, 10);
+        if (i == 15) stime = std::strtoul(field.c_str(), nullptr, 10);
+    }
+    return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+// Resident memory of a process in kB, -1 if unavailable
+static long processRssKb(int pid) {
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : "/tmp/year1_1340.sock";
+    int playerCount = argc > 2 ? std::atoi(argv[2]) : 100;
+    int duration = argc > 3 ? std::atoi(argv[3]) : 30;
+    int serverPid = argc > 4 ? std::atoi(argv[4]) : 0;
+    int spectatorCount = argc > 5 ? std::atoi(argv[5]) : 0;
+
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int epollFd = epoll_create1(0);
+    std::vector<FakePlayer> players(playerCount + spectatorCount);
+    double cpuBefore = serverPid ? processCpuSeconds(serverPid) : -1;
+    long rssBefore = serverPid ? processRssKb(serverPid) : -1;
+    auto start = std::chrono::steady_clock::now();
+
+    int connected = 0;
+    for (int i = 0; i < playerCount + spectatorCount; i++) {
+        bool spectator = i >= playerCount;
+        FakePlayer& player = players[i];
+        player.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        player.bytes = 0;
+        player.reads = 0;
+        player.lastReceive = 0;
+        player.longestGap = 0;
+        if (connect(player.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            std::perror("connect");
+            close(player.fd);
+            player.fd = -1;
+            continue;
+        }
+        // Connect blocks while the server's backlog is full; reads must not
+        fcntl(player.fd, F_SETFL, O_NONBLOCK);
+
+        // 80x24 terminal, then Enter to get past the round intro
+        const char* hello = spectator ? "WATCH\n" : "YEAR1 80 24\n\r";
+        if (send(player.fd, hello, std::strlen(hello), MSG_NOSIGNAL) < 0) {
+            close(player.fd);
+            player.fd = -1;
+            continue;
+        }
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, player.fd, &event);
+        if (!spectator) connected++;
+    }
+    std::printf("Connected %d/%d players and %d spectators for %d s\n",
+                connected, playerCount, spectatorCount, duration);
+
+    // Keypad-mode arrow keys, fire, toggle movement and Enter for the menus
+    const char* keys[] = { "\x1bOA", "\x1bOB", "\x1bOC", "\x1bOD", "f", "f", " ", "\r" };
+    const int keyCount = sizeof(keys) / sizeof(keys[0]);
+
+    char buffer[65536];
+    epoll_event events[256];
+    double nextInput = 0;
+    while (secondsSince(start) < duration) {
+        int count = epoll_wait(epollFd, events, 256, 10);
+        double now = secondsSince(start);
+
+        for (int i = 0; i < count; i++) {
+            FakePlayer& player = players[events[i].data.u32];
+            ssize_t n;
+            while ((n = read(player.fd, buffer, sizeof(buffer))) > 0) {
+                player.bytes += n;
+            }
+            if (n == 0) {
+                // Session finished (or server went away)
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, player.fd, nullptr);
+                close(player.fd);
+                player.fd = -1;
+                continue;
+            }
+            player.reads++;
+            if (player.lastReceive > 0 && now - player.lastReceive > player.longestGap) {
+                player.longestGap = now - player.lastReceive;
+            }
+            player.lastReceive = now;
+        }
+
+        // Each player presses a key about every 100 ms
+        if (now >= nextInput) {
+            nextInput = now + 0.1;
+            for (int i = 0; i < playerCount; i++) {
+                FakePlayer& player = players[i];
+                if (player.fd < 0) continue;
+                const char* key = keys[std::rand() % keyCount];
+                send(player.fd, key, std::strlen(key), MSG_NOSIGNAL);
+            }
+        }
+    }
+
+    // Measure the server while every session is still open
+    double elapsed = secondsSince(start);
+    double cpu = serverPid ? processCpuSeconds(serverPid) - cpuBefore : 0;
+    long rss = serverPid ? processRssKb(serverPid) : -1;
+
+    unsigned long totalBytes = 0, spectatorBytes = 0;
+    double worstGap = 0;
+    int stillConnected = 0, spectatorsConnected = 0;
+    for (int i = 0; i < playerCount + spectatorCount; i++) {
+        FakePlayer& player = players[i];
+        if (i >= playerCount) {
+            spectatorBytes += player.bytes;
+            if (player.fd >= 0) {
+                spectatorsConnected++;
+                close(player.fd);
+            }
+            continue;
+        }
+        totalBytes += player.bytes;
+        if (player.longestGap > worstGap) worstGap = player.longestGap;
+        if (player.fd >= 0) {
+            stillConnected++;
+            close(player.fd);
+        }
+    }
+
+    std::printf("Received %.1f MB in %.1f s (%.1f kB/s per player)\n",
+                totalBytes / 1e6, elapsed, connected ? totalBytes / 1e3 / elapsed / connected : 0.0);
+    std::printf("Longest gap between frames: %.0f ms, %d players still connected\n",
+                worstGap * 1000, stillConnected);
+
+    if (spectatorCount) {
+        std::printf("Spectators received %.1f MB (%.1f kB/s each), %d still connected\n",
+                    spectatorBytes / 1e6, spectatorBytes / 1e3 / elapsed / spectatorCount,
+                    spectatorsConnected);
+    }
+
+    if (serverPid && connected) {
+        std::printf("Server CPU: %.1f%% total, %.3f%% per player\n",
+                    100.0 * cpu / elapsed, 100.0 * cpu / elapsed / connected);
+        std::printf("Server RSS: %ld kB (%ld kB before), %.1f kB per player\n",
+                    rss, rssBefore, static_cast<double>(rss - rssBefore) / connected);
+    }
+
+    close(epollFd);
+    return 0;
+}
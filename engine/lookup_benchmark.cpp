@@ -0,0 +1,112 @@
+// Times the per-frame kernels built on lookup_tables.h against the code
+// they replaced in the stages.
+// Usage: lookup_benchmark [iterations]
+#include "lookup_tables.h"
+#include <ncursesw/ncurses.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static volatile int intSink;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double before, double after, long operations) {
+    std::printf("%-28s %8.1f ns -> %6.1f ns  (%.1fx)\n", name,
+                before * 1e9 / operations, after * 1e9 / operations, before / after);
+}
+
+struct Entity {
+    float x, y;
+    int cellX, cellY;
+};
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+    std::srand(1);
+
+    // 1340 collision pass: every laser against every enemy, rounding both
+    // positions per pair vs comparing cells rounded once per move
+    std::vector<Entity> lasers(8), enemies(40);
+    for (Entity& e : lasers) e = { float(std::rand() % 40), float(std::rand() % 16), 0, 0 };
+    for (Entity& e : enemies) e = { float(std::rand() % 40), float(std::rand() % 16), 0, 0 };
+    long passes = iterations / 200;
+    long pairs = passes * lasers.size() * enemies.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (long pass = 0; pass < passes; pass++) {
+        int hits = 0;
+        for (const Entity& laser : lasers) {
+            for (const Entity& enemy : enemies) {
+                hits += static_cast<int>(round(laser.x)) == static_cast<int>(round(enemy.x)) &&
+                        static_cast<int>(round(laser.y)) == static_cast<int>(round(enemy.y));
+            }
+        }
+        intSink = hits;
+    }
+    double before = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (long pass = 0; pass < passes; pass++) {
+        // The once-per-move rounding is part of the cost
+        for (Entity& e : lasers) { e.cellX = static_cast<int>(round(e.x)); e.cellY = static_cast<int>(round(e.y)); }
+        for (Entity& e : enemies) { e.cellX = static_cast<int>(round(e.x)); e.cellY = static_cast<int>(round(e.y)); }
+        int hits = 0;
+        for (const Entity& laser : lasers) {
+            for (const Entity& enemy : enemies) {
+                hits += laser.cellX == enemy.cellX && laser.cellY == enemy.cellY;
+            }
+        }
+        intSink = hits;
+    }
+    report("collision pair", before, secondsSince(start), pairs);
+
+    // 1330 laser trail: colour picked per cell with attron/attroff vs one
+    // mvaddch per cell with the attribute folded into the character
+    FILE* output = std::fopen("/dev/null", "w");
+    FILE* input = std::fopen("/dev/null", "r");
+    SCREEN* screen = newterm("xterm-256color", output, input);
+    if (!screen) {
+        std::fprintf(stderr, "newterm failed\n");
+        return 1;
+    }
+    start_color();
+    std::vector<std::pair<int, int>> trail;
+    for (int i = 0; i < 40; i++) trail.push_back(std::make_pair(i, i % 16));
+    long cells = iterations;
+    long trails = cells / trail.size();
+
+    start = std::chrono::steady_clock::now();
+    for (long t = 0; t < trails; t++) {
+        for (size_t i = 0; i < trail.size(); i++) {
+            int colorIntensity = 3;
+            if (i < trail.size() / 2) {
+                colorIntensity = 6;
+            }
+            attron(COLOR_PAIR(colorIntensity));
+            mvaddch(trail[i].second, trail[i].first, '*');
+            attroff(COLOR_PAIR(colorIntensity));
+        }
+    }
+    before = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (long t = 0; t < trails; t++) {
+        size_t half = trail.size() / 2;
+        for (size_t i = 0; i < half; i++) {
+            mvaddch(trail[i].second, trail[i].first, '*' | COLOR_PAIR(6));
+        }
+        for (size_t i = half; i < trail.size(); i++) {
+            mvaddch(trail[i].second, trail[i].first, '*' | COLOR_PAIR(3));
+        }
+    }
+    report("trail cell", before, secondsSince(start), trails * trail.size());
+
+    endwin();
+    delscreen(screen);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef LOOKUP_TABLES_H
+#define LOOKUP_TABLES_H
+
+// Compile-time tables for the stages' per-frame code, so a frame looks
+// values up instead of rebuilding them or choosing colours with branches.
+// lookup_benchmark times the kernels built on them against the old code.
+
+struct CellOffset {
+    int dx, dy;
+};
+
+// The eight L-shaped knight moves, clockwise from two right and one down
+constexpr CellOffset KNIGHT_MOVES[8] = {
+    {2, 1}, {1, 2}, {-1, 2}, {-2, 1},
+    {-2, -1}, {-1, -2}, {1, -2}, {2, -1}
+};
+
+// Colour of each entity type, specialised next to the entity classes.
+// attr is a whole attribute (COLOR_PAIR(n) | A_...), so a draw kernel is one
+// mvaddch(y, x, symbol | attr) with no attron()/attroff() around it.
+template <class Entity> struct Palette;
+
+#endif // LOOKUP_TABLES_H
@@ -0,0 +1,105 @@
+// Times a tick of the main menu's clouds on a large headless screen: the
+// old way, reading every cloud's cell back with mvinch() before erasing and
+// again before drawing, against a ParticleLayer checking an OccupancyMask.
+// Usage: particle_benchmark [particles] [ticks]
+#include "particle_layer.h"
+#include "random.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int SCREEN_ROWS = 120;
+static const int SCREEN_COLS = 400;
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Boxes and text covering part of the screen, as in the level menu
+static void drawStatic(OccupancyMask* mask) {
+    for (int y = 20; y < SCREEN_ROWS - 20; y += 12) {
+        for (int x = 10; x < SCREEN_COLS - 40; x += 60) {
+            for (int row = y; row < y + 7; row++) {
+                mvprintw(row, x, "%-30s", "|   ENGG1340   |");
+                if (mask) mask->mark(row, x, 30);
+            }
+        }
+    }
+}
+
+struct Cloud {
+    int x, y, speed;
+};
+
+// The menu's update before the particle layer
+static void readbackTick(std::vector<Cloud>& clouds) {
+    for (Cloud& cloud : clouds) {
+        if ((mvinch(cloud.y, cloud.x) & A_CHARTEXT) == '.') mvaddch(cloud.y, cloud.x, ' ');
+    }
+    for (Cloud& cloud : clouds) {
+        cloud.x += cloud.speed;
+        if (cloud.x >= SCREEN_COLS) {
+            cloud.x = 0;
+            cloud.y = randomInt(1, SCREEN_ROWS - 2);
+        }
+        if ((mvinch(cloud.y, cloud.x) & A_CHARTEXT) == ' ') mvaddch(cloud.y, cloud.x, '.');
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int particles = argc > 1 ? std::atoi(argv[1]) : 5000;
+    long ticks = argc > 2 ? std::atol(argv[2]) : 300;
+
+    FILE* out = std::fopen("/dev/null", "w");
+    FILE* in = std::fopen("/dev/null", "r");
+    SCREEN* screen = out && in ? newterm("xterm-256color", out, in) : NULL;
+    if (screen == NULL) {
+        std::fprintf(stderr, "particle_benchmark: no headless terminal\n");
+        return 1;
+    }
+    // A screen bigger than any real terminal's default
+    resizeterm(SCREEN_ROWS, SCREEN_COLS);
+
+    std::vector<Cloud> clouds(particles);
+    for (Cloud& cloud : clouds) {
+        cloud.x = randomInt(0, SCREEN_COLS - 1);
+        cloud.y = randomInt(1, SCREEN_ROWS - 2);
+        cloud.speed = randomInt(1, 3);
+    }
+    clear();
+    drawStatic(NULL);
+    auto start = std::chrono::steady_clock::now();
+    for (long tick = 0; tick < ticks; tick++) readbackTick(clouds);
+    double readback = secondsSince(start);
+
+    // Same speeds as above, then the menu's: 30 ticks a second instead of
+    // 6.7, so a fifth of a cell to two thirds of one per tick
+    OccupancyMask mask;
+    mask.resize(SCREEN_ROWS, SCREEN_COLS);
+    double masked[2];
+    const Fixed minSpeed[2] = { 1, Fixed(0.2) }, maxSpeed[2] = { 3, Fixed(0.66) };
+    for (int run = 0; run < 2; run++) {
+        ParticleLayer layer('.');
+        layer.populate(particles, SCREEN_ROWS, SCREEN_COLS, minSpeed[run], maxSpeed[run]);
+        clear();
+        mask.clear();
+        drawStatic(&mask);
+        start = std::chrono::steady_clock::now();
+        for (long tick = 0; tick < ticks; tick++) {
+            layer.update();
+            layer.draw(mask);
+        }
+        masked[run] = secondsSince(start);
+    }
+    endwin();
+    delscreen(screen);
+
+    std::printf("%d particles on %dx%d, %ld ticks\n", particles, SCREEN_COLS, SCREEN_ROWS, ticks);
+    std::printf("%-28s %8.1f us per tick\n", "mvinch readback", readback * 1e6 / ticks);
+    std::printf("%-28s %8.1f us per tick  (%.1fx)\n", "particle layer", masked[0] * 1e6 / ticks,
+                readback / masked[0]);
+    std::printf("%-28s %8.1f us per tick  (%.1fx)\n", "particle layer, menu speed", masked[1] * 1e6 / ticks,
+                readback / masked[1]);
+    return 0;
+}
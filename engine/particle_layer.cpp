@@ -0,0 +1,102 @@
+#include "particle_layer.h"
+#include "random.h"
+#include <algorithm>
+
+void OccupancyMask::resize(int newRows, int newCols) {
+    rows = newRows;
+    cols = newCols;
+    cells.assign(static_cast<size_t>(rows) * cols, 0);
+}
+
+void OccupancyMask::clear() {
+    std::fill(cells.begin(), cells.end(), 0);
+}
+
+// Clipped to the row, so callers can pass whatever they printed
+static void setSpan(std::vector<unsigned char>& cells, int rows, int cols,
+                    int y, int x, int width, unsigned char value) {
+    if (y < 0 || y >= rows) return;
+    int from = std::max(x, 0);
+    int to = std::min(x + width, cols);
+    if (from < to) std::fill(&cells[y * cols + from], &cells[y * cols + to], value);
+}
+
+void OccupancyMask::mark(int y, int x, int width) {
+    setSpan(cells, rows, cols, y, x, width, 1);
+}
+
+void OccupancyMask::unmark(int y, int x, int width) {
+    setSpan(cells, rows, cols, y, x, width, 0);
+}
+
+void ParticleLayer::populate(int particles, int screenRows, int screenCols, Fixed minSpeed, Fixed maxSpeed) {
+    rows = screenRows;
+    cols = screenCols;
+    x.resize(particles);
+    speed.resize(particles);
+    y.resize(particles);
+    cell.resize(particles);
+    count.assign(static_cast<size_t>(rows) * cols, 0);
+    shown.assign(count.size(), 0);
+    changed.clear();
+    redrawAll = true;
+
+    int spread = (maxSpeed - minSpeed).raw();
+    for (int i = 0; i < particles; i++) {
+        x[i] = randomInt(0, cols - 1);
+        y[i] = randomInt(1, rows - 2);
+        speed[i] = minSpeed + Fixed::fromRaw(randomInt(0, spread));
+        cell[i] = y[i] * cols + x[i].floor();
+        count[cell[i]]++;
+    }
+}
+
+void ParticleLayer::moveTo(int i, int newCell) {
+    count[cell[i]]--;
+    changed.push_back(cell[i]);
+    cell[i] = newCell;
+    count[newCell]++;
+    changed.push_back(newCell);
+}
+
+void ParticleLayer::update() {
+    Fixed width = cols;
+    int particles = size();
+    for (int i = 0; i < particles; i++) {
+        x[i] += speed[i];
+    }
+    // Most particles stay in their cell; only the others touch the counts
+    for (int i = 0; i < particles; i++) {
+        if (x[i] >= width) {
+            x[i] = 0;
+            y[i] = randomInt(1, rows - 2);
+        }
+        int newCell = y[i] * cols + x[i].floor();
+        if (newCell != cell[i]) moveTo(i, newCell);
+    }
+}
+
+void ParticleLayer::draw(const OccupancyMask& mask) {
+    if (redrawAll) {
+        for (int i = 0; i < size(); i++) changed.push_back(cell[i]);
+        redrawAll = false;
+    }
+    for (int at : changed) {
+        int cellY = at / cols, cellX = at % cols;
+        // Static content drew over it, or keeps it hidden
+        if (mask.isCovered(cellY, cellX)) {
+            shown[at] = 0;
+            continue;
+        }
+        unsigned char wanted = count[at] > 0;
+        if (wanted == shown[at]) continue;
+        mvaddch(cellY, cellX, wanted ? look : ' ');
+        shown[at] = wanted;
+    }
+    changed.clear();
+}
+
+void ParticleLayer::invalidate() {
+    std::fill(shown.begin(), shown.end(), 0);
+    redrawAll = true;
+}
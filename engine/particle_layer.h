@@ -0,0 +1,73 @@
+#ifndef PARTICLE_LAYER_H
+#define PARTICLE_LAYER_H
+
+#include "fixed_point.h"
+#include <ncursesw/ncurses.h>
+#include <vector>
+
+// Which cells of the screen the static layer (boxes and text) covers. Code
+// drawing static content marks its cells here, so a layer above it can tell
+// where it may draw without reading the screen back with mvinch().
+// Cells off the screen count as covered.
+class OccupancyMask {
+private:
+    int rows, cols;
+    std::vector<unsigned char> cells;
+
+public:
+    OccupancyMask() : rows(0), cols(0) {}
+
+    // Resizing also clears it
+    void resize(int newRows, int newCols);
+    void clear();
+
+    void mark(int y, int x, int width = 1);
+    void unmark(int y, int x, int width = 1);
+    bool isCovered(int y, int x) const {
+        return y < 0 || y >= rows || x < 0 || x >= cols || cells[y * cols + x] != 0;
+    }
+};
+
+// Particles drifting right across the screen and wrapping round to the left
+// on a new row, e.g. the main menu's clouds. Positions are kept as parallel
+// arrays and the layer counts the particles in every cell, so a tick only
+// writes the cells that gained their first particle or lost their last one.
+// Slow particles stay in their cell for several ticks and cost no output,
+// and the layer never asks the screen what is there.
+class ParticleLayer {
+private:
+    chtype look;
+    int rows, cols;             // Area the particles move in, rows 1..rows-2
+    std::vector<Fixed> x;
+    std::vector<Fixed> speed;   // Cells per tick
+    std::vector<int> y;
+    std::vector<int> cell;      // y * cols + x of each particle
+
+    std::vector<unsigned short> count;  // Particles in each cell
+    std::vector<unsigned char> shown;   // Cells showing a particle now
+    std::vector<int> changed;           // Cells whose count changed this tick
+    bool redrawAll;
+
+    void moveTo(int i, int newCell);
+
+public:
+    explicit ParticleLayer(chtype particleLook) : look(particleLook), rows(0), cols(0), redrawAll(true) {}
+
+    // count particles at random places, each with a speed between
+    // minSpeed and maxSpeed cells per tick
+    void populate(int count, int screenRows, int screenCols, Fixed minSpeed, Fixed maxSpeed);
+
+    void update();
+
+    // Writes the cells that changed since the last draw, only where the mask
+    // leaves them free
+    void draw(const OccupancyMask& mask);
+
+    // After the screen was cleared or the static layer changed under the
+    // particles: the next draw() shows every particle again
+    void invalidate();
+
+    int size() const { return static_cast<int>(x.size()); }
+};
+
+#endif // PARTICLE_LAYER_H
@@ -0,0 +1,117 @@
+#include "pixel_canvas.h"
+#include <algorithm>
+#include <cstring>
+
+// This file is built with -O3 (see the makefile), so the row loops below are
+// vectorised: fill_n becomes wide stores and blendRow works on four or eight
+// pixels per instruction. They are kept simple enough for that to happen.
+
+PixelCanvas::PixelCanvas(int cellCols, int cellRows, int pixelsPerCellX, int pixelsPerCellY)
+    : cols(cellCols), rows(cellRows), cellWidth(pixelsPerCellX), cellHeight(pixelsPerCellY),
+      width(cellCols * pixelsPerCellX), height(cellRows * pixelsPerCellY),
+      pixels(static_cast<size_t>(width) * height), previous(pixels.size()),
+      everythingDirty(true) {}
+
+// Clips a rectangle to the canvas; false when nothing is left
+static bool clip(int& x, int& y, int& w, int& h, int width, int height) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width) w = width - x;
+    if (y + h > height) h = height - y;
+    return w > 0 && h > 0;
+}
+
+void PixelCanvas::clear(Pixel colour) {
+    std::fill(pixels.begin(), pixels.end(), colour);
+}
+
+void PixelCanvas::fillRect(int x, int y, int w, int h, Pixel colour) {
+    if (!clip(x, y, w, h, width, height)) return;
+    for (int row = y; row < y + h; row++) {
+        std::fill_n(&pixels[static_cast<size_t>(row) * width + x], w, colour);
+    }
+}
+
+// dst = (src * a + dst * (256 - a)) / 256 per channel, red and blue worked
+// out together in one 32-bit multiply and green and alpha in another
+static void blendRow(Pixel* dst, int count, Pixel colour) {
+    uint32_t alpha = (colour >> 24) + 1;
+    uint32_t inverse = 256 - alpha;
+    uint32_t srcRB = (colour & 0x00FF00FF) * alpha;
+    uint32_t srcGA = ((colour >> 8) & 0x00FF00FF) * alpha;
+    for (int i = 0; i < count; i++) {
+        uint32_t d = dst[i];
+        uint32_t rb = (((d & 0x00FF00FF) * inverse + srcRB) >> 8) & 0x00FF00FF;
+        uint32_t ga = (((d >> 8) & 0x00FF00FF) * inverse + srcGA) & 0xFF00FF00;
+        dst[i] = rb | ga;
+    }
+}
+
+void PixelCanvas::blendRect(int x, int y, int w, int h, Pixel colour) {
+    if (!clip(x, y, w, h, width, height)) return;
+    for (int row = y; row < y + h; row++) {
+        blendRow(&pixels[static_cast<size_t>(row) * width + x], w, colour);
+    }
+}
+
+void PixelCanvas::fillDisc(int centreX, int centreY, int radius, Pixel colour) {
+    // One span per row, widest through the centre
+    int span = radius;
+    for (int dy = 0; dy <= radius; dy++) {
+        while (span > 0 && span * span + dy * dy > radius * radius) span--;
+        fillRect(centreX - span, centreY + dy, 2 * span + 1, 1, colour);
+        if (dy > 0) fillRect(centreX - span, centreY - dy, 2 * span + 1, 1, colour);
+    }
+}
+
+void PixelCanvas::fillDiamond(int centreX, int centreY, int halfWidth, int halfHeight, Pixel colour) {
+    // Too flat for rows above and below: a single line
+    if (halfHeight <= 0) {
+        fillRect(centreX - halfWidth, centreY, 2 * halfWidth + 1, 1, colour);
+        return;
+    }
+    for (int dy = 0; dy <= halfHeight; dy++) {
+        int span = halfWidth * (halfHeight - dy) / halfHeight;
+        fillRect(centreX - span, centreY + dy, 2 * span + 1, 1, colour);
+        if (dy > 0) fillRect(centreX - span, centreY - dy, 2 * span + 1, 1, colour);
+    }
+}
+
+int PixelCanvas::tilesAcross() const {
+    return (cols + TILE_COLS - 1) / TILE_COLS;
+}
+
+int PixelCanvas::tileCount() const {
+    return tilesAcross() * ((rows + TILE_ROWS - 1) / TILE_ROWS);
+}
+
+void PixelCanvas::tileBounds(int tile, int& x, int& y, int& w, int& h) const {
+    x = tile % tilesAcross() * TILE_COLS * cellWidth;
+    y = tile / tilesAcross() * TILE_ROWS * cellHeight;
+    w = std::min(TILE_COLS * cellWidth, width - x);
+    h = std::min(TILE_ROWS * cellHeight, height - y);
+}
+
+const std::vector<int>& PixelCanvas::endFrame() {
+    dirtyTiles.clear();
+    for (int tile = 0; tile < tileCount(); tile++) {
+        int x, y, w, h;
+        tileBounds(tile, x, y, w, h);
+        size_t rowBytes = w * sizeof(Pixel);
+
+        bool changed = everythingDirty;
+        for (int row = y; row < y + h && !changed; row++) {
+            size_t at = static_cast<size_t>(row) * width + x;
+            changed = std::memcmp(&pixels[at], &previous[at], rowBytes) != 0;
+        }
+        if (!changed) continue;
+
+        dirtyTiles.push_back(tile);
+        for (int row = y; row < y + h; row++) {
+            size_t at = static_cast<size_t>(row) * width + x;
+            std::memcpy(&previous[at], &pixels[at], rowBytes);
+        }
+    }
+    everythingDirty = false;
+    return dirtyTiles;
+}
@@ -0,0 +1,78 @@
+#ifndef PIXEL_CANVAS_H
+#define PIXEL_CANVAS_H
+
+#include "fixed_point.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One RGBA pixel, red in the lowest byte, so the buffer in memory is the
+// R, G, B, A byte order the terminal image protocols take
+typedef uint32_t Pixel;
+
+constexpr Pixel rgba(int r, int g, int b, int a = 255) {
+    return static_cast<Pixel>(r) | static_cast<Pixel>(g) << 8 |
+           static_cast<Pixel>(b) << 16 | static_cast<Pixel>(a) << 24;
+}
+
+// The same colour with another alpha, for blendRect()
+constexpr Pixel withAlpha(Pixel colour, int a) {
+    return (colour & 0x00FFFFFF) | static_cast<Pixel>(a) << 24;
+}
+
+// Pixel picture of a block of terminal cells, for terminals that can show
+// images (see terminal_graphics.h). Entities are drawn at their Fixed
+// positions, so they move in pixels rather than whole cells.
+//
+// The canvas is split into tiles of TILE_COLS x TILE_ROWS cells. endFrame()
+// compares every tile with the previous frame and lists the ones that
+// changed, so only those are encoded and sent.
+class PixelCanvas {
+private:
+    int cols, rows;                 // Size in cells
+    int cellWidth, cellHeight;      // Pixels per cell
+    int width, height;              // Size in pixels
+    std::vector<Pixel> pixels;
+    std::vector<Pixel> previous;    // Last frame, to find changed tiles
+    std::vector<int> dirtyTiles;
+    bool everythingDirty;
+
+public:
+    static const int TILE_COLS = 8;
+    static const int TILE_ROWS = 3;
+
+    PixelCanvas(int cellCols, int cellRows, int pixelsPerCellX, int pixelsPerCellY);
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    int getCellWidth() const { return cellWidth; }
+    int getCellHeight() const { return cellHeight; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const Pixel* row(int y) const { return &pixels[static_cast<size_t>(y) * width]; }
+
+    // Pixel at the centre of a cell position, relative to the canvas origin
+    int pixelX(Fixed cellX) const { return (cellX * cellWidth).floor() + cellWidth / 2; }
+    int pixelY(Fixed cellY) const { return (cellY * cellHeight).floor() + cellHeight / 2; }
+
+    // Drawing, clipped to the canvas. blendRect() mixes colour in by its
+    // alpha; the others overwrite.
+    void clear(Pixel colour);
+    void fillRect(int x, int y, int w, int h, Pixel colour);
+    void blendRect(int x, int y, int w, int h, Pixel colour);
+    void fillDisc(int centreX, int centreY, int radius, Pixel colour);
+    void fillDiamond(int centreX, int centreY, int halfWidth, int halfHeight, Pixel colour);
+
+    // Tiles, numbered across then down
+    int tileCount() const;
+    int tilesAcross() const;
+    void tileBounds(int tile, int& x, int& y, int& w, int& h) const;
+
+    // Ends the frame: returns the tiles that differ from the last frame
+    const std::vector<int>& endFrame();
+
+    // Every tile is sent on the next frame (after the screen was cleared)
+    void invalidate() { everythingDirty = true; }
+};
+
+#endif // PIXEL_CANVAS_H
@@ -0,0 +1,39 @@
+#include "present.h"
+#include "session_recorder.h"
+#include "session_budget.h"
+#include "startup_timer.h"
+#include <cerrno>
+#include <cstdlib>
+
+// Stage processes report their CPU, memory and frame counts but are never
+// throttled: getch() refreshes stdscr itself, so skipping a frame here would
+// not save the redraw, only risk a stale screen while a prompt waits for a key.
+// Created at startup so its wall clock matches the process CPU time.
+static SessionBudget budget;
+
+static void logProcessSummary() {
+    budget.setCpuTime(processCpuSeconds());
+    appendSessionLog(budget.summaryLine(program_invocation_short_name, residentKb()));
+}
+
+void presentFrame() {
+    if (profilerOverlayEnabled()) {
+        static long rssKb = 0;
+        if (budget.getFramesRendered() % 60 == 0) rssKb = residentKb();
+        budget.setCpuTime(processCpuSeconds());
+        drawProfilerOverlay(budget.overlayText(rssKb));
+    }
+    refresh();
+    framePresented();
+}
+
+void framePresented() {
+    markStartup(STARTUP_FRAME);
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(logProcessSummary);
+        registered = true;
+    }
+    budget.shouldRender();
+    SessionRecorder::instance().recordFrame();
+}
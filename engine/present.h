@@ -0,0 +1,11 @@
+#ifndef PRESENT_H
+#define PRESENT_H
+
+// Replacement for refresh() in game loops and dialogue boxes.
+// Refreshes stdscr and hands the new screen to the session recorder.
+void presentFrame();
+
+// For code that updates the screen itself (pads, doupdate); call right after it
+void framePresented();
+
+#endif // PRESENT_H
@@ -0,0 +1,25 @@
+// Cuts a stretch of a stage recording (made with YEAR1_RECORD) into the
+// preview.cast the level menu plays in the stage's box.
+// Usage: preview_clip <recording.cast> <preview.cast> <start seconds> <seconds>
+#include "replay_preview.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char* argv[]) {
+    if (argc != 5) {
+        std::fprintf(stderr, "Usage: %s <recording.cast> <preview.cast> <start seconds> <seconds>\n", argv[0]);
+        return 2;
+    }
+
+    ReplayPlayer player;
+    if (!player.load(argv[1])) {
+        std::fprintf(stderr, "%s: not an asciicast v2 recording\n", argv[1]);
+        return 1;
+    }
+    if (!player.writeClip(argv[2], std::atof(argv[3]), std::atof(argv[4]))) {
+        std::fprintf(stderr, "%s: could not write a clip starting at %s s of %.1f s\n",
+                     argv[2], argv[3], player.getDuration());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "random.h"
+#include <ctime>
+#include <unistd.h>
+
+namespace {
+
+const RandomState DEFAULT_SEED = 0x9E3779B97F4A7C15ULL;
+
+RandomState step(RandomState& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// The process's generator; rounds only use it to seed their own
+RandomState processState = DEFAULT_SEED;
+
+} // namespace
+
+void seedRandom() {
+    static bool seeded = false;
+    if (seeded) return;
+    seeded = true;
+    RandomState seed = static_cast<RandomState>(std::time(nullptr)) ^
+                       (static_cast<RandomState>(getpid()) << 32);
+    // A zero state would only ever produce zeros
+    processState = seed ? seed : DEFAULT_SEED;
+}
+
+int randomNext() {
+    return static_cast<int>(step(processState) >> 33);
+}
+
+int randomInt(int low, int high) {
+    if (high <= low) return low;
+    return low + randomNext() % (high - low + 1);
+}
+
+RandomGenerator::RandomGenerator() {
+    seedRandom();
+    state = step(processState);
+    if (!state) state = DEFAULT_SEED;
+}
+
+int RandomGenerator::next() {
+    return static_cast<int>(step(state) >> 33);
+}
+
+int RandomGenerator::nextInt(int low, int high) {
+    if (high <= low) return low;
+    return low + next() % (high - low + 1);
+}
@@ -0,0 +1,40 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Seeds the process's generator once. The seed mixes in the pid so the menu
+// and a stage started within the same second do not share a sequence.
+void seedRandom();
+
+// Uniform-ish integer in [low, high] from the process's generator, for
+// things outside a round (the menu's clouds, benchmarks)
+int randomInt(int low, int high);
+
+const int RANDOM_MAX = 0x7fffffff;
+int randomNext();
+
+typedef uint64_t RandomState;
+
+// xorshift64*: one 64-bit word of state. Each round owns one and draws from
+// it instead of rand(), so saving and restoring the round (see
+// snapshot_ring.h) rewinds its random numbers and nobody else's, e.g. not
+// those of another session in the 1340 server. Plain data, so it goes into
+// a snapshot as it is.
+class RandomGenerator {
+private:
+    RandomState state;
+
+public:
+    // Seeded from the process's generator, so rounds and sessions built one
+    // after another draw different sequences
+    RandomGenerator();
+
+    // Next number, 0 to RANDOM_MAX
+    int next();
+
+    // Uniform-ish integer in [low, high]
+    int nextInt(int low, int high);
+};
+
+#endif // RANDOM_H
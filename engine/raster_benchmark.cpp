@@ -0,0 +1,93 @@
+// Times a pixel canvas frame at 640x400 (80x25 cells of 8x16): drawing a
+// busy battle, finding the changed tiles and encoding them, against the
+// 16 ms a frame has at 60 FPS.
+// Usage: raster_benchmark [frames]
+#include "pixel_canvas.h"
+#include "terminal_graphics.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double seconds, long frames) {
+    double ms = seconds * 1e3 / frames;
+    std::printf("%-28s %8.3f ms  (%4.1f%% of 16 ms)\n", name, ms, ms * 100 / 16);
+}
+
+struct Mover {
+    Fixed x, y, dx, dy;
+};
+
+int main(int argc, char* argv[]) {
+    long frames = argc > 1 ? std::atol(argv[1]) : 300;
+    PixelCanvas canvas(80, 25, 8, 16);
+
+    // 60 moving entities, like a full 1340 round, over 1300's brick wall
+    std::srand(1);
+    std::vector<Mover> movers(60);
+    for (Mover& m : movers) {
+        m.x = std::rand() % 80;
+        m.y = std::rand() % 25;
+        m.dx = Fixed::fromRaw(std::rand() % Fixed::ONE - Fixed::ONE / 2);
+        m.dy = Fixed::fromRaw((std::rand() % Fixed::ONE - Fixed::ONE / 2) / 2);
+    }
+    const Pixel colours[5] = { colourPixel(2), colourPixel(3), colourPixel(5), colourPixel(4), colourPixel(7) };
+
+    double drawTime = 0, diffTime = 0, sixelTime = 0, kittyTime = 0;
+    size_t dirtyTiles = 0, sixelBytes = 0, kittyBytes = 0;
+    std::string out;
+    for (long frame = 0; frame < frames; frame++) {
+        auto start = std::chrono::steady_clock::now();
+        canvas.clear(rgba(0, 0, 0));
+        for (int row = 0; row < 5; row++) {
+            for (int col = 0; col < 20; col++) {
+                canvas.fillRect(col * 32 + 1, row * 16 + 1, 30, 14, colours[row]);
+            }
+        }
+        for (Mover& m : movers) {
+            m.x += m.dx;
+            m.y += m.dy;
+            if (m.x < 0 || m.x > 79) m.dx = -m.dx;
+            if (m.y < 0 || m.y > 24) m.dy = -m.dy;
+            int px = canvas.pixelX(m.x), py = canvas.pixelY(m.y);
+            canvas.blendRect(px - 12, py - 6, 24, 12, rgba(0, 205, 205, 64));
+            canvas.fillDisc(px, py, 5, colourPixel(6));
+            canvas.fillDiamond(px, py, 3, 5, colourPixel(1));
+        }
+        drawTime += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        const std::vector<int>& dirty = canvas.endFrame();
+        diffTime += secondsSince(start);
+        dirtyTiles += dirty.size();
+
+        start = std::chrono::steady_clock::now();
+        out.clear();
+        for (int tile : dirty) encodeSixelTile(canvas, tile, out);
+        sixelTime += secondsSince(start);
+        sixelBytes += out.size();
+
+        start = std::chrono::steady_clock::now();
+        out.clear();
+        for (int tile : dirty) encodeKittyTile(canvas, tile, out);
+        kittyTime += secondsSince(start);
+        kittyBytes += out.size();
+    }
+
+    std::printf("%ld frames, %.1f of %d tiles changed per frame\n",
+                frames, double(dirtyTiles) / frames, canvas.tileCount());
+    report("draw", drawTime, frames);
+    report("changed tiles", diffTime, frames);
+    report("sixel encode", sixelTime, frames);
+    report("kitty encode", kittyTime, frames);
+    report("frame total (sixel)", drawTime + diffTime + sixelTime, frames);
+    report("frame total (kitty)", drawTime + diffTime + kittyTime, frames);
+    std::printf("%-28s %8.1f KB sixel, %.1f KB kitty\n", "sent per frame",
+                sixelBytes / 1024.0 / frames, kittyBytes / 1024.0 / frames);
+    return 0;
+}
@@ -0,0 +1,491 @@
+#include "replay_preview.h"
+#include "session_recorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// Cells changed by the last few events count as moving, about a quarter of
+// a second of a stage running at 60 frames a second
+const unsigned long RECENT_EVENTS = 15;
+
+// The last frame stays up this long before the recording starts over
+const double LOOP_PAUSE = 1.0;
+
+// Colour pairs for miniatures are allocated from here up, shared by every
+// preview in the process
+const short FIRST_PREVIEW_PAIR = 64;
+
+// Parses the JSON string starting at the quote at text[at] and returns the
+// index after its closing quote, or npos if it is malformed
+size_t parseJsonString(const std::string& text, size_t at, std::string& out) {
+    if (at >= text.size() || text[at] != '"') return std::string::npos;
+    out.clear();
+    for (size_t i = at + 1; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') return i + 1;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++i >= text.size()) break;
+        switch (text[i]) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (i + 4 >= text.size()) return std::string::npos;
+                uint32_t cp = std::strtoul(text.substr(i + 1, 4).c_str(), nullptr, 16);
+                i += 4;
+                // Surrogate pair
+                if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < text.size() && text[i + 1] == '\\' && text[i + 2] == 'u') {
+                    uint32_t low = std::strtoul(text.substr(i + 3, 4).c_str(), nullptr, 16);
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: out += text[i]; break;  // \" \\ \/
+        }
+    }
+    return std::string::npos;
+}
+
+int headerNumber(const std::string& header, const char* key) {
+    size_t at = header.find(key);
+    return at == std::string::npos ? 0 : std::atoi(header.c_str() + at + std::strlen(key));
+}
+
+// The line-drawing code points FrameEncoder produces, back as ncurses
+// alternate charset characters
+chtype glyphFor(uint32_t cp) {
+    if (cp >= 0x20 && cp < 0x7F) return cp;
+    switch (cp) {
+        case 0x25C6: return ACS_DIAMOND;
+        case 0x2592: return ACS_CKBOARD;
+        case 0x2518: return ACS_LRCORNER;
+        case 0x2510: return ACS_URCORNER;
+        case 0x250C: return ACS_ULCORNER;
+        case 0x2514: return ACS_LLCORNER;
+        case 0x253C: return ACS_PLUS;
+        case 0x2500: return ACS_HLINE;
+        case 0x2502: return ACS_VLINE;
+        case 0x251C: return ACS_LTEE;
+        case 0x2524: return ACS_RTEE;
+        case 0x2534: return ACS_BTEE;
+        case 0x252C: return ACS_TTEE;
+        case 0x2588: return ACS_BLOCK;
+        case 0x00B7: return ACS_BULLET;
+        case 0x00B0: return ACS_DEGREE;
+        case 0x2190: return ACS_LARROW;
+        case 0x2192: return ACS_RARROW;
+        case 0x2191: return ACS_UARROW;
+        case 0x2193: return ACS_DARROW;
+        default:     return '*';
+    }
+}
+
+void appendSgrColour(std::string& out, short colour, int base, int brightBase) {
+    if (colour < 0) return;
+    out += ';';
+    if (colour < 8) {
+        out += std::to_string(base + colour);
+    } else if (colour < 16) {
+        out += std::to_string(brightBase + colour - 8);
+    } else {
+        out += std::to_string(base + 8) + ";5;" + std::to_string(colour);
+    }
+}
+
+chtype pairFor(const ReplayPlayer::Colours& colours) {
+    static std::vector<ReplayPlayer::Colours> allocated;
+    if (!has_colors()) return 0;
+    for (size_t i = 0; i < allocated.size(); i++) {
+        if (allocated[i].fg == colours.fg && allocated[i].bg == colours.bg) {
+            return COLOR_PAIR(FIRST_PREVIEW_PAIR + i);
+        }
+    }
+    // The menu does not use the terminal's default colours
+    short pair = FIRST_PREVIEW_PAIR + allocated.size();
+    short fg = colours.fg < 0 ? COLOR_WHITE : colours.fg;
+    short bg = colours.bg < 0 ? COLOR_BLACK : colours.bg;
+    if (pair >= COLOR_PAIRS || init_pair(pair, fg, bg) == ERR) return 0;
+    allocated.push_back(colours);
+    return COLOR_PAIR(pair);
+}
+
+} // namespace
+
+ReplayPlayer::ReplayPlayer()
+    : startRows(0), startCols(0), writes(0), next(0), clock(0),
+      cursorY(0), cursorX(0), penAttr(0), penPair(0), penFg(-1), penBg(-1), keyframe(false),
+      viewTop(0), viewLeft(0), viewBottom(-1), viewRight(-1), trackView(false) {}
+
+bool ReplayPlayer::load(const std::string& path) {
+    std::ifstream in(path.c_str());
+    std::string line;
+    if (!in || !std::getline(in, line) || line.find("\"version\": 2") == std::string::npos) return false;
+    startRows = headerNumber(line, "\"height\":");
+    startCols = headerNumber(line, "\"width\":");
+    if (startRows <= 0 || startCols <= 0) return false;
+
+    events.clear();
+    while (std::getline(in, line)) {
+        // [time, "o", "data"] or [time, "r", "COLSxROWS"]
+        size_t code = line.find('"');
+        if (line.empty() || line[0] != '[' || code == std::string::npos || code + 3 >= line.size()) continue;
+        Event event;
+        event.time = std::strtod(line.c_str() + 1, nullptr);
+        event.resizeRows = event.resizeCols = 0;
+        if (parseJsonString(line, line.find('"', code + 3), event.data) == std::string::npos) continue;
+        if (line[code + 1] == 'r') {
+            if (std::sscanf(event.data.c_str(), "%dx%d", &event.resizeCols, &event.resizeRows) != 2) continue;
+            event.data.clear();
+        } else if (line[code + 1] != 'o') {
+            continue;
+        }
+        events.push_back(event);
+    }
+
+    // Play it through once to find where things move
+    restart();
+    trackView = true;
+    for (const Event& event : events) play(event);
+    trackView = false;
+    if (viewBottom < viewTop) {
+        viewTop = viewLeft = 0;
+        viewBottom = startRows - 1;
+        viewRight = startCols - 1;
+    }
+    restart();
+    return !events.empty();
+}
+
+bool ReplayPlayer::writeClip(const std::string& path, double start, double seconds) {
+    if (events.empty() || start > getDuration()) return false;
+    rewind();
+    advance(start);
+
+    // The screen at start, painted the way FrameEncoder paints a keyframe
+    std::string paint = "\x1b[0m\x1b[?25l\x1b[H\x1b[2J";
+    for (int y = 0; y < frame.getRows(); y++) {
+        int penX = -1;
+        for (int x = 0; x < frame.getCols(); x++) {
+            const ScreenCell& cell = frame.at(y, x);
+            if (cell.ch == ' ' && cell.attr == 0 && cell.pair == 0) continue;
+            if (x != penX) paint += "\x1b[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+            paint += "\x1b[0";
+            if (cell.attr & A_BOLD) paint += ";1";
+            if (cell.attr & A_DIM) paint += ";2";
+            if (cell.attr & A_UNDERLINE) paint += ";4";
+            if (cell.attr & A_BLINK) paint += ";5";
+            if (cell.attr & A_REVERSE) paint += ";7";
+            if (cell.pair > 0) {
+                appendSgrColour(paint, colours[cell.pair - 1].fg, 30, 90);
+                appendSgrColour(paint, colours[cell.pair - 1].bg, 40, 100);
+            }
+            paint += 'm';
+            appendUtf8(paint, cell.ch);
+            penX = x + 1;
+        }
+    }
+    paint += "\x1b[0m";
+
+    std::string out = "{\"version\": 2, \"width\": " + std::to_string(frame.getCols()) +
+                      ", \"height\": " + std::to_string(frame.getRows()) + "}\n[0.000000, \"o\", ";
+    appendJsonString(out, paint);
+    out += "]\n";
+    char time[32];
+    for (size_t i = next; i < events.size() && events[i].time <= start + seconds; i++) {
+        std::snprintf(time, sizeof(time), "[%.6f, ", events[i].time - start);
+        out += time;
+        if (events[i].resizeRows > 0) {
+            out += "\"r\", \"" + std::to_string(events[i].resizeCols) + "x" + std::to_string(events[i].resizeRows) + "\"]\n";
+        } else {
+            out += "\"o\", ";
+            appendJsonString(out, events[i].data);
+            out += "]\n";
+        }
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && written;
+}
+
+void ReplayPlayer::resize(int rows, int cols) {
+    frame.resize(rows, cols);
+    writtenAt.assign(static_cast<size_t>(rows) * cols, 0);
+}
+
+void ReplayPlayer::restart() {
+    resize(startRows, startCols);
+    next = 0;
+    clock = 0;
+    cursorY = cursorX = 0;
+    penAttr = 0;
+    penPair = 0;
+    penFg = penBg = -1;
+}
+
+void ReplayPlayer::rewind() {
+    restart();
+    advance(0);
+}
+
+void ReplayPlayer::play(const Event& event) {
+    writes++;
+    if (event.resizeRows > 0) {
+        resize(event.resizeRows, event.resizeCols);
+        return;
+    }
+    // Every keyframe starts by clearing the screen; its cells did not move
+    keyframe = event.data.find("\x1b[2J") != std::string::npos;
+    feed(event.data);
+}
+
+void ReplayPlayer::advance(double seconds) {
+    if (events.empty()) return;
+    clock += seconds;
+    if (next == events.size() && clock >= getDuration() + LOOP_PAUSE) {
+        restart();
+    }
+    while (next < events.size() && events[next].time <= clock) {
+        play(events[next++]);
+    }
+}
+
+void ReplayPlayer::feed(const std::string& data) {
+    std::vector<int> params;
+    for (size_t i = 0; i < data.size(); i++) {
+        unsigned char c = data[i];
+        if (c == 0x1b) {
+            if (i + 1 < data.size() && data[i + 1] == '[') {
+                // CSI: optional '?', numbers separated by ';', final byte
+                i += 2;
+                bool isPrivate = i < data.size() && data[i] == '?';
+                if (isPrivate) i++;
+                params.assign(1, 0);
+                for (; i < data.size(); i++) {
+                    char p = data[i];
+                    if (p >= '0' && p <= '9') {
+                        params.back() = params.back() * 10 + (p - '0');
+                    } else if (p == ';') {
+                        params.push_back(0);
+                    } else {
+                        csi(p, params, isPrivate);
+                        break;
+                    }
+                }
+            } else {
+                i++;  // Two byte escape, e.g. ESC 7
+            }
+        } else if (c == '\r') {
+            cursorX = 0;
+        } else if (c == '\n') {
+            cursorY++;
+        } else if (c == '\b') {
+            if (cursorX > 0) cursorX--;
+        } else if (c < 0x20) {
+            continue;
+        } else if (c < 0x80) {
+            put(c);
+        } else {
+            // UTF-8 lead byte and its continuation bytes
+            int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+            uint32_t cp = c & (0x3F >> extra);
+            for (; extra > 0 && i + 1 < data.size(); extra--) {
+                cp = (cp << 6) | (data[++i] & 0x3F);
+            }
+            put(cp);
+        }
+    }
+}
+
+void ReplayPlayer::csi(char command, const std::vector<int>& params, bool isPrivate) {
+    if (isPrivate) return;  // Cursor visibility and other modes
+    int first = params[0] > 0 ? params[0] : 1;
+    switch (command) {
+        case 'H':
+        case 'f':
+            cursorY = first - 1;
+            cursorX = (params.size() > 1 && params[1] > 0 ? params[1] : 1) - 1;
+            break;
+        case 'A': cursorY -= first; break;
+        case 'B': cursorY += first; break;
+        case 'C': cursorX += first; break;
+        case 'D': cursorX -= first; break;
+        case 'J':
+            if (params[0] == 2) {
+                for (int y = 0; y < frame.getRows(); y++) blank(y, 0, frame.getCols());
+            } else if (params[0] == 0) {
+                blank(cursorY, cursorX, frame.getCols());
+                for (int y = cursorY + 1; y < frame.getRows(); y++) blank(y, 0, frame.getCols());
+            }
+            break;
+        case 'K':
+            blank(cursorY, params[0] == 0 ? cursorX : 0, params[0] == 1 ? cursorX + 1 : frame.getCols());
+            break;
+        case 'm':
+            sgr(params);
+            break;
+        default:
+            break;
+    }
+}
+
+void ReplayPlayer::sgr(const std::vector<int>& params) {
+    for (size_t i = 0; i < params.size(); i++) {
+        int p = params[i];
+        if (p == 0) {
+            penAttr = 0;
+            penFg = penBg = -1;
+        } else if (p == 1) {
+            penAttr |= A_BOLD;
+        } else if (p == 2) {
+            penAttr |= A_DIM;
+        } else if (p == 4) {
+            penAttr |= A_UNDERLINE;
+        } else if (p == 5) {
+            penAttr |= A_BLINK;
+        } else if (p == 7) {
+            penAttr |= A_REVERSE;
+        } else if (p >= 30 && p <= 37) {
+            penFg = p - 30;
+        } else if (p == 39) {
+            penFg = -1;
+        } else if (p >= 40 && p <= 47) {
+            penBg = p - 40;
+        } else if (p == 49) {
+            penBg = -1;
+        } else if (p >= 90 && p <= 97) {
+            penFg = p - 90 + 8;
+        } else if (p >= 100 && p <= 107) {
+            penBg = p - 100 + 8;
+        } else if ((p == 38 || p == 48) && i + 2 < params.size() && params[i + 1] == 5) {
+            (p == 38 ? penFg : penBg) = params[i + 2];
+            i += 2;
+        }
+    }
+
+    penPair = 0;
+    if (penFg < 0 && penBg < 0) return;
+    for (size_t i = 0; i < colours.size(); i++) {
+        if (colours[i].fg == penFg && colours[i].bg == penBg) {
+            penPair = i + 1;
+            return;
+        }
+    }
+    Colours added = { penFg, penBg };
+    colours.push_back(added);
+    penPair = colours.size();
+}
+
+void ReplayPlayer::put(uint32_t ch) {
+    if (cursorY >= 0 && cursorY < frame.getRows() && cursorX >= 0 && cursorX < frame.getCols()) {
+        ScreenCell written = { ch, penAttr, penPair };
+        ScreenCell& cell = frame.at(cursorY, cursorX);
+        if (cell != written) {
+            cell = written;
+            if (!keyframe) {
+                writtenAt[cursorY * frame.getCols() + cursorX] = writes;
+                if (trackView) {
+                    if (viewBottom < viewTop) {
+                        viewTop = viewBottom = cursorY;
+                        viewLeft = viewRight = cursorX;
+                    }
+                    viewTop = std::min(viewTop, cursorY);
+                    viewBottom = std::max(viewBottom, cursorY);
+                    viewLeft = std::min(viewLeft, cursorX);
+                    viewRight = std::max(viewRight, cursorX);
+                }
+            }
+        }
+    }
+    cursorX++;
+}
+
+void ReplayPlayer::blank(int y, int fromX, int toX) {
+    if (y < 0 || y >= frame.getRows()) return;
+    ScreenCell empty = { ' ', 0, 0 };
+    for (int x = std::max(fromX, 0); x < std::min(toX, frame.getCols()); x++) {
+        frame.at(y, x) = empty;
+    }
+}
+
+bool ReplayPreview::load(const std::string& path) {
+    if (!tried) {
+        tried = true;
+        player.load(path);
+    }
+    return player.isLoaded();
+}
+
+void ReplayPreview::rewind() {
+    player.rewind();
+    invalidate();
+}
+
+void ReplayPreview::invalidate() {
+    std::fill(shown.begin(), shown.end(), 0);
+}
+
+chtype ReplayPreview::cellLook(int top, int left, int bottom, int right) const {
+    const ScreenFrame& frame = player.getFrame();
+    const ScreenCell* best = nullptr;
+    int bestScore = 0;
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            const ScreenCell& cell = frame.at(y, x);
+            if (cell.ch == ' ' && !(cell.attr & A_REVERSE)) continue;
+            int score = 1 + (cell.pair != 0) + (player.changedWithin(y, x, RECENT_EVENTS) ? 4 : 0);
+            if (score > bestScore) {
+                best = &cell;
+                bestScore = score;
+            }
+        }
+    }
+    if (best == nullptr) return ' ';
+    chtype look = glyphFor(best->ch) | best->attr;
+    if (best->pair > 0) look |= pairFor(player.getColours()[best->pair - 1]);
+    return look;
+}
+
+void ReplayPreview::draw(int y, int x, int rows, int cols) {
+    if (!player.isLoaded() || rows <= 0 || cols <= 0) return;
+    if (rows != shownRows || cols != shownCols) {
+        shownRows = rows;
+        shownCols = cols;
+        shown.assign(static_cast<size_t>(rows) * cols, 0);
+    }
+
+    // The view may be bigger than the screen after a resize event
+    const ScreenFrame& frame = player.getFrame();
+    int viewTop = std::min(player.getViewTop(), frame.getRows() - 1);
+    int viewLeft = std::min(player.getViewLeft(), frame.getCols() - 1);
+    int viewRows = std::min(player.getViewRows(), frame.getRows() - viewTop);
+    int viewCols = std::min(player.getViewCols(), frame.getCols() - viewLeft);
+    if (viewRows <= 0 || viewCols <= 0) return;
+
+    for (int row = 0; row < rows; row++) {
+        int top = viewTop + row * viewRows / rows;
+        int bottom = std::max(top, viewTop + (row + 1) * viewRows / rows - 1);
+        for (int col = 0; col < cols; col++) {
+            int left = viewLeft + col * viewCols / cols;
+            int right = std::max(left, viewLeft + (col + 1) * viewCols / cols - 1);
+            chtype look = cellLook(top, left, bottom, right);
+            chtype& current = shown[row * cols + col];
+            if (look != current) {
+                mvaddch(y + row, x + col, look);
+                current = look;
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef REPLAY_PREVIEW_H
+#define REPLAY_PREVIEW_H
+
+#include "frame_encoder.h"
+#include <ncursesw/ncurses.h>
+#include <string>
+#include <vector>
+
+// Plays an asciicast v2 recording, as written by SessionRecorder, into a
+// ScreenFrame. Only the ANSI that FrameEncoder produces is understood:
+// cursor moves, SGR attributes and colours, clears and UTF-8 text; anything
+// else is skipped. Cell colours come back as (foreground, background)
+// numbers in getColours(), indexed by ScreenCell::pair - 1.
+class ReplayPlayer {
+public:
+    struct Colours {
+        short fg, bg;  // -1 is the terminal default
+    };
+
+private:
+    struct Event {
+        double time;
+        int resizeRows, resizeCols;  // 0 unless it is an "r" event
+        std::string data;
+    };
+
+    std::vector<Event> events;
+    int startRows, startCols;
+    ScreenFrame frame;
+    std::vector<unsigned long> writtenAt;  // Event that last changed each cell, 0 = none
+    unsigned long writes;                  // Events fed so far, never reset
+    std::vector<Colours> colours;
+
+    size_t next;     // Next event to play
+    double clock;    // Recording time played so far
+
+    // Decoder state
+    int cursorY, cursorX;
+    uint32_t penAttr;
+    short penPair;
+    short penFg, penBg;
+    bool keyframe;        // The event being fed repaints the whole screen
+
+    // Cells changed by normal frames during the first play through
+    int viewTop, viewLeft, viewBottom, viewRight;
+    bool trackView;
+
+    void resize(int rows, int cols);
+    void feed(const std::string& data);
+    void csi(char command, const std::vector<int>& params, bool isPrivate);
+    void sgr(const std::vector<int>& params);
+    void put(uint32_t ch);
+    void blank(int y, int fromX, int toX);
+    void play(const Event& event);
+    void restart();
+
+public:
+    ReplayPlayer();
+
+    // Reads the whole recording; false if it is missing or not asciicast v2
+    bool load(const std::string& path);
+    bool isLoaded() const { return !events.empty(); }
+
+    // Plays the next seconds of the recording, from the start again once it
+    // has run out
+    void advance(double seconds);
+    void rewind();
+
+    // Writes the part of the recording from start to start + seconds as a
+    // recording of its own, beginning with a keyframe of the screen at start.
+    // This is how a stage recording becomes its preview.cast.
+    bool writeClip(const std::string& path, double start, double seconds);
+
+    const ScreenFrame& getFrame() const { return frame; }
+    const std::vector<Colours>& getColours() const { return colours; }
+    double getDuration() const { return events.empty() ? 0 : events.back().time; }
+
+    // Whether a cell changed during the last few events (not counting keyframes)
+    bool changedWithin(int y, int x, unsigned long lastEvents) const {
+        unsigned long at = writtenAt[y * frame.getCols() + x];
+        return at != 0 && writes - at < lastEvents;
+    }
+
+    // The part of the screen where things move: the cells the recording
+    // changes after its keyframes, or the whole screen if nothing does
+    int getViewTop() const { return viewTop; }
+    int getViewLeft() const { return viewLeft; }
+    int getViewRows() const { return viewBottom - viewTop + 1; }
+    int getViewCols() const { return viewRight - viewLeft + 1; }
+};
+
+// A replay shrunk into a rectangle of stdscr, e.g. the highlighted level box
+// of the level menu. Each cell of the miniature shows the most eye-catching
+// cell of the block of the recording it covers: something that just moved,
+// then anything coloured, then any ink at all. Only cells that differ from
+// what the miniature drew last time are written.
+class ReplayPreview {
+private:
+    ReplayPlayer player;
+    bool tried;                 // load() already attempted
+    std::vector<chtype> shown;  // What each cell shows now, 0 = unknown
+    int shownRows, shownCols;
+
+    chtype cellLook(int top, int left, int bottom, int right) const;
+
+public:
+    ReplayPreview() : tried(false), shownRows(0), shownCols(0) {}
+
+    // Loads on first use only, so a missing file is not looked for again
+    bool load(const std::string& path);
+    bool isLoaded() const { return player.isLoaded(); }
+
+    void advance(double seconds) { player.advance(seconds); }
+    void rewind();
+
+    // Draws the current frame into rows x cols cells at (y, x)
+    void draw(int y, int x, int rows, int cols);
+
+    // After something else drew over the rectangle
+    void invalidate();
+};
+
+#endif // REPLAY_PREVIEW_H
@@ -0,0 +1,18 @@
+// Compiles a stage's round table from text to the binary the stage loads.
+// Usage: round_compiler <rounds.txt> <rounds.bin>
+#include "round_table.h"
+#include <cstdio>
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <rounds.txt> <rounds.bin>\n", argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    if (!RoundTable::compileFile(argv[1], argv[2], error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    return 0;
+}
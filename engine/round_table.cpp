@@ -0,0 +1,211 @@
+#include "round_table.h"
+#include "compiled_file.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+
+namespace {
+
+const char MAGIC[4] = { 'Y', 'R', 'T', '1' };
+
+} // namespace
+
+RoundTable::RoundTable()
+    : mapping(nullptr), mappingSize(0), header(nullptr), names(nullptr), values(nullptr) {}
+
+RoundTable::~RoundTable() {
+    release();
+}
+
+void RoundTable::release() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    compiled.clear();
+    header = nullptr;
+    names = nullptr;
+    values = nullptr;
+}
+
+bool RoundTable::attach(const char* data, size_t size) {
+    if (size < sizeof(Header)) return false;
+    const Header* candidate = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    size_t namesSize = static_cast<size_t>(candidate->columns) * NAME_LENGTH;
+    size_t valuesSize = static_cast<size_t>(candidate->rows) * candidate->columns * sizeof(float);
+    if (size != sizeof(Header) + namesSize + valuesSize) return false;
+
+    header = candidate;
+    names = data + sizeof(Header);
+    values = reinterpret_cast<const float*>(names + namesSize);
+    return true;
+}
+
+bool RoundTable::load(const std::string& binaryPath, const std::string& sourcePath,
+                      const std::vector<Column>& columns) {
+    release();
+    lastError.clear();
+
+    // Bring the binary up to date with the text if the designer edited it
+    long long sourceTime = modifiedTime(sourcePath);
+    if (sourceTime >= 0 && sourceTime > modifiedTime(binaryPath)) {
+        std::string compileError;
+        if (!compileFile(sourcePath, binaryPath, compileError)) {
+            // Could not write it (read-only directory?): use it from memory
+            if (!compile(sourcePath, compiled, lastError)) return false;
+            if (!attach(compiled.data(), compiled.size())) {
+                release();
+                lastError = sourcePath + ": compiled table is invalid";
+                return false;
+            }
+            return check(sourcePath, columns);
+        }
+    }
+
+    mapping = mapCompiledFile(binaryPath, mappingSize, lastError);
+    if (!mapping) return false;
+    if (!attach(static_cast<const char*>(mapping), mappingSize)) {
+        release();
+        lastError = binaryPath + ": not a round table";
+        return false;
+    }
+    return check(sourcePath, columns);
+}
+
+// Rejects the table if the stage would read a missing column or a value it
+// cannot use, so a bad edit is reported at load instead of playing as 0
+bool RoundTable::check(const std::string& sourcePath, const std::vector<Column>& columns) {
+    for (const Column& column : columns) {
+        int index = findColumn(column.name);
+        if (index < 0) {
+            lastError = sourcePath + ": missing column " + column.name;
+            release();
+            return false;
+        }
+        for (int round = 1; round <= rowCount(); round++) {
+            float value = values[static_cast<size_t>(round - 1) * header->columns + index];
+            if (!(value >= column.min && value <= column.max)) {
+                char range[64];
+                std::snprintf(range, sizeof(range), " must be from %g to %g", column.min, column.max);
+                lastError = sourcePath + ": round " + std::to_string(round) + ": " + column.name + range;
+                release();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int RoundTable::findColumn(const char* name) const {
+    if (!header) return -1;
+    for (uint32_t column = 0; column < header->columns; column++) {
+        if (std::strncmp(names + column * NAME_LENGTH, name, NAME_LENGTH) == 0) {
+            return static_cast<int>(column);
+        }
+    }
+    return -1;
+}
+
+float RoundTable::getFloat(int round, const char* column) const {
+    int index = findColumn(column);
+    if (index < 0) return 0.0f;
+    if (round > rowCount()) round = rowCount();
+    if (round < 1) round = 1;
+    return values[static_cast<size_t>(round - 1) * header->columns + index];
+}
+
+int RoundTable::getInt(int round, const char* column) const {
+    return static_cast<int>(std::lround(getFloat(round, column)));
+}
+
+bool RoundTable::compile(const std::string& sourcePath, std::vector<char>& image, std::string& error) {
+    std::ifstream file(sourcePath);
+    if (!file.is_open()) {
+        error = sourcePath + ": cannot open";
+        return false;
+    }
+
+    std::vector<std::string> columnNames;
+    std::vector<float> cells;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        std::string field;
+        std::vector<std::string> row;
+        while (fields >> field) row.push_back(field);
+        if (row.empty()) continue;
+
+        std::string where = sourcePath + ":" + std::to_string(lineNumber) + ": ";
+        if (columnNames.empty()) {
+            // First line names the columns
+            for (const std::string& name : row) {
+                if (name.size() >= NAME_LENGTH) {
+                    error = where + "column name too long: " + name;
+                    return false;
+                }
+            }
+            if (row[0] != "round") {
+                error = where + "first column must be \"round\"";
+                return false;
+            }
+            columnNames = row;
+            continue;
+        }
+
+        if (row.size() != columnNames.size()) {
+            error = where + "expected " + std::to_string(columnNames.size()) + " values";
+            return false;
+        }
+        size_t rowIndex = cells.size() / columnNames.size();
+        for (const std::string& text : row) {
+            char* end = nullptr;
+            float value = std::strtof(text.c_str(), &end);
+            if (end == text.c_str() || *end != '\0') {
+                error = where + "not a number: " + text;
+                return false;
+            }
+            cells.push_back(value);
+        }
+        if (cells[rowIndex * columnNames.size()] != static_cast<float>(rowIndex + 1)) {
+            error = where + "rounds must be numbered 1, 2, 3, ... in order";
+            return false;
+        }
+    }
+    if (columnNames.empty() || cells.empty()) {
+        error = sourcePath + ": no rounds";
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.columns = static_cast<uint32_t>(columnNames.size());
+    header.rows = static_cast<uint32_t>(cells.size() / columnNames.size());
+    header.reserved = 0;
+
+    image.assign(sizeof(Header) + columnNames.size() * NAME_LENGTH + cells.size() * sizeof(float), 0);
+    char* out = image.data();
+    std::memcpy(out, &header, sizeof(Header));
+    out += sizeof(Header);
+    for (const std::string& name : columnNames) {
+        std::memcpy(out, name.data(), name.size());
+        out += NAME_LENGTH;
+    }
+    std::memcpy(out, cells.data(), cells.size() * sizeof(float));
+    return true;
+}
+
+bool RoundTable::compileFile(const std::string& sourcePath, const std::string& binaryPath, std::string& error) {
+    std::vector<char> image;
+    if (!compile(sourcePath, image, error)) return false;
+    return writeCompiledFile(binaryPath, image, error);
+}
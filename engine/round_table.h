@@ -0,0 +1,79 @@
+#ifndef ROUND_TABLE_H
+#define ROUND_TABLE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Per-round difficulty settings for a stage, one row per round.
+//
+// Designers edit a text table (e.g. 1340_rounds.txt):
+//     # comment
+//     round  spaceship_spawn_interval  bomb_spawn_interval  max_enemies
+//     1      60                        -1                   8
+//     2      50                        120                  10
+// which round_compiler turns into a flat binary (1340_rounds.bin). The
+// binary is mapped straight into memory at startup, so loading it needs no
+// parsing. Rebalancing only needs the text edited; the binary is rebuilt by
+// make, or by load() itself when it is missing or older than the text.
+class RoundTable {
+public:
+    static const int NAME_LENGTH = 32;
+
+    // On-disk layout: header, column names, then rows * columns floats
+    struct Header {
+        char magic[4];       // "YRT1"
+        uint32_t rows;
+        uint32_t columns;
+        uint32_t reserved;
+    };
+
+    // A column the stage reads and the values it accepts
+    struct Column {
+        const char* name;
+        float min;
+        float max;
+    };
+
+private:
+    void* mapping;              // The mapped .bin, if it could be used
+    size_t mappingSize;
+    std::vector<char> compiled; // Otherwise the table compiled in memory
+    const Header* header;
+    const char* names;
+    const float* values;
+    std::string lastError;
+
+    bool attach(const char* data, size_t size);
+    bool check(const std::string& sourcePath, const std::vector<Column>& columns);
+    void release();
+
+public:
+    RoundTable();
+    ~RoundTable();
+    RoundTable(const RoundTable&) = delete;
+    RoundTable& operator=(const RoundTable&) = delete;
+
+    // Maps binaryPath, compiling sourcePath first if the binary is missing or
+    // out of date. Returns false with error() set if neither can be used, or
+    // if the table lacks one of columns or has a value out of its range.
+    bool load(const std::string& binaryPath, const std::string& sourcePath,
+              const std::vector<Column>& columns);
+
+    int rowCount() const { return header ? static_cast<int>(header->rows) : 0; }
+    int findColumn(const char* name) const;
+
+    // Rounds are numbered from 1; rounds past the end of the table use the
+    // last row. Columns checked by load() are always there; others read as 0.
+    float getFloat(int round, const char* column) const;
+    int getInt(int round, const char* column) const;
+
+    const std::string& error() const { return lastError; }
+
+    // Text form -> binary image. Every row must have one number per column
+    // and the first column must be "round", numbered 1, 2, 3, ...
+    static bool compile(const std::string& sourcePath, std::vector<char>& image, std::string& error);
+    static bool compileFile(const std::string& sourcePath, const std::string& binaryPath, std::string& error);
+};
+
+#endif // ROUND_TABLE_H
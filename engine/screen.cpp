@@ -0,0 +1,66 @@
+#include "screen.h"
+#include "terminal_graphics.h"
+#include "startup_timer.h"
+#include <ncursesw/ncurses.h>
+#include <clocale>
+
+static void setModes(bool nonBlocking) {
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    curs_set(0);
+    nodelay(stdscr, nonBlocking ? TRUE : FALSE);
+}
+
+bool initScreen(bool nonBlocking) {
+    if (stdscr == NULL) {
+        // Half blocks are a Unicode character, written in the user's encoding
+        if (graphicsMode() == GRAPHICS_HALF_BLOCK) setlocale(LC_ALL, "");
+        initscr();
+        if (has_colors()) start_color();
+        markStartup(STARTUP_SCREEN);
+    } else if (isendwin()) {
+        resumeScreen();
+    }
+    setModes(nonBlocking);
+    return has_colors();
+}
+
+void resumeScreen() {
+    // The next refresh leaves endwin() mode by itself; the screen has to be
+    // sent in full because someone else drew on the terminal meanwhile
+    clearok(curscr, TRUE);
+    refresh();
+    // endwin() showed the cursor again
+    curs_set(0);
+}
+
+InputMode::InputMode(int delay) : saved(wgetdelay(stdscr)) {
+    wtimeout(stdscr, delay);
+}
+
+InputMode::~InputMode() {
+    wtimeout(stdscr, saved);
+}
+
+PaletteScope::PaletteScope(std::initializer_list<PairColours> pairs) {
+    for (const PairColours& colours : pairs) set(colours.pair, colours.fg, colours.bg);
+}
+
+void PaletteScope::set(short pair, short fg, short bg) {
+    if (!has_colors()) return;
+    short oldFg, oldBg;
+    if (pair_content(pair, &oldFg, &oldBg) == ERR) return;
+    if (oldFg == fg && oldBg == bg) return;
+    PairColours previous = { pair, oldFg, oldBg };
+    saved.push_back(previous);
+    init_pair(pair, fg, bg);
+}
+
+PaletteScope::~PaletteScope() {
+    // Newest first, in case a pair was set twice
+    if (stdscr == NULL || isendwin()) return;
+    for (size_t i = saved.size(); i-- > 0;) {
+        init_pair(saved[i].pair, saved[i].fg, saved[i].bg);
+    }
+}
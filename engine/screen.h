@@ -0,0 +1,61 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <initializer_list>
+#include <vector>
+
+// The ncurses setup every stage and the main menu start with: cbreak, no
+// echo, keypad, hidden cursor, and colours when the terminal has them.
+// Returns true if colours are available; the caller sets up its own pairs.
+// A process has one screen for its whole life: calling this again (another
+// round, or the menu after a stage had the terminal) does not run initscr()
+// again, it only resumes the screen and puts these modes back.
+bool initScreen(bool nonBlocking = false);
+
+// Takes the terminal back after endwin() handed it to another program, e.g.
+// the menu after a stage has run. terminfo is not loaded again; the next
+// refresh repaints the whole screen, since the other program drew over it.
+void resumeScreen();
+
+// How getch() waits for the length of a scope: BLOCKING, NON_BLOCKING or a
+// timeout in milliseconds. The mode before it comes back when the scope
+// ends, so a dialogue or prompt no longer has to guess what to restore.
+class InputMode {
+private:
+    int saved;
+
+    InputMode(const InputMode&);
+    InputMode& operator=(const InputMode&);
+
+public:
+    static const int BLOCKING = -1;
+    static const int NON_BLOCKING = 0;
+
+    explicit InputMode(int delay);
+    ~InputMode();
+};
+
+// One colour pair's colours
+struct PairColours {
+    short pair, fg, bg;
+};
+
+// Colour pairs set for the length of a scope; the colours they had before
+// are put back when it ends. A pair that already has the wanted colours is
+// left alone, so setting up the same palette for every round costs nothing.
+class PaletteScope {
+private:
+    std::vector<PairColours> saved;
+
+    PaletteScope(const PaletteScope&);
+    PaletteScope& operator=(const PaletteScope&);
+
+public:
+    PaletteScope() {}
+    PaletteScope(std::initializer_list<PairColours> pairs);
+    ~PaletteScope();
+
+    void set(short pair, short fg, short bg);
+};
+
+#endif // SCREEN_H
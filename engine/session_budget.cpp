@@ -0,0 +1,132 @@
+#include "session_budget.h"
+#include <ncursesw/ncurses.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+#include <sys/resource.h>
+
+namespace {
+
+const int MAX_RENDER_INTERVAL = 8;
+
+double toSeconds(const timeval& time) {
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+double rusageSeconds(int who) {
+    rusage usage;
+    if (getrusage(who, &usage) != 0) return 0;
+    return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+}
+
+} // namespace
+
+SessionBudget::SessionBudget(double cpuPercent)
+    : budget(cpuPercent / 100.0), started(Clock::now()), windowStart(started),
+      cpuSeconds(0), windowCpuStart(0), recentUsage(0), ticks(0),
+      framesRendered(0), framesSkipped(0), renderInterval(1) {}
+
+bool SessionBudget::shouldRender() {
+    // Re-measure about once a second and adjust the render rate
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - windowStart).count();
+    if (elapsed >= 1.0) {
+        recentUsage = (cpuSeconds - windowCpuStart) / elapsed;
+        windowStart = now;
+        windowCpuStart = cpuSeconds;
+
+        if (budget > 0) {
+            if (recentUsage > budget && renderInterval < MAX_RENDER_INTERVAL) {
+                renderInterval *= 2;
+            } else if (recentUsage < budget / 2 && renderInterval > 1) {
+                renderInterval /= 2;
+            }
+        }
+    }
+
+    bool render = ticks++ % renderInterval == 0;
+    if (render) {
+        framesRendered++;
+    } else {
+        framesSkipped++;
+    }
+    return render;
+}
+
+std::string SessionBudget::overlayText(long rssKb) const {
+    char text[96];
+    int length = std::snprintf(text, sizeof(text), "CPU %.1f%%", recentUsage * 100);
+    if (budget > 0) {
+        length += std::snprintf(text + length, sizeof(text) - length, "/%.0f%%", budget * 100);
+    }
+    std::snprintf(text + length, sizeof(text) - length, " RSS %.1fM %lu fr 1/%d",
+                  rssKb / 1024.0, framesRendered, renderInterval);
+    return text;
+}
+
+std::string SessionBudget::summaryLine(const std::string& name, long rssKb) const {
+    double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "%s %s pid %d: %.1f s, CPU %.2f s (%.1f%%), RSS %ld kB, %lu frames rendered, %lu skipped",
+                  date, name.c_str(), static_cast<int>(getpid()), seconds, cpuSeconds,
+                  seconds > 0 ? 100.0 * cpuSeconds / seconds : 0.0, rssKb,
+                  framesRendered, framesSkipped);
+    return line;
+}
+
+double threadCpuSeconds() {
+    return rusageSeconds(RUSAGE_THREAD);
+}
+
+double processCpuSeconds() {
+    return rusageSeconds(RUSAGE_SELF);
+}
+
+long residentKb() {
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return -1;
+    long size = 0, resident = -1;
+    if (std::fscanf(statm, "%ld %ld", &size, &resident) != 2) resident = -1;
+    std::fclose(statm);
+    return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+double configuredCpuBudget() {
+    const char* value = std::getenv("YEAR1_CPU_BUDGET");
+    return value ? std::atof(value) : 0;
+}
+
+bool profilerOverlayEnabled() {
+    static const bool enabled = std::getenv("YEAR1_PROFILE") != nullptr;
+    return enabled;
+}
+
+void drawProfilerOverlay(const std::string& text) {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    // Fixed width so a shorter text does not leave old characters behind
+    const int width = 40;
+    int x = maxX - width;
+    if (x < 0 || maxY < 1) return;
+
+    attr_t savedAttrs;
+    short savedPair;
+    attr_get(&savedAttrs, &savedPair, nullptr);
+    attrset(A_REVERSE);
+    mvprintw(maxY - 1, x, "%*.*s", width - 1, width - 1, text.c_str());
+    attr_set(savedAttrs, savedPair, nullptr);
+}
+
+void appendSessionLog(const std::string& line) {
+    const char* path = std::getenv("YEAR1_SESSION_LOG");
+    FILE* log = std::fopen(path ? path : "year1_sessions.log", "a");
+    if (!log) return;
+    std::fprintf(log, "%s\n", line.c_str());
+    std::fclose(log);
+}
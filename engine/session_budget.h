@@ -0,0 +1,70 @@
+#ifndef SESSION_BUDGET_H
+#define SESSION_BUDGET_H
+
+#include <chrono>
+#include <string>
+
+// CPU time and frame counts of one session, with an optional CPU budget.
+//
+// The budget is a share of one core (YEAR1_CPU_BUDGET=5 means 5%). While a
+// session uses more than that, shouldRender() lets through only every 2nd,
+// 4th or 8th frame; the caller keeps running the simulation every tick, so
+// the game plays at the same speed, just less smoothly. Once usage falls
+// well below the budget the full frame rate comes back.
+class SessionBudget {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double budget;                // Fraction of one core, 0 = no limit
+    Clock::time_point started;
+    Clock::time_point windowStart;
+    double cpuSeconds;
+    double windowCpuStart;        // cpuSeconds when the window started
+    double recentUsage;           // Fraction of a core over the last window
+    unsigned long ticks;
+    unsigned long framesRendered;
+    unsigned long framesSkipped;
+    int renderInterval;           // Render every Nth tick
+
+public:
+    explicit SessionBudget(double cpuPercent = 0);
+
+    // CPU time accounting: the server adds the time of each tick, a stage
+    // process reports its total
+    void addCpuTime(double seconds) { cpuSeconds += seconds; }
+    void setCpuTime(double seconds) { cpuSeconds = seconds; }
+
+    // Call once per tick; returns whether this tick's frame should be drawn
+    bool shouldRender();
+
+    double getCpuSeconds() const { return cpuSeconds; }
+    unsigned long getFramesRendered() const { return framesRendered; }
+    int getRenderInterval() const { return renderInterval; }
+
+    // "CPU 3.1%/5% RSS 6.2M 1234 fr 1/2" for the profiler overlay
+    std::string overlayText(long rssKb) const;
+
+    // One line for the session log, written when the session ends
+    std::string summaryLine(const std::string& name, long rssKb) const;
+};
+
+// CPU time used so far by the calling thread / the whole process (getrusage)
+double threadCpuSeconds();
+double processCpuSeconds();
+
+// Resident memory of this process in kB, -1 if unavailable
+long residentKb();
+
+// YEAR1_CPU_BUDGET as a percentage of one core, 0 when unset
+double configuredCpuBudget();
+
+// Whether YEAR1_PROFILE is set
+bool profilerOverlayEnabled();
+
+// Draws text in reverse video in the bottom-right corner of stdscr
+void drawProfilerOverlay(const std::string& text);
+
+// Appends a line to YEAR1_SESSION_LOG (default year1_sessions.log)
+void appendSessionLog(const std::string& line);
+
+#endif // SESSION_BUDGET_H
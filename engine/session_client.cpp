@@ -0,0 +1,115 @@
+// Terminal client for the session server: relays the keyboard to the
+// server and the server's frames to the terminal. Ctrl-] disconnects.
+// Usage: year1_client [socket]             play
+//        year1_client --watch [id] [socket]  spectate a session (default: newest)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static termios savedTerminal;
+
+static void restoreTerminal() {
+    // Leave keypad mode and the alternate screen, show the cursor again
+    const char* reset = "\x1b[0m\x1b[?25h\x1b[?1l\x1b>\x1b[?1049l";
+    if (write(STDOUT_FILENO, reset, std::strlen(reset)) < 0) {
+        // Nothing more we can do
+    }
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedTerminal);
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) return false;
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool watch = false;
+    unsigned long watchId = 0;
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--watch") == 0) {
+        watch = true;
+        arg++;
+        if (arg < argc && std::isdigit(static_cast<unsigned char>(argv[arg][0]))) {
+            watchId = std::strtoul(argv[arg++], nullptr, 10);
+        }
+    }
+    std::string socketPath = arg < argc ? argv[arg] : "/tmp/year1_1340.sock";
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::perror(socketPath.c_str());
+        return 1;
+    }
+
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) < 0 || size.ws_col == 0) {
+        size.ws_col = 80;
+        size.ws_row = 24;
+    }
+    char handshake[64];
+    int length;
+    if (!watch) {
+        length = std::snprintf(handshake, sizeof(handshake), "YEAR1 %d %d\n", size.ws_col, size.ws_row);
+    } else if (watchId) {
+        length = std::snprintf(handshake, sizeof(handshake), "WATCH %lu\n", watchId);
+    } else {
+        length = std::snprintf(handshake, sizeof(handshake), "WATCH\n");
+    }
+    writeAll(fd, handshake, length);
+
+    tcgetattr(STDIN_FILENO, &savedTerminal);
+    termios raw = savedTerminal;
+    cfmakeraw(&raw);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+
+    // Alternate screen, and keypad mode so arrow keys match the server's terminfo
+    const char* setup = "\x1b[?1049h\x1b[?1h\x1b=";
+    writeAll(STDOUT_FILENO, setup, std::strlen(setup));
+
+    pollfd fds[2];
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[1].fd = fd;
+    fds[1].events = POLLIN;
+
+    char buffer[16384];
+    bool connected = true;
+    while (connected) {
+        if (poll(fds, 2, -1) < 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (n <= 0 || std::memchr(buffer, 0x1d, n)) break;  // Ctrl-]
+            if (!watch && !writeAll(fd, buffer, n)) break;
+        }
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                connected = false;
+            } else {
+                writeAll(STDOUT_FILENO, buffer, n);
+            }
+        }
+    }
+
+    restoreTerminal();
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "session_recorder.h"
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+
+namespace {
+
+// Keyframe roughly every five seconds at the games' 60 fps
+const int KEYFRAME_INTERVAL = 300;
+
+void appendTimestamp(std::string& out, double seconds) {
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%.6f", seconds);
+    out.append(buf, len);
+}
+
+void stopRecorderAtExit() {
+    SessionRecorder::instance().stop();
+}
+
+} // namespace
+
+void appendJsonString(std::string& out, const std::string& text) {
+    static const char* hex = "0123456789abcdef";
+    out += '"';
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+AsyncWriter::AsyncWriter() : file(nullptr), stopping(false) {}
+
+AsyncWriter::~AsyncWriter() {
+    close();
+}
+
+bool AsyncWriter::open(const std::string& path) {
+    file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    stopping = false;
+    worker = std::thread(&AsyncWriter::run, this);
+    return true;
+}
+
+void AsyncWriter::append(const std::string& data) {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending += data;
+    }
+    wake.notify_one();
+}
+
+void AsyncWriter::run() {
+    std::string writing;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [this] { return stopping || !pending.empty(); });
+        if (pending.empty() && stopping) break;
+
+        writing.swap(pending);
+        guard.unlock();
+        std::fwrite(writing.data(), 1, writing.size(), file);
+        std::fflush(file);
+        writing.clear();
+        guard.lock();
+    }
+}
+
+void AsyncWriter::close() {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) worker.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+SessionRecorder::SessionRecorder()
+    : encoder(KEYFRAME_INTERVAL), checkedEnvironment(false), active(false),
+      headerWritten(false), width(0), height(0) {}
+
+SessionRecorder& SessionRecorder::instance() {
+    static SessionRecorder recorder;
+    return recorder;
+}
+
+bool SessionRecorder::start(const std::string& directory) {
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+
+    std::string path = directory + "/" + program_invocation_short_name + "-" +
+                       stamp + "-" + std::to_string(getpid()) + ".cast";
+    if (!writer.open(path)) return false;
+
+    startTime = std::chrono::steady_clock::now();
+    std::atexit(stopRecorderAtExit);
+    return true;
+}
+
+void SessionRecorder::writeHeader() {
+    eventLine = "{\"version\": 2, \"width\": " + std::to_string(width) +
+                ", \"height\": " + std::to_string(height) +
+                ", \"timestamp\": " + std::to_string(static_cast<long long>(std::time(nullptr))) +
+                ", \"title\": ";
+    appendJsonString(eventLine, program_invocation_short_name);
+
+    const char* term = std::getenv("TERM");
+    eventLine += ", \"env\": {\"TERM\": ";
+    appendJsonString(eventLine, term ? term : "xterm-256color");
+    eventLine += "}}\n";
+
+    writer.append(eventLine);
+    headerWritten = true;
+}
+
+void SessionRecorder::recordFrame() {
+    if (!checkedEnvironment) {
+        checkedEnvironment = true;
+        const char* directory = std::getenv("YEAR1_RECORD");
+        if (directory && *directory) {
+            active = start(directory);
+        }
+    }
+    if (!active) return;
+
+    frameBytes.clear();
+    if (!encoder.encode(frameBytes)) return;
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    eventLine.clear();
+
+    if (!headerWritten) {
+        width = encoder.getCols();
+        height = encoder.getRows();
+        writeHeader();
+        eventLine.clear();
+    } else if (encoder.getCols() != width || encoder.getRows() != height) {
+        // Terminal was resized; the encoder has already produced a keyframe
+        width = encoder.getCols();
+        height = encoder.getRows();
+        eventLine += '[';
+        appendTimestamp(eventLine, elapsed);
+        eventLine += ", \"r\", \"" + std::to_string(width) + "x" + std::to_string(height) + "\"]\n";
+    }
+
+    eventLine += '[';
+    appendTimestamp(eventLine, elapsed);
+    eventLine += ", \"o\", ";
+    appendJsonString(eventLine, frameBytes);
+    eventLine += "]\n";
+    writer.append(eventLine);
+}
+
+void SessionRecorder::stop() {
+    if (!active) return;
+    active = false;
+    writer.close();
+}
@@ -0,0 +1,70 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include "frame_encoder.h"
+#include <string>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Appends bytes to a file from a background thread.
+// append() only copies into a buffer under a short lock; the worker swaps
+// buffers and does the actual fwrite/fflush, so the caller never blocks on disk.
+class AsyncWriter {
+private:
+    FILE* file;
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::string pending;
+    bool stopping;
+
+    void run();
+
+public:
+    AsyncWriter();
+    ~AsyncWriter();
+
+    bool open(const std::string& path);
+    void append(const std::string& data);
+    void close();  // Flushes everything still buffered and joins the worker
+
+    bool isOpen() const { return file != nullptr; }
+};
+
+// Records everything drawn on the terminal to an asciicast v2 file.
+// Enabled by setting YEAR1_RECORD to an output directory; each program
+// writes <dir>/<program>-<date>-<time>-<pid>.cast.
+class SessionRecorder {
+private:
+    AsyncWriter writer;
+    FrameEncoder encoder;
+    std::chrono::steady_clock::time_point startTime;
+    std::string frameBytes;   // Reused between frames to avoid reallocating
+    std::string eventLine;
+    bool checkedEnvironment;
+    bool active;
+    bool headerWritten;
+    int width, height;
+
+    SessionRecorder();
+
+    bool start(const std::string& directory);
+    void writeHeader();
+
+public:
+    static SessionRecorder& instance();
+
+    // Called after every refresh; a no-op unless recording is enabled
+    void recordFrame();
+    void stop();
+
+    bool isActive() const { return active; }
+};
+
+// Append text to out as a quoted JSON string
+void appendJsonString(std::string& out, const std::string& text);
+
+#endif // SESSION_RECORDER_H
@@ -0,0 +1,521 @@
+#include "session_server.h"
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+namespace {
+
+// Terminal type every session screen is created with. The encoder emits
+// plain ANSI, so this only decides which escape sequences ncurses expects
+// on input (the client switches its terminal to keypad mode to match).
+const char* SESSION_TERM = "xterm-256color";
+
+// Unsent output allowed per client before it is resynced with a keyframe
+const size_t OUTPUT_LIMIT = 256 * 1024;
+
+const int MAX_EVENTS = 64;
+
+} // namespace
+
+OutputQueue::OutputQueue(size_t limit) : headOffset(0), queuedBytes(0), maxBytes(limit) {}
+
+bool OutputQueue::push(const std::shared_ptr<const std::string>& frame) {
+    if (queuedBytes + frame->size() > maxBytes) return false;
+    frames.push_back(frame);
+    queuedBytes += frame->size();
+    return true;
+}
+
+bool OutputQueue::flush(int fd) {
+    while (!frames.empty()) {
+        const std::string& frame = *frames.front();
+        ssize_t sent = send(fd, frame.data() + headOffset, frame.size() - headOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        headOffset += sent;
+        queuedBytes -= sent;
+        if (headOffset == frame.size()) {
+            frames.pop_front();
+            headOffset = 0;
+        }
+    }
+    return true;
+}
+
+void OutputQueue::dropPending() {
+    // A frame that is half written has to be finished or the terminal
+    // would be left inside an escape sequence
+    size_t keep = headOffset > 0 ? 1 : 0;
+    while (frames.size() > keep) {
+        queuedBytes -= frames.back()->size();
+        frames.pop_back();
+    }
+}
+
+SessionTerminal::SessionTerminal() : screen(nullptr), inputFile(nullptr), outputFile(nullptr) {
+    inputPipe[0] = -1;
+    inputPipe[1] = -1;
+}
+
+Session::Session()
+    : fd(-1), id(0), output(OUTPUT_LIMIT), started(false), closing(false), wantWrite(false),
+      budget(configuredCpuBudget()), frameSkipped(false), spectator(false),
+      waitingForKeyframe(false), watching(nullptr) {}
+
+SessionServer::SessionServer(const std::string& path, SessionAppFactory appFactory, int hz)
+    : socketPath(path), factory(appFactory), tickHz(hz), epollFd(-1), listenFd(-1),
+      timerFd(-1), signalFd(-1), ticks(0), missedTicks(0), sessionsServed(0),
+      spectatorsServed(0), peakSessions(0), residentKbCache(0) {}
+
+SessionServer::~SessionServer() {
+    for (auto& session : sessions) {
+        closeSession(*session);
+    }
+    // Spare screens only write to /dev/null; process exit reclaims them
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (timerFd >= 0) close(timerFd);
+    if (signalFd >= 0) close(signalFd);
+    if (epollFd >= 0) close(epollFd);
+}
+
+bool SessionServer::openSocket() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "Socket path too long: %s\n", socketPath.c_str());
+        return false;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        std::perror("socket");
+        return false;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listenFd, 128) < 0) {
+        std::perror(socketPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SessionServer::watchFiles(const std::vector<std::string>& paths, FileChangeHandler handler) {
+    for (const std::string& path : paths) {
+        if (!watcher.watch(path)) return false;
+    }
+    onFileChange = handler;
+    return true;
+}
+
+void SessionServer::reloadChangedFiles() {
+    for (const std::string& path : watcher.changedFiles()) {
+        if (onFileChange) onFileChange(path);
+    }
+}
+
+int SessionServer::run() {
+    // Signals are read from a signalfd so shutdown happens inside the loop
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (!openSocket()) return 1;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (epollFd < 0 || timerFd < 0 || signalFd < 0) {
+        std::perror("epoll/timerfd/signalfd");
+        return 1;
+    }
+
+    // One shared tick for every session
+    itimerspec period;
+    period.it_interval.tv_sec = 0;
+    period.it_interval.tv_nsec = 1000000000L / tickHz;
+    period.it_value = period.it_interval;
+    timerfd_settime(timerFd, 0, &period, nullptr);
+
+    // Fixed descriptors are told apart from sessions by their data pointer
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.ptr = &timerFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event);
+    event.data.ptr = &signalFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &event);
+    if (watcher.fd() >= 0) {
+        event.data.ptr = &watcher;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, watcher.fd(), &event);
+    }
+
+    std::fprintf(stderr, "Listening on %s (%d ticks/s)\n", socketPath.c_str(), tickHz);
+
+    epoll_event events[MAX_EVENTS];
+    bool running = true;
+    while (running) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            void* source = events[i].data.ptr;
+            if (source == &listenFd) {
+                acceptClients();
+            } else if (source == &timerFd) {
+                tickSessions();
+            } else if (source == &signalFd) {
+                running = false;
+            } else if (source == &watcher) {
+                reloadChangedFiles();
+            } else {
+                Session& session = *static_cast<Session*>(source);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP | EPOLLERR)) {
+                    readClient(session);
+                }
+                if (!session.closing && (events[i].events & EPOLLOUT)) {
+                    if (!session.output.flush(session.fd)) {
+                        session.closing = true;
+                    } else {
+                        updateWriteInterest(session);
+                    }
+                }
+            }
+        }
+        removeClosedSessions();
+    }
+
+    std::fprintf(stderr, "Served %lu sessions and %lu spectators (peak %zu concurrent), %lu ticks, %lu missed\n",
+                 sessionsServed, spectatorsServed, peakSessions, ticks, missedTicks);
+    return 0;
+}
+
+void SessionServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+
+        std::unique_ptr<Session> session(new Session());
+        session->fd = fd;
+
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = session.get();
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+        sessions.push_back(std::move(session));
+        if (sessions.size() > peakSessions) peakSessions = sessions.size();
+    }
+}
+
+void SessionServer::readClient(Session& session) {
+    char buffer[4096];
+    while (true) {
+        ssize_t received = read(session.fd, buffer, sizeof(buffer));
+        if (received == 0) {
+            session.closing = true;
+            return;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) session.closing = true;
+            return;
+        }
+
+        const char* data = buffer;
+        size_t length = static_cast<size_t>(received);
+
+        if (!session.started) {
+            // Collect the handshake line before anything goes to ncurses
+            const char* newline = static_cast<const char*>(std::memchr(data, '\n', length));
+            size_t take = newline ? static_cast<size_t>(newline - data) + 1 : length;
+            session.handshake.append(data, take);
+            data += take;
+            length -= take;
+
+            if (!newline) {
+                if (session.handshake.size() > 256) session.closing = true;
+                continue;
+            }
+            bool ok = session.handshake.compare(0, 5, "WATCH") == 0 ?
+                      startSpectator(session) : startSession(session);
+            if (!ok) {
+                session.closing = true;
+                return;
+            }
+        }
+
+        // Spectators are read-only
+        if (session.spectator) continue;
+
+        // Keyboard input; if ncurses has not read the pipe yet and it is
+        // full the extra keys are dropped rather than blocking the server
+        if (length > 0 && write(session.terminal.inputPipe[1], data, length) < 0 && errno != EAGAIN) {
+            session.closing = true;
+            return;
+        }
+    }
+}
+
+bool SessionServer::openTerminal(SessionTerminal& terminal) {
+    if (pipe2(terminal.inputPipe, O_CLOEXEC | O_NONBLOCK) < 0) return false;
+
+    terminal.inputFile = fdopen(terminal.inputPipe[0], "r");
+    terminal.outputFile = std::fopen("/dev/null", "w");
+    if (!terminal.inputFile || !terminal.outputFile) return false;
+
+    terminal.screen = newterm(SESSION_TERM, terminal.outputFile, terminal.inputFile);
+    return terminal.screen != nullptr;
+}
+
+bool SessionServer::startSession(Session& session) {
+    int cols = 0, rows = 0;
+    if (std::sscanf(session.handshake.c_str(), "YEAR1 %d %d", &cols, &rows) != 2 ||
+        cols < 20 || rows < 10 || cols > 1000 || rows > 1000) {
+        return false;
+    }
+
+    if (!spareTerminals.empty()) {
+        session.terminal = spareTerminals.back();
+        spareTerminals.pop_back();
+        set_term(session.terminal.screen);
+    } else if (openTerminal(session.terminal)) {
+        set_term(session.terminal.screen);
+    } else {
+        return false;
+    }
+
+    resizeterm(rows, cols);
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+    curs_set(0);
+    attrset(A_NORMAL);
+    clear();
+
+    session.app = factory();
+    session.app->start();
+    session.started = true;
+    session.id = ++sessionsServed;
+    std::fprintf(stderr, "Session %lu started (%dx%d)\n", session.id, cols, rows);
+    return true;
+}
+
+bool SessionServer::startSpectator(Session& spectator) {
+    // "WATCH <id>" picks a session, plain "WATCH" follows the newest one
+    unsigned long id = 0;
+    std::sscanf(spectator.handshake.c_str(), "WATCH %lu", &id);
+
+    Session* target = nullptr;
+    for (auto& entry : sessions) {
+        Session& session = *entry;
+        if (!session.started || session.spectator || session.closing) continue;
+        if (id ? session.id == id : (!target || session.id > target->id)) {
+            target = &session;
+        }
+    }
+    if (!target) return false;
+
+    spectator.spectator = true;
+    spectator.started = true;
+    spectator.watching = target;
+    target->spectators.push_back(&spectator);
+
+    // Diffs are meaningless without a full screen to apply them to
+    spectator.waitingForKeyframe = true;
+    target->encoder.requestKeyframe();
+    spectatorsServed++;
+    return true;
+}
+
+void SessionServer::broadcast(Session& session, const std::shared_ptr<const std::string>& frame,
+                              bool isKeyframe) {
+    for (Session* spectator : session.spectators) {
+        if (spectator->closing) continue;
+
+        if (spectator->output.size() >= OUTPUT_LIMIT / 2) {
+            // Spectator is not keeping up: skip ahead to the next keyframe
+            // rather than holding back the player
+            spectator->output.dropPending();
+            spectator->waitingForKeyframe = true;
+        }
+        if (spectator->waitingForKeyframe && !isKeyframe) continue;
+
+        if (spectator->output.push(frame)) {
+            spectator->waitingForKeyframe = false;
+        } else {
+            spectator->waitingForKeyframe = true;
+        }
+
+        if (!spectator->output.flush(spectator->fd)) {
+            spectator->closing = true;
+            continue;
+        }
+        updateWriteInterest(*spectator);
+    }
+}
+
+void SessionServer::tickSessions() {
+    uint64_t expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+    // Late ticks are skipped rather than run back to back
+    if (expirations > 1) missedTicks += expirations - 1;
+    ticks++;
+    if (profilerOverlayEnabled() && ticks % tickHz == 1) residentKbCache = residentKb();
+
+    // CPU time is read between sessions so each one is charged for its own
+    // tick, drawing, encoding and sending
+    double cpuMark = threadCpuSeconds();
+
+    for (auto& entry : sessions) {
+        Session& session = *entry;
+        if (!session.started || session.closing || session.spectator) continue;
+
+        set_term(session.terminal.screen);
+        bool alive = session.app->tick();
+
+        if (alive && !session.budget.shouldRender()) {
+            // Over budget: the game moves on but this frame is not drawn.
+            // Untouching stdscr also stops the next getch() from refreshing
+            // it; the whole window is touched again before the next frame.
+            untouchwin(stdscr);
+            session.frameSkipped = true;
+        } else {
+            if (session.frameSkipped) {
+                touchwin(stdscr);
+                session.frameSkipped = false;
+            }
+            if (profilerOverlayEnabled()) {
+                drawProfilerOverlay(session.budget.overlayText(residentKbCache));
+            }
+            refresh();
+
+            if (session.output.size() >= OUTPUT_LIMIT / 2) {
+                // Client is not keeping up: forget queued diffs and resync
+                session.output.dropPending();
+                session.encoder.requestKeyframe();
+            }
+
+            // Encoded once; the player and every spectator share the buffer
+            std::string encoded;
+            bool isKeyframe = false;
+            if (session.encoder.encode(encoded, isKeyframe)) {
+                std::shared_ptr<const std::string> frame = std::make_shared<const std::string>(std::move(encoded));
+                if (!session.output.push(frame)) {
+                    session.encoder.requestKeyframe();
+                }
+                broadcast(session, frame, isKeyframe);
+            }
+        }
+
+        bool flushed = session.output.flush(session.fd);
+        double now = threadCpuSeconds();
+        session.budget.addCpuTime(now - cpuMark);
+        cpuMark = now;
+
+        if (!flushed) {
+            session.closing = true;
+            continue;
+        }
+        updateWriteInterest(session);
+
+        if (!alive) session.closing = true;
+    }
+}
+
+void SessionServer::updateWriteInterest(Session& session) {
+    bool needWrite = !session.output.empty();
+    if (needWrite == session.wantWrite) return;
+
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | (needWrite ? EPOLLOUT : 0);
+    event.data.ptr = &session;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+    session.wantWrite = needWrite;
+}
+
+void SessionServer::closeSession(Session& session) {
+    // Spectators leave with the player they watch
+    for (Session* spectator : session.spectators) {
+        spectator->watching = nullptr;
+        spectator->closing = true;
+    }
+    session.spectators.clear();
+    if (session.watching) {
+        std::vector<Session*>& list = session.watching->spectators;
+        list.erase(std::remove(list.begin(), list.end(), &session), list.end());
+        session.watching = nullptr;
+    }
+
+    if (session.fd >= 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, session.fd, nullptr);
+        // Last chance for the final screen to reach the client
+        session.output.flush(session.fd);
+        close(session.fd);
+        session.fd = -1;
+    }
+
+    if (session.started && !session.spectator) {
+        // Memory is per process: every session's line shows the server's RSS
+        appendSessionLog(session.budget.summaryLine("session " + std::to_string(session.id) +
+                                                    " (server RSS)", residentKb()));
+    }
+
+    SessionTerminal& terminal = session.terminal;
+    if (terminal.screen) {
+        // Wipe the screen and any unread keys, then keep it for the next player
+        session.app.reset();
+        set_term(terminal.screen);
+        flushinp();
+        char discard[256];
+        while (read(terminal.inputPipe[0], discard, sizeof(discard)) > 0) {}
+        clear();
+        refresh();
+        spareTerminals.push_back(terminal);
+        terminal = SessionTerminal();
+    } else {
+        // Setup failed part way through
+        if (terminal.inputFile) std::fclose(terminal.inputFile);
+        else if (terminal.inputPipe[0] >= 0) close(terminal.inputPipe[0]);
+        if (terminal.inputPipe[1] >= 0) close(terminal.inputPipe[1]);
+        if (terminal.outputFile) std::fclose(terminal.outputFile);
+        terminal = SessionTerminal();
+    }
+}
+
+void SessionServer::removeClosedSessions() {
+    for (size_t i = 0; i < sessions.size();) {
+        if (sessions[i]->closing) {
+            closeSession(*sessions[i]);
+            sessions[i] = std::move(sessions.back());
+            sessions.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#ifndef SESSION_SERVER_H
+#define SESSION_SERVER_H
+
+#include "frame_encoder.h"
+#include "file_watcher.h"
+#include "session_budget.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <cstdio>
+
+// A stage (or any screen flow) hosted by the session server.
+// tick() is called once per scheduler tick with the session's ncurses screen
+// selected, so the usual stdscr calls (getch, mvprintw, ...) work unchanged.
+// It must never block; return false when the session is finished.
+class SessionApp {
+public:
+    virtual ~SessionApp() = default;
+
+    virtual void start() = 0;
+    virtual bool tick() = 0;
+};
+
+typedef std::function<std::unique_ptr<SessionApp>()> SessionAppFactory;
+
+// Called from the server loop with the path of a watched file that changed
+typedef std::function<void(const std::string&)> FileChangeHandler;
+
+// Encoded frames waiting to be written to a socket. Frames are kept whole so
+// that when a reader falls too far behind the queue can be dropped without
+// cutting an escape sequence in half.
+class OutputQueue {
+private:
+    std::deque<std::shared_ptr<const std::string>> frames;
+    size_t headOffset;   // Bytes of the first frame already written
+    size_t queuedBytes;
+    size_t maxBytes;
+
+public:
+    explicit OutputQueue(size_t limit);
+
+    // Returns false if the frame did not fit; the caller should resync the
+    // reader with a keyframe
+    bool push(const std::shared_ptr<const std::string>& frame);
+
+    // Writes as much as the socket accepts. Returns false on a socket error.
+    bool flush(int fd);
+
+    // Drop everything that has not started sending yet
+    void dropPending();
+
+    bool empty() const { return frames.empty(); }
+    size_t size() const { return queuedBytes; }
+};
+
+// An ncurses screen and the plumbing behind it. Screens are recycled between
+// sessions rather than deleted, since delscreen() with many screens alive
+// can free windows that belong to another screen.
+struct SessionTerminal {
+    SCREEN* screen;
+    int inputPipe[2];          // Client bytes are fed to ncurses through this pipe
+    FILE* inputFile;
+    FILE* outputFile;          // ncurses writes here (/dev/null); the encoder produces the real output
+
+    SessionTerminal();
+};
+
+// One connected client: a player, or a read-only spectator of a player
+struct Session {
+    int fd;                    // Client socket
+    unsigned long id;          // Assigned when a player's session starts
+    SessionTerminal terminal;
+    FrameEncoder encoder;
+    OutputQueue output;
+    std::string handshake;     // Collected until the first newline
+    std::unique_ptr<SessionApp> app;
+    bool started;
+    bool closing;
+    bool wantWrite;            // Whether EPOLLOUT is currently registered
+    SessionBudget budget;      // CPU time and frames; may throttle rendering
+    bool frameSkipped;         // stdscr changes not yet refreshed
+
+    // Spectating
+    bool spectator;
+    bool waitingForKeyframe;   // Spectator skipping diffs until the next keyframe
+    Session* watching;         // Player a spectator is attached to
+    std::vector<Session*> spectators;
+
+    Session();
+};
+
+// Hosts many players in one process. Clients connect to a Unix socket, send
+// a "YEAR1 <cols> <rows>" line, then raw keyboard bytes. Each session gets
+// its own ncurses SCREEN; a single timerfd drives every session's tick and
+// the screen is streamed back as diff-encoded frames.
+//
+// A client that sends "WATCH [id]" instead becomes a spectator of that
+// session (or the newest one). Each frame is encoded once and the same
+// buffer is queued for the player and every spectator.
+//
+// With YEAR1_CPU_BUDGET set, a session that uses more than that share of a
+// core is rendered less often (its tick still runs every time). Each player's
+// CPU, memory and frame counts go to the session log when it ends, and
+// YEAR1_PROFILE shows them live in the bottom-right corner.
+class SessionServer {
+private:
+    std::string socketPath;
+    SessionAppFactory factory;
+    int tickHz;
+    int epollFd;
+    int listenFd;
+    int timerFd;
+    int signalFd;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::vector<SessionTerminal> spareTerminals;
+    FileWatcher watcher;
+    FileChangeHandler onFileChange;
+
+    // Statistics printed on shutdown
+    unsigned long ticks;
+    unsigned long missedTicks;
+    unsigned long sessionsServed;
+    unsigned long spectatorsServed;
+    size_t peakSessions;
+    long residentKbCache;      // Refreshed once a second for the overlay
+
+    bool openSocket();
+    void acceptClients();
+    void readClient(Session& session);
+    bool openTerminal(SessionTerminal& terminal);
+    bool startSession(Session& session);
+    bool startSpectator(Session& spectator);
+    void broadcast(Session& session, const std::shared_ptr<const std::string>& frame, bool isKeyframe);
+    void tickSessions();
+    void reloadChangedFiles();
+    void updateWriteInterest(Session& session);
+    void closeSession(Session& session);
+    void removeClosedSessions();
+
+public:
+    SessionServer(const std::string& path, SessionAppFactory appFactory, int hz = 60);
+    ~SessionServer();
+
+    // Calls handler from the loop, between ticks, whenever one of the files
+    // is rewritten. Call before run().
+    bool watchFiles(const std::vector<std::string>& paths, FileChangeHandler handler);
+
+    // Runs until SIGINT/SIGTERM. Returns a process exit code.
+    int run();
+};
+
+#endif // SESSION_SERVER_H
@@ -0,0 +1,53 @@
+#include "snapshot_ring.h"
+#include <ncursesw/ncurses.h>
+#include <cstdlib>
+
+SnapshotRing::SnapshotRing(int slotCount, int everyTicks)
+    : slots(slotCount > 0 ? slotCount : 1), interval(everyTicks > 0 ? everyTicks : 1),
+      newest(-1), count(0), ticks(0) {}
+
+SnapshotBuffer* SnapshotRing::capture() {
+    if (ticks++ % interval != 0) return nullptr;
+
+    int size = static_cast<int>(slots.size());
+    newest = (newest + 1) % size;
+    if (count < size) count++;
+    slots[newest].clear();
+    return &slots[newest];
+}
+
+SnapshotBuffer* SnapshotRing::rewind() {
+    if (count == 0) return nullptr;
+
+    int size = static_cast<int>(slots.size());
+    if (count > 1) {
+        newest = (newest + size - 1) % size;
+        count--;
+    }
+    // The restored state is the latest snapshot again; the next one is
+    // taken a full interval later
+    ticks = 1;
+    slots[newest].rewindRead();
+    return &slots[newest];
+}
+
+size_t SnapshotRing::bytesUsed() const {
+    size_t total = 0;
+    for (const SnapshotBuffer& slot : slots) total += slot.size();
+    return total;
+}
+
+size_t SnapshotRing::bytesReserved() const {
+    size_t total = 0;
+    for (const SnapshotBuffer& slot : slots) total += slot.capacity();
+    return total;
+}
+
+bool rewindEnabled() {
+    static const bool enabled = std::getenv("YEAR1_REWIND") != nullptr;
+    return enabled;
+}
+
+bool isRewindKey(int ch) {
+    return ch == KEY_BACKSPACE || ch == 127 || ch == '\b';
+}
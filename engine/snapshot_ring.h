@@ -0,0 +1,111 @@
+#ifndef SNAPSHOT_RING_H
+#define SNAPSHOT_RING_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// A snapshot of a stage's world: the entities, timers, random generator
+// state, HP and score, written as a run of plain records and read back in
+// the same order. Only trivially copyable values go in (ints, Fixed, enums
+// and the entity classes that hold nothing else), so a snapshot is a few
+// memcpy()s into a buffer that keeps its capacity from one use to the next.
+class SnapshotBuffer {
+private:
+    std::vector<unsigned char> bytes;
+    size_t readPos;
+
+public:
+    SnapshotBuffer() : readPos(0) {}
+
+    void clear() { bytes.clear(); readPos = 0; }
+    void rewindRead() { readPos = 0; }
+    size_t size() const { return bytes.size(); }
+    size_t capacity() const { return bytes.capacity(); }
+
+    template <class T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain data only");
+        size_t at = bytes.size();
+        bytes.resize(at + sizeof(T));
+        std::memcpy(&bytes[at], &value, sizeof(T));
+    }
+
+    // A vector is its length followed by its elements
+    template <class T>
+    void put(const std::vector<T>& values) {
+        put(values.size());
+        for (const T& value : values) put(value);
+    }
+
+    template <class T, class... Rest>
+    void put(const T& first, const Rest&... rest) {
+        put(first);
+        put(rest...);
+    }
+
+    template <class T>
+    void get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshots hold plain data only");
+        std::memcpy(static_cast<void*>(&value), &bytes[readPos], sizeof(T));
+        readPos += sizeof(T);
+    }
+
+    template <class T>
+    void get(std::vector<T>& values) {
+        size_t count;
+        get(count);
+        // Element types need not be default constructible
+        values.clear();
+        values.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type element;
+            get(reinterpret_cast<T&>(element));
+            values.push_back(reinterpret_cast<T&>(element));
+        }
+    }
+
+    template <class T, class... Rest>
+    void get(T& first, Rest&... rest) {
+        get(first);
+        get(rest...);
+    }
+};
+
+// The last few snapshots of a round, one taken every `interval` ticks, for
+// the rewind debug key. Slots are reused oldest first, so once the ring has
+// gone round a capture allocates nothing.
+class SnapshotRing {
+private:
+    std::vector<SnapshotBuffer> slots;
+    int interval;
+    int newest;                // Slot of the latest snapshot
+    int count;                 // Snapshots held
+    unsigned long ticks;
+
+public:
+    explicit SnapshotRing(int slotCount = 32, int everyTicks = 30);
+
+    // Call once per tick. Returns the cleared slot to write this tick's
+    // snapshot into, or null when no snapshot is due.
+    SnapshotBuffer* capture();
+
+    // Steps back one snapshot and returns it ready to read, or null when
+    // there is none. The newest snapshot is dropped (unless it is the only
+    // one), so pressing the key again goes further back and playing on
+    // from here records a new history.
+    SnapshotBuffer* rewind();
+
+    // Snapshot bytes held / reserved, for the profiler overlay and tuning
+    size_t bytesUsed() const;
+    size_t bytesReserved() const;
+};
+
+// Whether YEAR1_REWIND is set: the stages then keep a snapshot ring and
+// rewind on Backspace. Off by default so a normal run pays nothing.
+bool rewindEnabled();
+
+bool isRewindKey(int ch);
+
+#endif // SNAPSHOT_RING_H
@@ -0,0 +1,152 @@
+#include "stage_result.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace {
+
+const char MAGIC[4] = { 'Y', 'S', 'R', '1' };
+const char* const ENV_NAME = "YEAR1_RESULT_SHM";
+
+// Set while a channel in this process is open, so stage code running in the
+// launcher's process reports into the same block without mapping it again
+StageResult* channelBlock = nullptr;
+
+StageResult* mapBlock(int fd) {
+    void* mapping = mmap(nullptr, sizeof(StageResult), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return mapping == MAP_FAILED ? nullptr : static_cast<StageResult*>(mapping);
+}
+
+// The launcher's block named in the environment, if there is one
+StageResult* attachShared() {
+    const char* name = std::getenv(ENV_NAME);
+    if (name == nullptr || name[0] == '\0') return nullptr;
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) return nullptr;
+    StageResult* block = mapBlock(fd);
+    close(fd);
+    if (block && std::memcmp(block->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        munmap(block, sizeof(StageResult));
+        return nullptr;
+    }
+    return block;
+}
+
+} // namespace
+
+void StageResult::clear() {
+    std::memset(this, 0, sizeof(*this));
+    std::memcpy(magic, MAGIC, sizeof(MAGIC));
+    hp = -1;
+}
+
+void StageResult::addFrame(double workSeconds, unsigned dropped) {
+    int bucket = 0;
+    double limit = 0.001;
+    while (bucket < FRAME_BUCKETS - 1 && workSeconds >= limit) {
+        bucket++;
+        limit *= 2;
+    }
+    frameTimes[bucket]++;
+    frames++;
+    droppedFrames += dropped;
+}
+
+void StageResult::addFrames(const StageResult& other) {
+    for (int bucket = 0; bucket < FRAME_BUCKETS; bucket++) frameTimes[bucket] += other.frameTimes[bucket];
+    frames += other.frames;
+    droppedFrames += other.droppedFrames;
+}
+
+int StageResult::frameTimeLimitMs(double fraction) const {
+    if (frames == 0) return 0;
+    unsigned long wanted = static_cast<unsigned long>(frames * fraction + 0.5);
+    unsigned long seen = 0;
+    for (int bucket = 0; bucket < FRAME_BUCKETS - 1; bucket++) {
+        seen += frameTimes[bucket];
+        if (seen >= wanted) return 1 << bucket;
+    }
+    return 1 << (FRAME_BUCKETS - 2);
+}
+
+StageResultChannel::StageResultChannel() : block(nullptr) {}
+
+StageResultChannel::~StageResultChannel() {
+    if (!block) return;
+    if (channelBlock == block) channelBlock = nullptr;
+    munmap(block, sizeof(StageResult));
+    shm_unlink(name.c_str());
+    unsetenv(ENV_NAME);
+}
+
+bool StageResultChannel::open() {
+    if (block) return true;
+    char buffer[48];
+    std::snprintf(buffer, sizeof(buffer), "/year1-result-%ld", static_cast<long>(getpid()));
+    int fd = shm_open(buffer, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        // Left behind by an earlier launcher that had this pid and crashed
+        shm_unlink(buffer);
+        fd = shm_open(buffer, O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0) return false;
+    if (ftruncate(fd, sizeof(StageResult)) == 0) block = mapBlock(fd);
+    close(fd);
+    if (!block) {
+        shm_unlink(buffer);
+        return false;
+    }
+    name = buffer;
+    block->clear();
+    channelBlock = block;
+    setenv(ENV_NAME, buffer, 1);
+    return true;
+}
+
+void StageResultChannel::clear() {
+    if (block) block->clear();
+}
+
+StageResult StageResultChannel::read() const {
+    StageResult result;
+    if (block) {
+        // The stage has exited; the acquire pairs with its final store
+        __atomic_load_n(&block->state, __ATOMIC_ACQUIRE);
+        result = *block;
+    } else {
+        result.clear();
+    }
+    return result;
+}
+
+StageResult& stageResult() {
+    static StageResult* block = nullptr;
+    static StageResult local;
+    if (!block) {
+        block = channelBlock ? channelBlock : attachShared();
+        if (!block) {
+            local.clear();
+            block = &local;
+        }
+    }
+    // A fresh (or cleared) block is claimed by whoever reports first
+    if (block->state == StageResult::EMPTY) {
+        std::strncpy(block->stage, program_invocation_short_name, StageResult::STAGE_LENGTH - 1);
+        block->state = StageResult::PLAYING;
+    }
+    return *block;
+}
+
+void reportStageOutcome(bool won, int roundsReached, int hp, int score) {
+    StageResult& result = stageResult();
+    result.won = won ? 1 : 0;
+    result.roundsReached = roundsReached;
+    result.hp = hp;
+    result.score = score;
+    // Last, so a reader that sees FINISHED sees the fields above
+    __atomic_store_n(&result.state, static_cast<uint32_t>(StageResult::FINISHED), __ATOMIC_RELEASE);
+}
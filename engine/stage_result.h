@@ -0,0 +1,87 @@
+#ifndef STAGE_RESULT_H
+#define STAGE_RESULT_H
+
+#include <stdint.h>
+#include <string>
+
+// How a stage went, reported back to whoever launched it: the outcome, and
+// how the frames were paced. The layout is fixed (only 32-bit fields, no
+// pointers) because the block is shared between processes: the menu creates
+// it in shared memory and each stage it starts writes straight into it.
+struct StageResult {
+    static const int STAGE_LENGTH = 16;
+
+    // Frame work time (update + draw, not the sleep) in powers of two of a
+    // millisecond: bucket 0 is under 1 ms, bucket i is under 2^i ms, and
+    // the last bucket is everything from 64 ms up
+    static const int FRAME_BUCKETS = 8;
+
+    enum State : uint32_t {
+        EMPTY = 0,     // No stage has reported into it yet
+        PLAYING = 1,   // A stage attached; the outcome fields are not set
+        FINISHED = 2,  // The stage reported its outcome
+    };
+
+    char magic[4];          // "YSR1"
+    uint32_t state;
+    char stage[STAGE_LENGTH];  // Program name of the stage, e.g. "1340"
+    int32_t won;            // 1 if every round was cleared
+    int32_t roundsReached;  // The round the game ended in, or the last one
+    int32_t hp;             // HP left, -1 for stages without HP
+    int32_t score;
+    uint32_t frames;
+    uint32_t droppedFrames; // Frames skipped because the loop fell behind
+    uint32_t frameTimes[FRAME_BUCKETS];
+
+    void clear();
+
+    void addFrame(double workSeconds, unsigned dropped);
+
+    // Adds another result's frame counts to this one's, e.g. to total
+    // several attempts at a stage
+    void addFrames(const StageResult& other);
+
+    // Upper limit of the bucket that fraction of the frames fall within, in
+    // milliseconds, e.g. frameTimeLimitMs(0.95) = 4 if 95% took under 4 ms.
+    // 0 if there are no frames; the last bucket reports its lower limit.
+    int frameTimeLimitMs(double fraction) const;
+};
+
+static_assert(sizeof(StageResult) == 80, "StageResult is shared between processes; keep its layout fixed");
+
+// The launcher's end: one shared block, reused for every stage it starts.
+// Its name is exported as YEAR1_RESULT_SHM so that the stages, started
+// through system() and make, can find it.
+class StageResultChannel {
+private:
+    StageResult* block;
+    std::string name;
+
+public:
+    StageResultChannel();
+    ~StageResultChannel();
+    StageResultChannel(const StageResultChannel&) = delete;
+    StageResultChannel& operator=(const StageResultChannel&) = delete;
+
+    // Creates the block. False if there is no shared memory; stages then
+    // report to themselves and the launcher only sees exit codes.
+    bool open();
+    bool isOpen() const { return block != nullptr; }
+
+    // Empties the block before the next stage starts
+    void clear();
+
+    // Once the stage has exited: a copy of what it wrote, with state EMPTY
+    // if it never attached
+    StageResult read() const;
+};
+
+// The block this process reports into: the launcher's shared block when it
+// started this process, the channel's own block when the launcher and the
+// stage run in the same process, otherwise one private to the process.
+StageResult& stageResult();
+
+// Call once when the game ends
+void reportStageOutcome(bool won, int roundsReached, int hp, int score);
+
+#endif // STAGE_RESULT_H
@@ -0,0 +1,60 @@
+#include "startup_timer.h"
+#include <ncursesw/ncurses.h>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const char* const MARK_NAMES[STARTUP_MARKS] = {
+    "process start", "screen ready", "dialogue loaded", "first frame", "first input"
+};
+
+// Constant-initialised, so they are valid before any constructor runs
+Clock::time_point stamps[STARTUP_MARKS];
+bool reached[STARTUP_MARKS];
+
+// Ahead of the default-priority static constructors of every translation unit
+__attribute__((constructor(101))) void markProcessStart() {
+    markStartup(STARTUP_PROCESS);
+}
+
+void reportAndExit(double budgetMs) {
+    // Leave curses so the report lands on a normal terminal
+    if (stdscr != nullptr && !isendwin()) endwin();
+
+    std::fprintf(stderr, "%s startup, ms after process start:\n", program_invocation_short_name);
+    for (int mark = STARTUP_SCREEN; mark < STARTUP_MARKS; mark++) {
+        if (reached[mark]) {
+            std::fprintf(stderr, "  %-16s %8.2f\n", MARK_NAMES[mark], startupMs(static_cast<StartupMark>(mark)));
+        } else {
+            std::fprintf(stderr, "  %-16s %8s\n", MARK_NAMES[mark], "-");
+        }
+    }
+    double total = startupMs(STARTUP_INPUT);
+    bool withinBudget = total <= budgetMs;
+    std::fprintf(stderr, "  first input after %.2f ms, budget %.0f ms: %s\n", total, budgetMs,
+                 withinBudget ? "ok" : "OVER BUDGET");
+    std::exit(withinBudget ? 0 : 1);
+}
+
+} // namespace
+
+void markStartup(StartupMark mark) {
+    if (reached[mark]) return;
+    stamps[mark] = Clock::now();
+    reached[mark] = true;
+
+    if (mark == STARTUP_INPUT) {
+        const char* budget = std::getenv("YEAR1_STARTUP_BUDGET");
+        if (budget != nullptr && budget[0] != '\0') reportAndExit(std::atof(budget));
+    }
+}
+
+double startupMs(StartupMark mark) {
+    if (!reached[mark]) return -1;
+    return std::chrono::duration<double, std::milli>(stamps[mark] - stamps[STARTUP_PROCESS]).count();
+}
@@ -0,0 +1,26 @@
+#ifndef STARTUP_TIMER_H
+#define STARTUP_TIMER_H
+
+// Cold-start milestones of a process, each stamped (steady clock) the first
+// time it is reached. The engine stamps them itself: initScreen(), the
+// first dialogue file read, framePresented() and the first key read through
+// the text animator, waitForEnter() or enterPressed().
+enum StartupMark {
+    STARTUP_PROCESS,   // Static initialisation, before main()
+    STARTUP_SCREEN,    // ncurses initialised
+    STARTUP_DIALOGUE,  // First dialogue file loaded
+    STARTUP_FRAME,     // First frame presented
+    STARTUP_INPUT,     // First time the program reads a key
+    STARTUP_MARKS
+};
+
+// Stamps mark unless it was already reached. With YEAR1_STARTUP_BUDGET set
+// (in milliseconds), reaching STARTUP_INPUT ends the program instead: it
+// prints the breakdown to stderr and exits with status 1 if the first input
+// came later than the budget, 0 otherwise.
+void markStartup(StartupMark mark);
+
+// Milliseconds from process start to mark, -1 if not reached yet
+double startupMs(StartupMark mark);
+
+#endif // STARTUP_TIMER_H
@@ -0,0 +1,332 @@
+#include "terminal_graphics.h"
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+GraphicsMode graphicsMode() {
+    static GraphicsMode mode = [] {
+        const char* name = std::getenv("YEAR1_GRAPHICS");
+        if (!name) return GRAPHICS_OFF;
+        if (std::strcmp(name, "halfblock") == 0) return GRAPHICS_HALF_BLOCK;
+        // Images are written straight to the terminal
+        if (!isatty(STDOUT_FILENO)) return GRAPHICS_OFF;
+        if (std::strcmp(name, "sixel") == 0) return GRAPHICS_SIXEL;
+        if (std::strcmp(name, "kitty") == 0) return GRAPHICS_KITTY;
+        return GRAPHICS_OFF;
+    }();
+    return mode;
+}
+
+void terminalCellSize(int& width, int& height) {
+    width = 8;
+    height = 16;
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 &&
+        size.ws_col > 0 && size.ws_row > 0 && size.ws_xpixel > 0 && size.ws_ypixel > 0) {
+        width = size.ws_xpixel / size.ws_col;
+        height = size.ws_ypixel / size.ws_row;
+    }
+}
+
+// xterm's default colours
+Pixel colourPixel(short colour) {
+    static const Pixel standard[8] = {
+        rgba(0, 0, 0), rgba(205, 0, 0), rgba(0, 205, 0), rgba(205, 205, 0),
+        rgba(0, 0, 238), rgba(205, 0, 205), rgba(0, 205, 205), rgba(229, 229, 229)
+    };
+    return colour >= 0 && colour < 8 ? standard[colour] : standard[7];
+}
+
+Pixel pairPixel(chtype attr) {
+    short foreground = COLOR_WHITE, background;
+    pair_content(PAIR_NUMBER(attr), &foreground, &background);
+    return colourPixel(foreground);
+}
+
+PixelCanvas* newBoxCanvas(GraphicsMode mode, int cols, int rows) {
+    int cellWidth = 1, cellHeight = 2;
+    if (mode != GRAPHICS_HALF_BLOCK) terminalCellSize(cellWidth, cellHeight);
+    return new PixelCanvas(cols, rows, cellWidth, cellHeight);
+}
+
+// One pair for every two different colours, numbered from just above the
+// stages' own seven: 8 + 56 fits the 64 pairs of an 8-colour terminal.
+// A cell of one colour is a blank with that colour behind it.
+static const short HALF_BLOCK_PAIRS = 8;
+
+static short halfBlockPair(short fg, short bg) {
+    return HALF_BLOCK_PAIRS + fg * 7 + (bg < fg ? bg : bg - 1);
+}
+
+static short nearestColour(Pixel pixel) {
+    int r = pixel & 0xFF, g = pixel >> 8 & 0xFF, b = pixel >> 16 & 0xFF;
+    short best = 0;
+    int bestDistance = 3 * 256 * 256;
+    for (short colour = 0; colour < 8; colour++) {
+        Pixel standard = colourPixel(colour);
+        int dr = r - static_cast<int>(standard & 0xFF);
+        int dg = g - static_cast<int>(standard >> 8 & 0xFF);
+        int db = b - static_cast<int>(standard >> 16 & 0xFF);
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = colour;
+        }
+    }
+    return best;
+}
+
+void drawHalfBlocks(const PixelCanvas& canvas, int col, int row) {
+    // Pairs belong to the screen, and the session server has one per player,
+    // so look rather than remember whether they are set up
+    short lastPair = halfBlockPair(7, 6);
+    if (COLOR_PAIRS <= lastPair) return;
+    short lastFg, lastBg;
+    if (pair_content(lastPair, &lastFg, &lastBg) == ERR || lastFg != 7 || lastBg != 6) {
+        for (short fg = 0; fg < 8; fg++) {
+            for (short bg = 0; bg < 8; bg++) {
+                if (fg != bg) init_pair(halfBlockPair(fg, bg), fg, bg);
+            }
+        }
+    }
+
+    cchar_t cell;
+    const wchar_t upperHalf[] = { 0x2580, 0 };
+    const wchar_t blank[] = { L' ', 0 };
+    for (int y = 0; y < canvas.getRows(); y++) {
+        const Pixel* top = canvas.row(2 * y);
+        const Pixel* bottom = canvas.row(2 * y + 1);
+        for (int x = 0; x < canvas.getCols(); x++) {
+            short fg = nearestColour(top[x]);
+            short bg = nearestColour(bottom[x]);
+            if (fg != bg) {
+                setcchar(&cell, upperHalf, A_NORMAL, halfBlockPair(fg, bg), nullptr);
+            } else if (bg == COLOR_BLACK) {
+                setcchar(&cell, blank, A_NORMAL, 0, nullptr);
+            } else {
+                setcchar(&cell, blank, A_NORMAL, halfBlockPair(COLOR_BLACK, bg), nullptr);
+            }
+            mvadd_wch(row + y, col + x, &cell);
+        }
+    }
+}
+
+// Sixel: six pixel rows at a time, one pass per colour, each column a
+// character whose low six bits say which of the six pixels have that colour.
+// Colours are rounded to a 6x6x6 cube and only the ones in the tile defined.
+static const int CUBE_SIZE = 216;
+
+static int cubeIndex(Pixel pixel) {
+    int r = ((pixel & 0xFF) * 5 + 127) / 255;
+    int g = ((pixel >> 8 & 0xFF) * 5 + 127) / 255;
+    int b = ((pixel >> 16 & 0xFF) * 5 + 127) / 255;
+    return (r * 6 + g) * 6 + b;
+}
+
+static void appendRun(std::string& out, char sixel, int count) {
+    if (count > 3) {
+        out += '!';
+        out += std::to_string(count);
+        out += sixel;
+    } else {
+        out.append(count, sixel);
+    }
+}
+
+void encodeSixelTile(const PixelCanvas& canvas, int tile, std::string& out) {
+    int x, y, w, h;
+    canvas.tileBounds(tile, x, y, w, h);
+
+    static std::vector<unsigned char> indices;
+    indices.resize(static_cast<size_t>(w) * h);
+    bool used[CUBE_SIZE] = {};
+    for (int row = 0; row < h; row++) {
+        const Pixel* source = canvas.row(y + row) + x;
+        unsigned char* target = &indices[static_cast<size_t>(row) * w];
+        for (int col = 0; col < w; col++) {
+            target[col] = static_cast<unsigned char>(cubeIndex(source[col]));
+            used[target[col]] = true;
+        }
+    }
+
+    char header[64];
+    std::snprintf(header, sizeof(header), "\033P0;0;8q\"1;1;%d;%d", w, h);
+    out += header;
+    for (int colour = 0; colour < CUBE_SIZE; colour++) {
+        if (!used[colour]) continue;
+        char define[32];
+        std::snprintf(define, sizeof(define), "#%d;2;%d;%d;%d", colour,
+                      colour / 36 * 20, colour / 6 % 6 * 20, colour % 6 * 20);
+        out += define;
+    }
+
+    for (int band = 0; band < h; band += 6) {
+        int bandRows = h - band < 6 ? h - band : 6;
+        bool inBand[CUBE_SIZE] = {};
+        for (int i = band * w; i < (band + bandRows) * w; i++) inBand[indices[i]] = true;
+
+        // One pass over the band sets every colour's bits for each column
+        static std::vector<unsigned char> bits;
+        bits.assign(static_cast<size_t>(CUBE_SIZE) * w, 0);
+        for (int r = 0; r < bandRows; r++) {
+            const unsigned char* source = &indices[static_cast<size_t>(band + r) * w];
+            for (int col = 0; col < w; col++) bits[source[col] * w + col] |= 1 << r;
+        }
+
+        bool first = true;
+        for (int colour = 0; colour < CUBE_SIZE; colour++) {
+            if (!inBand[colour]) continue;
+            if (!first) out += '$';  // Back to the start of the band
+            first = false;
+            out += '#';
+            out += std::to_string(colour);
+
+            const unsigned char* columns = &bits[colour * w];
+            char run = 0;
+            int count = 0, blanks = 0;
+            for (int col = 0; col < w; col++) {
+                char sixel = static_cast<char>('?' + columns[col]);
+                if (sixel == run) {
+                    count++;
+                    continue;
+                }
+                // Blank runs are only written once something follows them
+                if (run == '?') {
+                    blanks = count;
+                } else if (count > 0) {
+                    if (blanks > 0) appendRun(out, '?', blanks);
+                    blanks = 0;
+                    appendRun(out, run, count);
+                }
+                run = sixel;
+                count = 1;
+            }
+            if (run != '?') {
+                if (blanks > 0) appendRun(out, '?', blanks);
+                appendRun(out, run, count);
+            }
+        }
+        out += '-';  // Next band
+    }
+    out += "\033\\";
+}
+
+// Kitty: the tile's RGB bytes in base64 (alpha is always opaque), sent in chunks of at most 4096.
+// Each tile is its own image id with one placement, so sending it again
+// replaces the old picture in place.
+void encodeKittyTile(const PixelCanvas& canvas, int tile, std::string& out) {
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int x, y, w, h;
+    canvas.tileBounds(tile, x, y, w, h);
+
+    static std::string encoded;
+    encoded.clear();
+    static std::vector<unsigned char> bytes;
+    bytes.resize(static_cast<size_t>(w) * h * 3);
+    unsigned char* target = bytes.data();
+    for (int row = 0; row < h; row++) {
+        const Pixel* source = canvas.row(y + row) + x;
+        for (int col = 0; col < w; col++) {
+            *target++ = source[col] & 0xFF;
+            *target++ = source[col] >> 8 & 0xFF;
+            *target++ = source[col] >> 16 & 0xFF;
+        }
+    }
+    // Three bytes a pixel, so the groups come out even with no padding
+    for (size_t i = 0; i + 2 < bytes.size(); i += 3) {
+        uint32_t group = bytes[i] << 16 | bytes[i + 1] << 8 | bytes[i + 2];
+        encoded += digits[group >> 18 & 63];
+        encoded += digits[group >> 12 & 63];
+        encoded += digits[group >> 6 & 63];
+        encoded += digits[group & 63];
+    }
+    const size_t CHUNK = 4096;
+    for (size_t at = 0; at < encoded.size(); at += CHUNK) {
+        bool more = at + CHUNK < encoded.size();
+        char control[96];
+        if (at == 0) {
+            std::snprintf(control, sizeof(control), "\033_Ga=T,f=24,s=%d,v=%d,i=%d,p=1,q=2,C=1,m=%d;",
+                          w, h, tile + 1, more);
+        } else {
+            std::snprintf(control, sizeof(control), "\033_Gm=%d;", more);
+        }
+        out += control;
+        out.append(encoded, at, CHUNK);
+        out += "\033\\";
+    }
+}
+
+static void writeAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(STDOUT_FILENO, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        written += n;
+    }
+}
+
+GraphicsPresenter::GraphicsPresenter(GraphicsMode graphics)
+    : mode(graphics), originCol(-1), originRow(-1), screenCols(0), screenRows(0) {}
+
+// Kitty images stay over the text until deleted
+static void deleteKittyImages() {
+    writeAll("\033_Ga=d,d=A,q=2\033\\");
+}
+
+GraphicsPresenter::~GraphicsPresenter() {
+    if (mode == GRAPHICS_KITTY && originCol >= 0) deleteKittyImages();
+}
+
+void GraphicsPresenter::present(PixelCanvas& canvas, int col, int row) {
+    // Half blocks are cells, drawn before the refresh
+    if (mode == GRAPHICS_OFF || mode == GRAPHICS_HALF_BLOCK) return;
+
+    // A move or resize repaints the screen, so everything is sent again
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    if (col != originCol || row != originRow || maxX != screenCols || maxY != screenRows) {
+        if (mode == GRAPHICS_KITTY && originCol >= 0) deleteKittyImages();
+        canvas.invalidate();
+        originCol = col;
+        originRow = row;
+        screenCols = maxX;
+        screenRows = maxY;
+    }
+
+    const std::vector<int>& dirty = canvas.endFrame();
+    if (dirty.empty()) return;
+
+    // The cursor is put back afterwards, where ncurses thinks it is
+    output.assign("\0337");
+    for (int tile : dirty) {
+        int x, y, w, h;
+        canvas.tileBounds(tile, x, y, w, h);
+        char move[32];
+        std::snprintf(move, sizeof(move), "\033[%d;%dH",
+                      row + y / canvas.getCellHeight() + 1, col + x / canvas.getCellWidth() + 1);
+        output += move;
+        if (mode == GRAPHICS_SIXEL) {
+            encodeSixelTile(canvas, tile, output);
+        } else {
+            encodeKittyTile(canvas, tile, output);
+        }
+    }
+    output += "\0338";
+    writeAll(output);
+}
+
+void GraphicsPresenter::hide() {
+    if (mode == GRAPHICS_OFF || mode == GRAPHICS_HALF_BLOCK || originCol < 0) return;
+    if (mode == GRAPHICS_KITTY) {
+        deleteKittyImages();
+    } else {
+        // Sixel pixels are cell contents: repaint every cell on the next refresh
+        redrawwin(stdscr);
+    }
+    // The next present() sends the whole canvas again
+    originCol = originRow = -1;
+}
@@ -0,0 +1,63 @@
+#ifndef TERMINAL_GRAPHICS_H
+#define TERMINAL_GRAPHICS_H
+
+#include "pixel_canvas.h"
+#include <ncursesw/ncurses.h>
+#include <string>
+
+// Optional pixel output for the battle box, chosen with YEAR1_GRAPHICS:
+//   halfblock  two pixels per cell, drawn as upper half blocks with the top
+//              pixel's colour in front and the bottom one's behind. Plain
+//              cells, so it goes through the recorder and session server.
+//   sixel      images for terminals that show them, laid over the cells
+//   kitty      the same with the kitty graphics protocol (also WezTerm and
+//              Ghostty)
+// Off by default: every stage draws its glyphs as before.
+enum GraphicsMode { GRAPHICS_OFF, GRAPHICS_HALF_BLOCK, GRAPHICS_SIXEL, GRAPHICS_KITTY };
+
+GraphicsMode graphicsMode();
+
+// Pixel size of one terminal cell, asked of the tty; 8x16 when it does not say
+void terminalCellSize(int& width, int& height);
+
+// Screen colour of one of the eight standard ncurses colours, and the
+// foreground colour of the pair in an attribute (a Palette<T>::attr)
+Pixel colourPixel(short colour);
+Pixel pairPixel(chtype attr);
+
+// Canvas for the inside of a box of the given size, cellWidth x cellHeight
+// pixels per cell for the mode (1x2 for half blocks)
+PixelCanvas* newBoxCanvas(GraphicsMode mode, int cols, int rows);
+
+// Half-block mode: writes the canvas into stdscr (before presentFrame())
+// with its top-left at the given cell, two pixels to a cell, each rounded to the nearest of the eight
+// standard colours. Cells whose two pixels are both black become blanks, so
+// an empty box costs no more than it did with glyphs.
+void drawHalfBlocks(const PixelCanvas& canvas, int col, int row);
+
+// Escape sequences drawing one canvas tile at the cursor
+void encodeSixelTile(const PixelCanvas& canvas, int tile, std::string& out);
+void encodeKittyTile(const PixelCanvas& canvas, int tile, std::string& out);
+
+// Sends a canvas to a sixel or kitty terminal after each presentFrame(),
+// the changed tiles only; does nothing in the other modes. Images are placed by cell, so the canvas's origin is given as
+// the screen cell of its top-left corner.
+class GraphicsPresenter {
+private:
+    GraphicsMode mode;
+    int originCol, originRow;
+    int screenCols, screenRows;
+    std::string output;     // Kept between frames for its capacity
+
+public:
+    explicit GraphicsPresenter(GraphicsMode graphics);
+    ~GraphicsPresenter();
+
+    void present(PixelCanvas& canvas, int col, int row);
+
+    // Takes the image off the screen, e.g. before text is shown where it
+    // was; the next present() sends it whole again
+    void hide();
+};
+
+#endif // TERMINAL_GRAPHICS_H
@@ -0,0 +1,330 @@
+#include "text_animator.h"
+#include "present.h"
+#include "input.h"
+#include "screen.h"
+#include "startup_timer.h"
+#include "frame_timer.h"
+#include <algorithm>
+#include <cctype>
+#include <vector>
+#include <iostream>
+#include <map>
+
+// Typing speed: textDelay is the time for one average word and its space
+static const int CHARS_PER_WORD = 6;
+
+// Frames a second of the box's own loop in animateText()
+static const int DIALOGUE_FPS = 30;
+
+static std::map<std::string, std::shared_ptr<const DialogueBundle>> dialogueCache;
+
+// Maps the bundle compiled from a dialogue file, compiling it first if it is
+// missing or older than the text
+static std::shared_ptr<const DialogueBundle> loadDialogueBundle(const std::string& filename) {
+    std::string binary = filename;
+    size_t extension = binary.rfind(".txt");
+    if (extension != std::string::npos && extension + 4 == binary.size()) binary.erase(extension);
+    binary += ".bin";
+
+    std::shared_ptr<DialogueBundle> bundle = std::make_shared<DialogueBundle>();
+    if (!bundle->load(binary, filename)) {
+        std::cerr << "Error: Could not load dialogue file: " << bundle->error() << std::endl;
+        return nullptr;
+    }
+    return bundle;
+}
+
+std::shared_ptr<const DialogueBundle> dialogueSnapshot(const std::string& filename) {
+    auto cached = dialogueCache.find(filename);
+    if (cached != dialogueCache.end()) return cached->second;
+
+    std::shared_ptr<const DialogueBundle> lines = loadDialogueBundle(filename);
+    if (!lines) return std::make_shared<DialogueBundle>();
+    markStartup(STARTUP_DIALOGUE);
+    dialogueCache[filename] = lines;
+    return lines;
+}
+
+bool reloadDialogueSnapshot(const std::string& filename) {
+    std::shared_ptr<const DialogueBundle> lines = loadDialogueBundle(filename);
+    if (!lines) return false;
+    dialogueCache[filename] = lines;
+    return true;
+}
+
+TextAnimator::TextAnimator(int width, const std::string& name, int delay, bool skip) 
+    : maxWidth(width), speakerName(name), textDelay(delay), canSkip(skip),
+      state(IDLE), totalChars(0), revealed(0), selected(0),
+      boxShown(false), shownY(0), shownX(0), shownFirst(0), shownChars(0), promptShown(false),
+      shownSelected(0) {}
+
+void TextAnimator::loadDialogues(const std::string& filename) {
+    dialogueFile = filename;
+    dialogues.reset();
+}
+
+const DialogueBundle& TextAnimator::lines() {
+    if (!dialogues) {
+        dialogues = dialogueFile.empty() ? std::make_shared<DialogueBundle>() : dialogueSnapshot(dialogueFile);
+    }
+    return *dialogues;
+}
+
+void TextAnimator::start(const std::string& text) {
+    std::vector<TextSpan> words;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        size_t wordStart = pos;
+        while (pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        if (pos > wordStart) words.push_back(TextSpan{ text.data() + wordStart, pos - wordStart });
+    }
+    begin(std::make_shared<WrappedLines>(wrapWords(words, maxWidth)));
+}
+
+void TextAnimator::start(const DialogueBundle& bundle, size_t index) {
+    begin(bundle.wrapped(index, maxWidth));
+}
+
+void TextAnimator::startChoice(const std::vector<std::string>& choices) {
+    options = choices;
+    selected = 0;
+    state = CHOOSING;
+    invalidate();
+}
+
+void TextAnimator::begin(const std::shared_ptr<const WrappedLines>& layout) {
+    wrapped = layout;
+    totalChars = 0;
+    for (const std::string& line : *wrapped) totalChars += line.length();
+    revealed = 0;
+    started = std::chrono::steady_clock::now();
+    state = TYPING;
+    invalidate();
+}
+
+void TextAnimator::handleKey(int ch) {
+    if (state == TYPING && canSkip &&
+        (ch == KEY_UP || ch == KEY_DOWN || ch == KEY_LEFT || ch == KEY_RIGHT)) {
+        // Show all remaining text at once
+        revealed = totalChars;
+        state = WAITING;
+    } else if (state == CHOOSING && !options.empty()) {
+        if (ch == KEY_UP) {
+            selected = (selected + options.size() - 1) % options.size();
+        } else if (ch == KEY_DOWN) {
+            selected = (selected + 1) % options.size();
+        } else if (isEnterKey(ch)) {
+            state = IDLE;
+        }
+    } else if (state == WAITING && isEnterKey(ch)) {
+        // Keys pressed while typing were already used up, as the old
+        // flushinp() before waiting did
+        state = IDLE;
+    }
+}
+
+bool TextAnimator::update() {
+    if (state == TYPING) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        revealed = std::min(totalChars, static_cast<size_t>(ms * CHARS_PER_WORD / std::max(textDelay, 1)));
+        if (revealed == totalChars) state = WAITING;
+    }
+    return state != IDLE;
+}
+
+void TextAnimator::draw() {
+    if (state == IDLE) return;
+
+    // Get screen dimensions
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    
+    // Position dialogue at bottom of screen
+    int startY = maxY - 7; // 7 lines from bottom
+    int startX = (maxX - maxWidth) / 2;
+    if (startY != shownY || startX != shownX) boxShown = false;
+
+    if (!boxShown) {
+        // Draw speaker name box
+        attron(COLOR_PAIR(3)); // Cyan for name
+        mvprintw(startY - 1, startX, "%s:", speakerName.c_str());
+        attroff(COLOR_PAIR(3));
+
+        // Draw dialogue box
+        attron(COLOR_PAIR(4)); // Blue for box
+        for (int i = 0; i < 5; i++) {
+            mvhline(startY + i, startX - 2, ACS_HLINE, maxWidth + 4);
+        }
+        mvvline(startY, startX - 2, ACS_VLINE, 5);
+        mvvline(startY, startX + maxWidth + 1, ACS_VLINE, 5);
+        mvaddch(startY, startX - 2, ACS_ULCORNER);
+        mvaddch(startY, startX + maxWidth + 1, ACS_URCORNER);
+        mvaddch(startY + 4, startX - 2, ACS_LLCORNER);
+        mvaddch(startY + 4, startX + maxWidth + 1, ACS_LRCORNER);
+        attroff(COLOR_PAIR(4));
+
+        // Add skip instruction
+        if (canSkip && state != CHOOSING) {
+            mvprintw(startY - 2, startX + maxWidth - 25, "Press any arrow key to skip");
+        }
+
+        boxShown = true;
+        shownY = startY;
+        shownX = startX;
+        shownFirst = 0;
+        shownChars = 0;
+        promptShown = false;
+        shownSelected = options.size();
+    }
+
+    if (state == CHOOSING) {
+        drawChoices(startY, startX);
+        return;
+    }
+
+    // The text so far; once it needs more than the box's four lines, the
+    // last four lines that have started showing
+    const WrappedLines& lines = *wrapped;
+    int current = 0;
+    size_t lineStart = 0;  // Characters on the lines before current
+    while (current + 1 < static_cast<int>(lines.size()) &&
+           lineStart + lines[current].length() < revealed) {
+        lineStart += lines[current].length();
+        current++;
+    }
+    int first = std::max(0, current - 3);
+    for (int line = current; line > first; line--) lineStart -= lines[line - 1].length();
+
+    if (first != shownFirst) {
+        // Scrolled: the rows hold other lines now, so fill them again and
+        // write out what is revealed of their lines
+        attron(COLOR_PAIR(4));
+        for (int row = 0; row < 4; row++) mvhline(startY + row, startX, ACS_HLINE, maxWidth);
+        attroff(COLOR_PAIR(4));
+        shownFirst = first;
+        shownChars = lineStart;
+    }
+
+    // Only the characters revealed since the last draw; after a skip that
+    // is the rest of every row at once
+    for (int line = first; line <= current && shownChars < revealed; line++) {
+        size_t length = lines[line].length();
+        size_t from = shownChars > lineStart ? shownChars - lineStart : 0;
+        size_t to = std::min(length, revealed - lineStart);
+        if (to > from) {
+            mvaddnstr(startY + line - first, startX + static_cast<int>(from), lines[line].c_str() + from,
+                      static_cast<int>(to - from));
+        }
+        lineStart += length;
+    }
+    shownChars = revealed;
+
+    if (state == WAITING && !promptShown) {
+        attron(COLOR_PAIR(3)); // Cyan for prompt
+        mvprintw(startY + 5, startX + maxWidth / 2 - 10, "Press Enter to continue...");
+        attroff(COLOR_PAIR(3));
+        promptShown = true;
+    }
+}
+
+void TextAnimator::drawChoices(int startY, int startX) {
+    if (shownSelected == selected) return;
+
+    // One option per row, the highlighted one in reverse video
+    for (size_t option = 0; option < options.size() && option < 4; option++) {
+        int row = startY + static_cast<int>(option);
+        attron(COLOR_PAIR(4));
+        mvhline(row, startX, ACS_HLINE, maxWidth);
+        attroff(COLOR_PAIR(4));
+        std::string label = (option == selected ? "> " : "  ") + options[option];
+        if (option == selected) attron(A_REVERSE);
+        mvaddnstr(row, startX, label.c_str(), maxWidth);
+        if (option == selected) attroff(A_REVERSE);
+    }
+    shownSelected = selected;
+
+    if (!promptShown) {
+        attron(COLOR_PAIR(3)); // Cyan for prompt
+        mvprintw(startY + 5, startX + maxWidth / 2 - 10, "Up/Down, then Enter to choose");
+        attroff(COLOR_PAIR(3));
+        promptShown = true;
+    }
+}
+
+void TextAnimator::clearBox() {
+    int maxY, maxX;
+    getmaxyx(stdscr, maxY, maxX);
+    int startY = maxY - 7;
+    int startX = (maxX - maxWidth) / 2;
+    for (int y = startY - 2; y <= startY + 5; y++) {
+        mvhline(y, startX - 2, ' ', maxWidth + 4);
+    }
+    invalidate();
+}
+
+void TextAnimator::animateText(const std::string& text) {
+    start(text);
+    runBox();
+}
+
+void TextAnimator::runBox() {
+    // Nothing else to show, so the loop only has the box to draw
+    InputMode input(InputMode::NON_BLOCKING);
+    // Paced but not reported: time spent reading is not game frames
+    FrameTimer frameTimer(DIALOGUE_FPS, false);
+    while (update()) {
+        draw();
+        presentFrame();
+
+        markStartup(STARTUP_INPUT);
+        int ch;
+        while ((ch = getch()) != ERR) handleKey(ch);
+        frameTimer.wait();
+    }
+    
+    // Clear the dialogue area
+    clearBox();
+    presentFrame();
+}
+
+void TextAnimator::showDialogue(int index) {
+    const DialogueBundle& all = lines();
+    if (index >= 0 && index < static_cast<int>(all.size())) {
+        start(all, index);
+        runBox();
+    }
+}
+
+std::string TextAnimator::getDialogue(int index) {
+    const DialogueBundle& all = lines();
+    if (index >= 0 && index < static_cast<int>(all.size())) {
+        return all.line(index).str();
+    }
+    return "";
+}
+
+size_t TextAnimator::getDialogueCount() {
+    return lines().size();
+}
+
+void TextAnimator::runScript(const std::string& label, const ScriptVariables& variables) {
+    lines();
+    ScriptCursor cursor;
+    if (!cursor.start(dialogues, label)) return;
+
+    std::vector<size_t> shown;
+    for (;;) {
+        ScriptCursor::Event event = cursor.next(variables, shown);
+        if (event == ScriptCursor::END) break;
+        if (event == ScriptCursor::SAY) {
+            start(*dialogues, shown[0]);
+        } else {
+            std::vector<std::string> choices;
+            for (size_t line : shown) choices.push_back(dialogues->line(line).str());
+            startChoice(choices);
+        }
+        runBox();
+        if (event == ScriptCursor::CHOOSE) cursor.choose(selected);
+    }
+}
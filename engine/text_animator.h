@@ -0,0 +1,111 @@
+#ifndef TEXT_ANIMATOR_H
+#define TEXT_ANIMATOR_H
+
+#include <ncursesw/ncurses.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include "dialogue_bundle.h"
+
+// Current snapshot of a dialogue file (e.g. "1340_dialogue.txt"): its
+// bundle ("1340_dialogue.bin"), mapped on first use and then shared. A
+// missing file gives an empty snapshot (and is retried next time).
+std::shared_ptr<const DialogueBundle> dialogueSnapshot(const std::string& filename);
+
+// Recompiles and maps a dialogue file again and swaps in the new snapshot.
+// Holders of the old snapshot keep it until they ask again. Returns false
+// (keeping the old one) if the file cannot be read.
+bool reloadDialogueSnapshot(const std::string& filename);
+
+// Dialogue box shared by every stage: types text out at the bottom of the
+// screen and waits for Enter. Each stage's own intro and round messages
+// live in its dialogue.cpp.
+//
+// The box is a state machine driven by a frame loop: start() a text, then
+// every frame pass the keys read to handleKey(), call update() and, while
+// it returns true, draw() over whatever else the frame shows. Characters
+// appear by elapsed time, so the loop can keep a live background or other
+// work going while the text types out. animateText() and showDialogue()
+// run that loop themselves over a still screen, and runScript() plays a
+// branching script from the dialogue file, choices included.
+//
+// draw() is retained like the HUD widgets: the name, box and hint are drawn
+// once per text and each frame only writes the characters revealed since
+// the last one; the rows are only filled again when the text scrolls. Call
+// invalidate() after anything cleared the screen under the box.
+class TextAnimator {
+private:
+    enum State {
+        IDLE,     // Nothing to show
+        TYPING,   // Revealing the text
+        WAITING,  // All shown, waiting for Enter
+        CHOOSING, // Options in the box, Up/Down to pick, Enter to confirm
+    };
+
+    int maxWidth;              // Maximum width of text box
+    std::string speakerName;   // Name of the speaker
+    int textDelay;             // Milliseconds per word's worth of characters
+    bool canSkip;              // Whether text can be skipped
+    std::string dialogueFile;  // Read on first use, not by loadDialogues()
+    std::shared_ptr<const DialogueBundle> dialogues; // Loaded dialogues, null until then
+
+    State state;
+    std::shared_ptr<const WrappedLines> wrapped;  // The text broken into box lines
+    size_t totalChars;
+    size_t revealed;                   // Characters revealed so far
+    std::chrono::steady_clock::time_point started;
+    std::vector<std::string> options;  // CHOOSING
+    size_t selected;
+
+    // What draw() has put on the screen
+    bool boxShown;                     // Name, box and hint
+    int shownY, shownX;                // Where the box was drawn
+    int shownFirst;                    // Wrapped line in the top text row
+    size_t shownChars;                 // Characters written
+    bool promptShown;
+    size_t shownSelected;              // Option highlighted on screen
+
+    const DialogueBundle& lines();
+    void begin(const std::shared_ptr<const WrappedLines>& layout);
+    void runBox();  // The loop of animateText() over a started text
+    void drawChoices(int startY, int startX);
+    
+public:
+    TextAnimator(int width, const std::string& name, int delay = 100, bool skip = true);
+    
+    // Animate a single text in the dialogue box; returns once Enter was
+    // pressed and the box is cleared again
+    void animateText(const std::string& text);
+
+    // Frame loop interface
+    void start(const std::string& text);
+    void start(const DialogueBundle& bundle, size_t index);  // Uses the bundle's cached layout
+    void startChoice(const std::vector<std::string>& choices);  // Up to 4 options
+    size_t chosen() const { return selected; }               // Once a choice has closed
+    void handleKey(int ch);  // Arrow keys skip the typing, Enter closes the box
+    bool update();           // False once closed
+    void draw();             // Name, box, text so far and prompt
+    void clearBox();         // Blanks the area draw() uses
+    void invalidate() { boxShown = false; }  // Next draw() draws everything
+    bool isActive() const { return state != IDLE; }
+    
+    // Load dialogues from a file: its current snapshot when the first
+    // dialogue is asked for
+    void loadDialogues(const std::string& filename);
+    
+    // Show dialogue at the specified index
+    void showDialogue(int index);
+    
+    // Get dialogue text at the specified index
+    std::string getDialogue(int index);
+    
+    // Get the total number of loaded dialogues
+    size_t getDialogueCount();
+
+    // Play the script node label of the loaded dialogue file until it ends,
+    // with conditions tested against variables. A missing node shows nothing.
+    void runScript(const std::string& label, const ScriptVariables& variables);
+};
+
+#endif // TEXT_ANIMATOR_H
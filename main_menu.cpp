@@ -2,57 +2,125 @@
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <cstdlib>
-
-// Forward declarations for the games
-int run_engg1300_game(); // Breakout game
-int run_engg1310_game(); // SafeTiles game
-int run_engg1320_game(); // Coin Chase game
-int run_engg1330_game(); // Laser Battle game
-int run_engg1340_game(); // Final game
+#include <algorithm>
+#include <chrono>
+#include "present.h"
+#include "random.h"
+#include "screen.h"
+#include "particle_layer.h"
+#include "replay_preview.h"
+#include "session_budget.h"
+#include "stage_result.h"
+#include "startup_timer.h"
+
+// Forward declarations for the games. Each fills in what the stage reported
+// about the game, with state EMPTY if it reported nothing.
+int run_engg1300_game(StageResult& result); // Breakout game
+int run_engg1310_game(StageResult& result); // SafeTiles game
+int run_engg1320_game(StageResult& result); // Coin Chase game
+int run_engg1330_game(StageResult& result); // Laser Battle game
+int run_engg1340_game(StageResult& result); // Final game
+
+// The player's results on a level so far this session
+struct LevelProgress {
+    int attempts;
+    int clears;
+    int bestRound;
+    int bestScore;
+    StageResult timing;  // Frame counts of every attempt added together
+};
 
 // Structure to represent a level
 struct Level {
     std::string name;
-    int (*run_function)(); // Function pointer to run the game
+    int (*run_function)(StageResult& result); // Function pointer to run the game
+    LevelProgress progress;
 };
 
-// Structure to track a cloud's position
-struct Cloud {
-    int x;
-    int y;
-    char symbol;
-    int speed; // 1 = slow, 2 = medium, 3 = fast
-};
+// Shared with the stages for the whole menu session
+static StageResultChannel resultChannel;
+
+// The menus are drawn in two layers: boxes and text, and clouds drifting
+// behind them. Boxes and text go through putChar/putText, which mark their
+// cells in menuMask; the clouds only draw on cells left unmarked, so they
+// never read the screen back to find out what is there.
+static OccupancyMask menuMask;
+
+// Clouds move every tick of the menu loop, about 30 a second; the other
+// animations step every few ticks
+const int MENU_TICK_MS = 33;
+const int TICKS_PER_STEP = 5;
+const int CELLS_PER_CLOUD = 160;   // Cloud density, so big terminals get more
+const Fixed CLOUD_MIN_SPEED(0.2);  // Cells per tick
+const Fixed CLOUD_MAX_SPEED(0.66);
+
+// Attract mode: the highlighted level box plays a recording of its stage,
+// <stage>/preview.cast (cut from a YEAR1_RECORD session with
+// engine/preview_clip), every other tick. If the previews use more than
+// their share of a core they step less often; the recording still plays at
+// its own speed.
+const char* const PREVIEW_FILE = "/preview.cast";
+const int PREVIEW_TICKS = 2;
+const double PREVIEW_CPU_PERCENT = 1;
+const double PREVIEW_MAX_STEP = 0.25;  // Seconds; a longer gap is not caught up
+
+static void putChar(int y, int x, chtype ch) {
+    mvaddch(y, x, ch);
+    menuMask.mark(y, x);
+}
+
+static void putText(int y, int x, const std::string& text) {
+    mvaddstr(y, x, text.c_str());
+    menuMask.mark(y, x, text.size());
+}
+
+// Blanks static cells and hands them back to the clouds
+static void blankText(int y, int x, int width) {
+    if (width <= 0) return;
+    mvprintw(y, x, "%*s", width, "");
+    menuMask.unmark(y, x, width);
+}
+
+// Clears the screen and both layers
+static void clearMenu(ParticleLayer& clouds) {
+    int termHeight, termWidth;
+    getmaxyx(stdscr, termHeight, termWidth);
+    clear();
+    menuMask.resize(termHeight, termWidth);
+    clouds.populate(termHeight * termWidth / CELLS_PER_CLOUD, termHeight, termWidth,
+                    CLOUD_MIN_SPEED, CLOUD_MAX_SPEED);
+}
 
 // Helper function to draw a single menu item (highlighted or not)
 void drawMenuItem(int row, int col, const std::string& text, bool isHighlighted) {
     if (isHighlighted) {
         attron(A_REVERSE);
-        mvprintw(row, col, "%s", text.c_str());
+        putText(row, col, text);
         attroff(A_REVERSE);
     } else {
-        mvprintw(row, col, "%s", text.c_str());
+        putText(row, col, text);
     }
 }
 
 // Function to draw a simple box around text
 void drawTextBox(int y, int x, int height, int width) {
     // Basic ASCII box characters for better terminal compatibility
-    mvaddch(y, x, '+');
-    mvaddch(y, x + width - 1, '+');
-    mvaddch(y + height - 1, x, '+');
-    mvaddch(y + height - 1, x + width - 1, '+');
+    putChar(y, x, '+');
+    putChar(y, x + width - 1, '+');
+    putChar(y + height - 1, x, '+');
+    putChar(y + height - 1, x + width - 1, '+');
     
     for (int i = 1; i < width - 1; i++) {
-        mvaddch(y, x + i, '-');
-        mvaddch(y + height - 1, x + i, '-');
+        putChar(y, x + i, '-');
+        putChar(y + height - 1, x + i, '-');
     }
     
     for (int i = 1; i < height - 1; i++) {
-        mvaddch(y + i, x, '|');
-        mvaddch(y + i, x + width - 1, '|');
+        putChar(y + i, x, '|');
+        putChar(y + i, x + width - 1, '|');
     }
 }
 
@@ -64,57 +132,13 @@ void drawFancyTitle(int y, int x, const std::string& title) {
     drawTextBox(y, x, 3, width);
     
     // Add title
-    mvprintw(y + 1, x + 4, "%s", title.c_str());
-}
-
-// Function to initialize clouds
-std::vector<Cloud> initClouds(int maxY, int maxX, int count) {
-    std::vector<Cloud> clouds;
-    for (int i = 0; i < count; i++) {
-        Cloud cloud;
-        cloud.x = rand() % maxX; // Start at random x positions
-        cloud.y = 1 + (rand() % (maxY - 2)); // Random y position
-        cloud.symbol = '.';
-        cloud.speed = (rand() % 3) + 1; // Random speed 1-3
-        clouds.push_back(cloud);
-    }
-    return clouds;
+    putText(y + 1, x + 4, title);
 }
 
-// Function to update and draw clouds
-void updateAndDrawClouds(std::vector<Cloud>& clouds, int maxY, int maxX) {
-    // First clear old positions
-    for (size_t i = 0; i < clouds.size(); i++) {
-        // Only clear if there's a cloud at this position (don't clear other text)
-        chtype ch = mvinch(clouds[i].y, clouds[i].x);
-        if ((ch & A_CHARTEXT) == '.') {
-            mvaddch(clouds[i].y, clouds[i].x, ' ');
-        }
-    }
-    
-    // Update positions
-    for (size_t i = 0; i < clouds.size(); i++) {
-        // Move cloud to the right based on speed
-        clouds[i].x += clouds[i].speed;
-        
-        // If cloud moves off screen, wrap around to the left
-        if (clouds[i].x >= maxX) {
-            clouds[i].x = 0;
-            clouds[i].y = 1 + (rand() % (maxY - 2)); // New random y position
-        }
-        
-        // Draw at new position
-        // Check if position already has text
-        chtype ch = mvinch(clouds[i].y, clouds[i].x);
-        if ((ch & A_CHARTEXT) == ' ') {
-            // Only draw cloud if space is empty
-            mvaddch(clouds[i].y, clouds[i].x, clouds[i].symbol);
-        }
-    }
-}
-
-// Function to draw a centered box with a message
-void drawLevelBox(int y, int x, int height, int width, const std::string& title, bool isHighlighted) {
+// Function to draw a centered box with a message. A box showing a preview
+// keeps its interior empty for it and has the title in its top border.
+void drawLevelBox(int y, int x, int height, int width, const std::string& title, bool isHighlighted,
+                  bool hasPreview = false) {
     // Draw the box border with simple ASCII characters
     if (isHighlighted) {
         attron(A_BOLD);
@@ -122,23 +146,47 @@ void drawLevelBox(int y, int x, int height, int width, const std::string& title,
     
     drawTextBox(y, x, height, width);
     
-    // Fill the box interior
+    // Fill the box interior; clouds pass behind it
     for (int i = 1; i < height - 1; i++) {
-        for (int j = 1; j < width - 1; j++) {
-            mvaddch(y + i, x + j, ' ');
-        }
+        putText(y + i, x + 1, std::string(width - 2, ' '));
     }
     
     // Draw title
-    int titleY = y + height / 2;
+    int titleY = hasPreview ? y : y + height / 2;
     int titleX = x + (width - title.length()) / 2;
-    mvprintw(titleY, titleX, "%s", title.c_str());
+    putText(titleY, titleX, title);
     
     if (isHighlighted) {
         attroff(A_BOLD);
     }
 }
 
+// Adds a stage's report to the level's totals
+static void addResult(LevelProgress& progress, const StageResult& result) {
+    // Nothing reported: the stage did not start (or there is no channel)
+    if (result.state == StageResult::EMPTY) return;
+    progress.attempts++;
+    progress.timing.addFrames(result);
+    // Quit or crashed before the end: frames only
+    if (result.state != StageResult::FINISHED) return;
+    if (result.won) progress.clears++;
+    progress.bestRound = std::max(progress.bestRound, static_cast<int>(result.roundsReached));
+    progress.bestScore = std::max(progress.bestScore, static_cast<int>(result.score));
+}
+
+// One line about the player's attempts at a level, empty before the first
+static std::string progressSummary(const LevelProgress& progress) {
+    if (progress.attempts == 0) return "";
+    char line[128];
+    int length = std::snprintf(line, sizeof(line), "Cleared %d/%d | Best: round %d, %d pts | 95%% of frames < %d ms",
+                               progress.clears, progress.attempts, progress.bestRound, progress.bestScore,
+                               progress.timing.frameTimeLimitMs(0.95));
+    if (progress.timing.droppedFrames > 0 && length < static_cast<int>(sizeof(line))) {
+        std::snprintf(line + length, sizeof(line) - length, ", %u dropped", progress.timing.droppedFrames);
+    }
+    return line;
+}
+
 // Function to display the main menu and handle navigation
 int displayMainMenu(std::vector<std::string>& menuItems) {
     int highlight = 0;    // Which menu item is highlighted
@@ -154,28 +202,25 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
     int startY = (termHeight - menuHeight) / 2;
     int startX = termWidth / 2;
     
-    // A simple banner to display above the menu
-    std::vector<std::string> banner;
-    banner.push_back("The Year 1 Engineering");
-    banner.push_back("Experience");
+    // A simple banner to display above the menu, fixed at compile time
+    static const char* const banner[] = { "The Year 1 Engineering", "Experience" };
+    const int bannerLines = sizeof(banner) / sizeof(banner[0]);
 
-    // Initialize moving clouds
-    std::vector<Cloud> clouds = initClouds(termHeight, termWidth, 10);
-    
-    // 1) Draw the framework (box, banner, instructions)
-    clear();
+    // 1) Draw the framework (box, banner, instructions) over new clouds
+    ParticleLayer clouds('.');
+    clearMenu(clouds);
     
     // Draw outer box
     drawTextBox(0, 0, termHeight, termWidth);
     
     // Display banner
-    for (int i = 0; i < (int)banner.size(); i++) {
+    for (int i = 0; i < bannerLines; i++) {
         int bannerRow = startY - 5 + i * 2;
-        int bannerCol = startX - (int)banner[i].size() / 2;
+        int bannerCol = startX - (int)std::strlen(banner[i]) / 2;
         
         // Draw a fancy box around the title
         if (i == 0) {
-            int boxWidth = banner[i].size() + 6;
+            int boxWidth = std::strlen(banner[i]) + 6;
             int boxStart = bannerCol - 3;
             
             drawTextBox(bannerRow - 1, boxStart, 3, boxWidth);
@@ -183,15 +228,15 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
         
         // Draw the title text
         attron(A_BOLD);
-        mvprintw(bannerRow, bannerCol, "%s", banner[i].c_str());
+        putText(bannerRow, bannerCol, banner[i]);
         attroff(A_BOLD);
     }
 
     // Display instructions
     std::string instruction1 = "Use UP/DOWN Arrow Keys to Navigate";
     std::string instruction2 = "Press ENTER to Select";
-    mvprintw(termHeight - 3, (termWidth - instruction1.length()) / 2, "%s", instruction1.c_str());
-    mvprintw(termHeight - 2, (termWidth - instruction2.length()) / 2, "%s", instruction2.c_str());
+    putText(termHeight - 3, (termWidth - instruction1.length()) / 2, instruction1);
+    putText(termHeight - 2, (termWidth - instruction2.length()) / 2, instruction2);
 
     // 2) Draw all menu items in normal text with decorative elements
     for (int i = 0; i < (int)menuItems.size(); i++) {
@@ -201,30 +246,30 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
         // Draw decorative arrows around the selected item
         if (i == highlight) {
             attron(A_BOLD);
-            mvprintw(row, col - 3, ">>");
-            mvprintw(row, col + menuItems[i].size() + 1, "<<");
+            putText(row, col - 3, ">>");
+            putText(row, col + menuItems[i].size() + 1, "<<");
             attroff(A_BOLD);
         }
         
         drawMenuItem(row, col, menuItems[i], (i == highlight));
     }
     
-    refresh(); // Show everything
+    presentFrame(); // Show everything
 
     // 3) Main input loop: highlight changes or user presses Enter
-    int animationCounter = 0;
-    timeout(150); // Set timeout for getch to enable animation (slightly slower to reduce lag)
+    InputMode ticking(MENU_TICK_MS); // Timed getch to enable animation, blocking again on return
+    markStartup(STARTUP_INPUT);
     
     while (choice == -1) {
         input = getch();
         
         // Update and draw the moving clouds
-        updateAndDrawClouds(clouds, termHeight, termWidth);
+        clouds.update();
+        clouds.draw(menuMask);
         
         // If timeout occurred, just refresh and continue
         if (input == ERR) {
-            refresh();
-            animationCounter++;
+            presentFrame();
             continue;
         }
 
@@ -236,8 +281,8 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
                 drawMenuItem(oldRow, oldCol, menuItems[highlight], false);
                 
                 // Clear decorative arrows
-                mvprintw(oldRow, oldCol - 3, "  ");
-                mvprintw(oldRow, oldCol + menuItems[highlight].size() + 1, "  ");
+                blankText(oldRow, oldCol - 3, 2);
+                blankText(oldRow, oldCol + menuItems[highlight].size() + 1, 2);
 
                 // Move highlight up
                 highlight--;
@@ -250,11 +295,12 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
                 
                 // Draw new decorative arrows
                 attron(A_BOLD);
-                mvprintw(newRow, newCol - 3, ">>");
-                mvprintw(newRow, newCol + menuItems[highlight].size() + 1, "<<");
+                putText(newRow, newCol - 3, ">>");
+                putText(newRow, newCol + menuItems[highlight].size() + 1, "<<");
                 attroff(A_BOLD);
+                clouds.invalidate();
                 
-                refresh();
+                presentFrame();
                 break;
             }
             case KEY_DOWN: {
@@ -264,8 +310,8 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
                 drawMenuItem(oldRow, oldCol, menuItems[highlight], false);
                 
                 // Clear decorative arrows
-                mvprintw(oldRow, oldCol - 3, "  ");
-                mvprintw(oldRow, oldCol + menuItems[highlight].size() + 1, "  ");
+                blankText(oldRow, oldCol - 3, 2);
+                blankText(oldRow, oldCol + menuItems[highlight].size() + 1, 2);
 
                 // Move highlight down
                 highlight++;
@@ -278,11 +324,12 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
                 
                 // Draw new decorative arrows
                 attron(A_BOLD);
-                mvprintw(newRow, newCol - 3, ">>");
-                mvprintw(newRow, newCol + menuItems[highlight].size() + 1, "<<");
+                putText(newRow, newCol - 3, ">>");
+                putText(newRow, newCol + menuItems[highlight].size() + 1, "<<");
                 attroff(A_BOLD);
+                clouds.invalidate();
                 
-                refresh();
+                presentFrame();
                 break;
             }
             case 10: // Enter key
@@ -294,7 +341,6 @@ int displayMainMenu(std::vector<std::string>& menuItems) {
         }
     }
     
-    timeout(-1); // Reset timeout to blocking mode
     return choice;
 }
 
@@ -312,12 +358,19 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
     // Box dimensions
     int boxWidth = 20;
     int boxHeight = 7;
-    
-    // Initialize moving clouds
-    std::vector<Cloud> clouds = initClouds(termHeight, termWidth, 10);
-    
-    // Initial screen setup
-    clear();
+    int boxY = (termHeight - boxHeight) / 2;
+    int boxX = (termWidth - boxWidth) / 2;
+
+    // Previews are loaded the first time their level is highlighted and kept
+    // for the next visit to this menu
+    static std::vector<ReplayPreview> previews;
+    previews.resize(levels.size());
+    SessionBudget previewBudget(PREVIEW_CPU_PERCENT);
+    std::chrono::steady_clock::time_point previewPlayed = std::chrono::steady_clock::now();
+    
+    // Initial screen setup, over new clouds
+    ParticleLayer clouds('.');
+    clearMenu(clouds);
     drawTextBox(0, 0, termHeight, termWidth);
     
     // Display fixed elements that don't change during navigation
@@ -327,85 +380,64 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
     
     // Draw a horizontal line below the title
     for (int i = 1; i < termWidth - 1; i++) {
-        mvaddch(6, i, '-');
+        putChar(6, i, '-');
     }
-    mvaddch(6, 0, '+');
-    mvaddch(6, termWidth - 1, '+');
+    putChar(6, 0, '+');
+    putChar(6, termWidth - 1, '+');
     
     // Display navigation instructions in a box at the bottom
     int instructY = termHeight - 5;
     for (int i = 1; i < termWidth - 1; i++) {
-        mvaddch(instructY, i, '-');
+        putChar(instructY, i, '-');
     }
-    mvaddch(instructY, 0, '+');
-    mvaddch(instructY, termWidth - 1, '+');
+    putChar(instructY, 0, '+');
+    putChar(instructY, termWidth - 1, '+');
     
-    mvprintw(instructY + 1, 2, "LEFT/RIGHT: Navigate between levels");
-    mvprintw(instructY + 2, 2, "ENTER: Select level");
-    mvprintw(instructY + 3, 2, "ESC: Return to main menu");
+    putText(instructY + 1, 2, "LEFT/RIGHT: Navigate between levels");
+    putText(instructY + 2, 2, "ENTER: Select level");
+    putText(instructY + 3, 2, "ESC: Return to main menu");
     
     // Draw a decorative footer
     std::string footerText = "Year 1 Engineering Experience";
-    mvprintw(termHeight - 1, (termWidth - footerText.length()) / 2, "%s", footerText.c_str());
+    putText(termHeight - 1, (termWidth - footerText.length()) / 2, footerText);
     
     // Variable to store previous level to avoid redrawing unnecessarily
     int previousLevel = -1;
     
-    // Set timeout for getch to enable animation (slightly slower)
-    timeout(150);
+    // Timed getch to enable animation, blocking again on return
+    InputMode ticking(MENU_TICK_MS);
     
     while (choice == -1) {
-        // Update and draw the moving clouds
-        updateAndDrawClouds(clouds, termHeight, termWidth);
-        
-        // Update animation counter
+        // Update animation counter; the arrows step every TICKS_PER_STEP ticks
         animCounter++;
+        int animStep = animCounter / TICKS_PER_STEP;
         
         // Only redraw what changed
-        if (currentLevel != previousLevel || animCounter % 5 == 0) {
+        ReplayPreview& preview = previews[currentLevel];
+        bool redrawn = currentLevel != previousLevel || animCounter % (5 * TICKS_PER_STEP) == 0;
+        if (redrawn) {
+            if (currentLevel != previousLevel) {
+                // A newly highlighted level's preview starts from the beginning
+                double cpuStart = threadCpuSeconds();
+                if (preview.load(levels[currentLevel].name + PREVIEW_FILE)) preview.rewind();
+                previewBudget.addCpuTime(threadCpuSeconds() - cpuStart);
+                previewPlayed = std::chrono::steady_clock::now();
+            }
+
             // Store current level as previous for next iteration
             previousLevel = currentLevel;
             
-            // Display current level - calculate positions
-            int boxY = (termHeight - boxHeight) / 2;
-            int boxX = (termWidth - boxWidth) / 2;
-            
-            // Clear the area where level boxes are displayed
-            for (int y = boxY - 1; y < boxY + boxHeight + 3; y++) {
-                for (int x = boxX - boxWidth - 10; x < boxX + boxWidth + 10; x++) {
-                    if (x > 0 && x < termWidth - 1 && y > 6 && y < instructY) {
-                        // Don't clear the clouds
-                        chtype ch = mvinch(y, x) & A_CHARTEXT;
-                        if (ch != '.') {
-                            mvaddch(y, x, ' ');
-                        }
-                    }
-                }
-            }
-            
-            // Clear navigation areas
-            // Left side for PREV
-            for (int y = boxY; y < boxY + boxHeight; y++) {
-                for (int x = 2; x < boxX - boxWidth - 10; x++) {
-                    if (y > 6 && y < instructY) {
-                        chtype ch = mvinch(y, x) & A_CHARTEXT;
-                        if (ch != '.') {
-                            mvaddch(y, x, ' ');
-                        }
-                    }
-                }
+            // Clear the area where level boxes are displayed, and the
+            // navigation areas either side of it (PREV left, NEXT right)
+            int areaLeft = boxX - boxWidth - 10;
+            int areaRight = boxX + boxWidth + 10;
+            for (int y = std::max(boxY - 1, 7); y < std::min(boxY + boxHeight + 3, instructY); y++) {
+                int from = std::max(areaLeft, 1);
+                blankText(y, from, std::min(areaRight, termWidth - 1) - from);
             }
-            
-            // Right side for NEXT
-            for (int y = boxY; y < boxY + boxHeight; y++) {
-                for (int x = boxX + boxWidth + 10; x < termWidth - 2; x++) {
-                    if (y > 6 && y < instructY) {
-                        chtype ch = mvinch(y, x) & A_CHARTEXT;
-                        if (ch != '.') {
-                            mvaddch(y, x, ' ');
-                        }
-                    }
-                }
+            for (int y = std::max(boxY, 7); y < std::min(boxY + boxHeight, instructY); y++) {
+                blankText(y, 2, areaLeft - 2);
+                blankText(y, areaRight, termWidth - 2 - areaRight);
             }
             
             // Draw navigation arrows with animation - positioned far away from level boxes
@@ -416,10 +448,10 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
                 int leftPosY = boxY + boxHeight / 2;
                 
                 // Animation shifts position slightly
-                if (animCounter % 6 < 3) {
-                    mvprintw(leftPosY, leftPosX, "%s", leftArrow.c_str());
+                if (animStep % 6 < 3) {
+                    putText(leftPosY, leftPosX, leftArrow);
                 } else {
-                    mvprintw(leftPosY, leftPosX + 1, "%s", leftArrow.c_str());
+                    putText(leftPosY, leftPosX + 1, leftArrow);
                 }
             }
             
@@ -430,10 +462,10 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
                 int rightPosY = boxY + boxHeight / 2;
                 
                 // Animation shifts position slightly
-                if (animCounter % 6 < 3) {
-                    mvprintw(rightPosY, rightPosX, "%s", rightArrow.c_str());
+                if (animStep % 6 < 3) {
+                    putText(rightPosY, rightPosX, rightArrow);
                 } else {
-                    mvprintw(rightPosY, rightPosX + 1, "%s", rightArrow.c_str());
+                    putText(rightPosY, rightPosX + 1, rightArrow);
                 }
             }
             
@@ -444,14 +476,14 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
             // Draw level indicator dots
             for (int i = 0; i < (int)levels.size(); i++) {
                 if (i == currentLevel) {
-                    mvaddch(indicatorY, indicatorX + i * 2, 'O');
+                    putChar(indicatorY, indicatorX + i * 2, 'O');
                 } else {
-                    mvaddch(indicatorY, indicatorX + i * 2, '.');
+                    putChar(indicatorY, indicatorX + i * 2, '.');
                 }
             }
             
             // Draw the active level box in the center
-            drawLevelBox(boxY, boxX, boxHeight, boxWidth, levels[currentLevel].name, true);
+            drawLevelBox(boxY, boxX, boxHeight, boxWidth, levels[currentLevel].name, true, preview.isLoaded());
             
             // Draw previous level (if any)
             if (currentLevel > 0) {
@@ -469,21 +501,45 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
             std::string progressText = "Level " + std::to_string(currentLevel + 1) + " of " + std::to_string(levels.size());
             
             // Clear the area where progress text is displayed
-            for (int x = (termWidth - progressText.length()) / 2 - 5; 
-                x < static_cast<int>((termWidth + progressText.length()) / 2 + 5); x++) {
-                if (x > 0 && x < termWidth - 1) {
-                    mvaddch(boxY - 2, x, ' ');
+            int progressFrom = std::max(static_cast<int>(termWidth - progressText.length()) / 2 - 5, 1);
+            int progressTo = std::min(static_cast<int>(termWidth + progressText.length()) / 2 + 5, termWidth - 1);
+            blankText(boxY - 2, progressFrom, progressTo - progressFrom);
+            
+            putText(boxY - 2, (termWidth - progressText.length()) / 2, progressText);
+
+            // The player's results on this level, between the box and the dots
+            int summaryY = boxY + boxHeight + 1;
+            std::string summary = progressSummary(levels[currentLevel].progress);
+            blankText(summaryY, 1, termWidth - 2);
+            if (!summary.empty()) {
+                summary.resize(std::min(static_cast<int>(summary.length()), termWidth - 2));
+                putText(summaryY, (termWidth - summary.length()) / 2, summary);
+            }
+            clouds.invalidate();
+        }
+        
+        // Update and draw the moving clouds behind whatever was drawn above
+        clouds.update();
+        clouds.draw(menuMask);
+
+        // Play the preview inside the box, which the mask already covers.
+        // After the box was redrawn it is drawn again even on a skipped step.
+        if (preview.isLoaded()) {
+            bool step = animCounter % PREVIEW_TICKS == 0 && previewBudget.shouldRender();
+            if (step || redrawn) {
+                double cpuStart = threadCpuSeconds();
+                if (redrawn) preview.invalidate();
+                if (step) {
+                    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                    double seconds = std::chrono::duration<double>(now - previewPlayed).count();
+                    preview.advance(std::min(seconds, PREVIEW_MAX_STEP));
+                    previewPlayed = now;
                 }
+                preview.draw(boxY + 1, boxX + 1, boxHeight - 2, boxWidth - 2);
+                previewBudget.addCpuTime(threadCpuSeconds() - cpuStart);
             }
-            
-            mvprintw(boxY - 2, (termWidth - progressText.length()) / 2, "%s", progressText.c_str());
-            
-            // Refresh to show changes
-            refresh();
-        } else {
-            // Just refresh for animation
-            refresh();
         }
+        presentFrame();
         
         // Get user input
         input = getch();
@@ -511,7 +567,6 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
                 break;
                 
             case 27: // ESC key
-                timeout(-1); // Reset timeout to blocking mode
                 return -1; // Return to main menu
                 
             default:
@@ -520,21 +575,20 @@ int displayLevelSelectionMenu(std::vector<Level>& levels) {
         }
     }
     
-    timeout(-1); // Reset timeout to blocking mode
     return choice;
 }
 
 // Main game loop
 int main() {
     // Initialize ncurses ONCE here
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
+    initScreen();
     
     // Initialize random number generator
-    srand(time(NULL));
+    seedRandom();
+
+    // Stages report how they went through shared memory; without it only
+    // their exit codes are known
+    resultChannel.open();
 
     // Main menu items - simplified to just Play and Exit
     std::vector<std::string> mainMenuItems = {
@@ -567,9 +621,10 @@ int main() {
                         // User pressed ESC, go back to main menu
                         break;
                     } else if (levelChoice >= 0 && levelChoice < (int)levels.size()) {
-                        // Run the selected level
-                        levels[levelChoice].run_function();
-                        // No need to track results or save progress
+                        // Run the selected level and keep what it reported
+                        StageResult result;
+                        levels[levelChoice].run_function(result);
+                        addResult(levels[levelChoice].progress, result);
                     }
                 }
                 break;
@@ -593,28 +648,26 @@ int main() {
 
 // Game launcher functions with better error handling
 
-// Run the ENGG1300 game from the ENGG1300 directory
-int run_engg1300_game() {
+// Run a stage from its own directory, then take the terminal back
+static int runStage(const char* directory, StageResult& report) {
     // Clear the screen and reset terminal settings
     endwin();
     
     // Call the actual game - using cd to switch to the correct directory first
-    // Using lowercase makefile as seen in your directory structure
-    int result = system("cd ENGG1300 && make -f makefile run");
+    std::string command = std::string("cd ") + directory + " && make -f makefile run";
+    resultChannel.clear();
+    int result = system(command.c_str());
+    report = resultChannel.read();
     
-    // Re-initialize ncurses for our menu
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
+    // Take the terminal back; the curses session is the same one
+    resumeScreen();
     
     // For debugging
     if (result != 0) {
         clear();
-        printw("Error running ENGG1300 game. Result code: %d\n", result);
+        printw("Error running %s game. Result code: %d\n", directory, result);
         printw("Press any key to continue...");
-        refresh();
+        presentFrame();
         getch();
     }
     
@@ -622,118 +675,22 @@ int run_engg1300_game() {
     return (result == 0) ? 1 : 0;
 }
 
-// Run the ENGG1310 game from the ENGG1310 directory
-int run_engg1310_game() {
-    // Clear the screen and reset terminal settings
-    endwin();
-    
-    // Call the actual game - using cd to switch to the correct directory first
-    // Using lowercase makefile as seen in your directory structure
-    int result = system("cd ENGG1310 && make -f makefile run");
-    
-    // Re-initialize ncurses for our menu
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    
-    // For debugging
-    if (result != 0) {
-        clear();
-        printw("Error running ENGG1310 game. Result code: %d\n", result);
-        printw("Press any key to continue...");
-        refresh();
-        getch();
-    }
-    
-    // Return 1 for success (level completed), 0 for failure
-    return (result == 0) ? 1 : 0;
+int run_engg1300_game(StageResult& result) {
+    return runStage("ENGG1300", result);
 }
 
-// Run the ENGG1320 game from the ENGG1320 directory
-int run_engg1320_game() {
-    // Clear the screen and reset terminal settings
-    endwin();
-    
-    // Call the actual game - using cd to switch to the correct directory first
-    // Using lowercase makefile as seen in your directory structure
-    int result = system("cd ENGG1320 && make -f makefile run");
-    
-    // Re-initialize ncurses for our menu
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    
-    // For debugging
-    if (result != 0) {
-        clear();
-        printw("Error running ENGG1320 game. Result code: %d\n", result);
-        printw("Press any key to continue...");
-        refresh();
-        getch();
-    }
-    
-    // Return 1 for success (level completed), 0 for failure
-    return (result == 0) ? 1 : 0;
+int run_engg1310_game(StageResult& result) {
+    return runStage("ENGG1310", result);
 }
 
-// Run the ENGG1330 game from the ENGG1330 directory
-int run_engg1330_game() {
-    // Clear the screen and reset terminal settings
-    endwin();
-    
-    // Call the actual game - using cd to switch to the correct directory first
-    // Using lowercase makefile as seen in your directory structure
-    int result = system("cd ENGG1330 && make -f makefile run");
-    
-    // Re-initialize ncurses for our menu
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    
-    // For debugging
-    if (result != 0) {
-        clear();
-        printw("Error running ENGG1330 game. Result code: %d\n", result);
-        printw("Press any key to continue...");
-        refresh();
-        getch();
-    }
-    
-    // Return 1 for success (level completed), 0 for failure
-    return (result == 0) ? 1 : 0;
+int run_engg1320_game(StageResult& result) {
+    return runStage("ENGG1320", result);
 }
 
-// Run the ENGG1340 game from the ENGG1340 directory
-int run_engg1340_game() {
-    // Clear the screen and reset terminal settings
-    endwin();
-    
-    // Call the actual game - using cd to switch to the correct directory first
-    // Using lowercase makefile as seen in your directory structure
-    int result = system("cd ENGG1340 && make -f makefile run");
-    
-    // Re-initialize ncurses for our menu
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    
-    // For debugging
-    if (result != 0) {
-        clear();
-        printw("Error running ENGG1340 game. Result code: %d\n", result);
-        printw("Press any key to continue...");
-        refresh();
-        getch();
-    }
-    
-    // Return 1 for success (level completed), 0 for failure
-    return (result == 0) ? 1 : 0;
-}
\ No newline at end of file
+int run_engg1330_game(StageResult& result) {
+    return runStage("ENGG1330", result);
+}
+
+int run_engg1340_game(StageResult& result) {
+    return runStage("ENGG1340", result);
+}